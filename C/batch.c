@@ -0,0 +1,1191 @@
+/* This is the batch (non-interactive) mode for the calculator.  It reads
+ * newline-delimited equations, evaluates each one, and writes one result per
+ * line.  It's used when stdin isn't a terminal, or when the user asks for it
+ * on the command line.
+ *
+ * Both directions are buffered.  We read the input in large blocks and split
+ * it into lines in place, and we collect the results in a buffer that is only
+ * written when it fills up.  So the number of system calls is proportional to
+ * the size of the data, not the number of equations.
+ *
+ * batch_parallel() does the same thing on a pool of worker threads.  The input
+ * is processed in large windows.  Each window is split into chunks of lines,
+ * and the chunks are divided evenly among the workers.  A worker takes chunks
+ * from the front of its own range, and when it runs out it steals chunks from
+ * the back of the other workers' ranges.  So a worker that gets stuck with a
+ * run of slow equations (i.e. fractional exponents) is helped by the others.
+ * Each chunk has its own output buffer, and the buffers are written in input
+ * order when the window is done.
+ *
+ * The worker threads live for the whole run.  There are 2 windows.  While the
+ * workers evaluate one of them, this thread reads and splits the next one, and
+ * then writes the results of the previous one.  So the I/O overlaps the math.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common.h"
+
+#include "batch.h"
+#include "calculator.h"
+
+/* The size of each read() from the input, and the size of the output buffer. */
+#define BATCH_READ_SIZE  (64 * 1024)
+#define BATCH_WRITE_SIZE (64 * 1024)
+
+/* This is what we write for an equation that can't be evaluated. */
+#define BATCH_ERROR_STR "Error"
+
+/* batch_parallel() processes this much input at a time, and divides it into
+ * chunks of this many lines.  A chunk is the unit of work that the workers
+ * take and steal.  The tests use small windows, so that they cross a lot of
+ * window boundaries. */
+#if defined(TEST)
+#define BATCH_WINDOW_SIZE (16 * 1024)
+#else
+#define BATCH_WINDOW_SIZE (4 * 1024 * 1024)
+#endif
+#define BATCH_CHUNK_LINES 64
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ *****************************************************************************/
+
+/* The state of a batch run. */
+typedef struct batch_state {
+  int         in_fd;
+  int         out_fd;
+
+  /* The input buffer.  in_buf[0 - (in_len - 1)] contains data that has been
+   * read but not processed yet.  It always starts at the beginning of a line.
+   * The buffer grows if it contains a line that's too long to fit. */
+  char       *in_buf;
+  size_t      in_size;
+  size_t      in_len;
+
+  /* The output buffer. */
+  char        out_buf[BATCH_WRITE_SIZE];
+  size_t      out_len;
+
+  calculator *calc;
+} batch_state;
+
+/* A chunk of lines for batch_parallel(), and the results for those lines. */
+typedef struct batch_chunk {
+  char      **lines;
+  size_t      num_lines;
+
+  char       *out;
+  size_t      out_size;
+  size_t      out_len;
+  bool        ok;
+} batch_chunk;
+
+/* A window of input for batch_parallel().  The lines point into in_buf.  The
+ * first in_used bytes of in_buf are the lines of this window, and the rest is
+ * a partial line that belongs to the next window. */
+typedef struct batch_window {
+  char         *in_buf;
+  size_t        in_size;
+  size_t        in_len;
+  size_t        in_used;
+
+  char        **lines;
+  size_t        lines_max;
+
+  batch_chunk  *chunks;
+  size_t        num_chunks;
+  size_t        chunks_max;
+
+  /* The number of chunks that have been evaluated.  It's protected by the
+   * pool's lock. */
+  size_t        chunks_done;
+} batch_window;
+
+struct batch_pool;
+
+/* A worker thread for batch_parallel().  The worker owns the chunks
+ * [head, tail) of a window.  The owner takes them from the head, and other
+ * workers steal them from the tail.  lock protects window, head and tail. */
+typedef struct batch_worker {
+  struct batch_pool *pool;
+  calculator        *calc;
+  pthread_t          thread;
+  pthread_mutex_t    lock;
+  batch_window      *window;
+  size_t             head;
+  size_t             tail;
+} batch_worker;
+
+/* The state of a batch_parallel() run. */
+typedef struct batch_pool {
+  int             in_fd;
+  int             out_fd;
+
+  /* One window is evaluated while the other one is read and written. */
+  batch_window    windows[2];
+
+  /* Worker 0 is this thread.  The others are threads that wait on work_cond
+   * for the generation to change (a new window), or for quit.  done_cond is
+   * signaled when the last chunk of a window is done.  lock protects
+   * generation, quit, and the windows' chunks_done. */
+  batch_worker   *workers;
+  int             num_workers;
+  int             num_started;
+  pthread_mutex_t lock;
+  pthread_cond_t  work_cond;
+  pthread_cond_t  done_cond;
+  uint64_t        generation;
+  bool            quit;
+} batch_pool;
+
+/******************************************************************************
+ ******************************** PRIVATE API *********************************
+ *****************************************************************************/
+
+/* Write a buffer to a file descriptor.  Partial writes are retried.
+ *
+ * Input:
+ *   fd  = The file descriptor.
+ *
+ *   buf = The data.
+ *
+ *   len = The length of the data.
+ *
+ * Output:
+ *   true  = success.  All of the data was written.
+ *   false = failure.  Unable to write to the file.
+ */
+static bool
+batch_write_all(int         fd,
+                const char *buf,
+                size_t      len)
+{
+  bool retcode = true;
+
+  size_t done = 0;
+  while((retcode == true) && (done < len))
+  {
+    ssize_t n = write(fd, &buf[done], (len - done));
+    if(n > 0)
+    {
+      done += n;
+    }
+    else if((n < 0) && (errno == EINTR))
+    {
+      continue;
+    }
+    else
+    {
+      retcode = false;
+    }
+  }
+
+  return retcode;
+}
+
+/* Write the contents of the output buffer to the output file.
+ *
+ * Input:
+ *   this = A pointer to the batch_state object.
+ *
+ * Output:
+ *   true  = success.  The output buffer is empty.
+ *   false = failure.  Unable to write to the output file.
+ */
+static bool
+batch_flush(batch_state *this)
+{
+  bool retcode = batch_write_all(this->out_fd, this->out_buf, this->out_len);
+
+  this->out_len = 0;
+
+  return retcode;
+}
+
+/* Add a line of text to the output buffer.  The newline is added here.
+ *
+ * Input:
+ *   this = A pointer to the batch_state object.
+ *
+ *   str  = The text.
+ *
+ *   len  = The length of str.
+ *
+ * Output:
+ *   true  = success.  The line is in the output buffer (or was written).
+ *   false = failure.  Unable to write to the output file.
+ */
+static bool
+batch_write_line(batch_state *this,
+                 const char  *str,
+                 size_t       len)
+{
+  bool retcode = true;
+
+  if((this->out_len + len + 1) > sizeof(this->out_buf))
+  {
+    retcode = batch_flush(this);
+  }
+
+  if(retcode == true)
+  {
+    /* The results are short, so a line that's too big for the whole buffer
+     * can't happen.  Truncate it just in case. */
+    if(len > (sizeof(this->out_buf) - 1))
+    {
+      len = (sizeof(this->out_buf) - 1);
+    }
+    memcpy(&this->out_buf[this->out_len], str, len);
+    this->out_len += len;
+    this->out_buf[this->out_len++] = '\n';
+  }
+
+  return retcode;
+}
+
+/* Evaluate a single line of input, and write the result.
+ *
+ * Input:
+ *   this = A pointer to the batch_state object.
+ *
+ *   line = The equation.  It's NULL terminated (the newline has been removed).
+ *
+ * Output:
+ *   true  = success.  The result (or an error message) has been written.
+ *   false = failure.  Unable to write to the output file.
+ */
+static bool
+batch_eval_line(batch_state *this,
+                char        *line)
+{
+  char result[1024];
+
+  if(calculator_eval_str(this->calc, line, result, sizeof(result)) == false)
+  {
+    strcpy(result, BATCH_ERROR_STR);
+  }
+
+  return batch_write_line(this, result, strlen(result));
+}
+
+/* Evaluate all of the complete lines that are in the input buffer.  A partial
+ * line at the end of the buffer is moved to the front, so that the next read()
+ * can finish it.
+ *
+ * Input:
+ *   this = A pointer to the batch_state object.
+ *
+ * Output:
+ *   true  = success.
+ *   false = failure.  Unable to write to the output file.
+ */
+static bool
+batch_eval_lines(batch_state *this)
+{
+  bool retcode = true;
+
+  char *start = this->in_buf;
+  char *end   = this->in_buf + this->in_len;
+  char *nl;
+  while((retcode == true) && ((nl = memchr(start, '\n', (end - start))) != (char *) 0))
+  {
+    /* Accept DOS line endings too. */
+    *nl = 0;
+    if((nl > start) && (nl[-1] == '\r'))
+    {
+      nl[-1] = 0;
+    }
+
+    retcode = batch_eval_line(this, start);
+    start = nl + 1;
+  }
+
+  this->in_len = (end - start);
+  memmove(this->in_buf, start, this->in_len);
+
+  return retcode;
+}
+
+/* Read the next block of input.  The input buffer is doubled whenever it's
+ * full (i.e. it contains a single line that's longer than the buffer).  The
+ * buffer always has room for a NULL terminator after *size bytes.
+ *
+ * Input:
+ *   fd   = The file descriptor to read from.
+ *
+ *   buf  = A pointer to the input buffer.  It's updated if the buffer grows.
+ *
+ *   size = A pointer to the size of the input buffer.
+ *
+ *   len  = A pointer to the number of bytes in the input buffer.
+ *
+ *   eof  = A pointer to a variable that is set to true if we've reached the
+ *          end of the input.
+ *
+ * Output:
+ *   true  = success.  The new data has been appended to *buf.
+ *   false = failure.  Unable to read, or unable to allocate memory.
+ */
+static bool
+batch_read(int     fd,
+           char  **buf,
+           size_t *size,
+           size_t *len,
+           bool   *eof)
+{
+  bool retcode = false;
+
+  *eof = false;
+
+  do
+  {
+    if(*len == *size)
+    {
+      char *p = realloc(*buf, (*size * 2) + 1);
+      if(p == (char *) 0)                                                { break; }
+      *buf   = p;
+      *size *= 2;
+    }
+
+    ssize_t n;
+    while(((n = read(fd, &(*buf)[*len], (*size - *len))) < 0) && (errno == EINTR));
+    if(n < 0)                                                            { break; }
+
+    *len += n;
+    *eof  = (n == 0) ? true : false;
+    retcode = true;
+  } while(0);
+
+  return retcode;
+}
+
+/* Evaluate one chunk of lines, and save the results in the chunk's output
+ * buffer.
+ *
+ * Input:
+ *   calc  = A pointer to the calculator object to use.  Each worker has its
+ *           own.
+ *
+ *   chunk = A pointer to the chunk.
+ *
+ * Output:
+ *   N/A.  chunk->ok is set to false if we were unable to allocate memory.
+ */
+static void
+batch_eval_chunk(calculator  *calc,
+                 batch_chunk *chunk)
+{
+  chunk->out_len = 0;
+  chunk->ok      = true;
+
+  size_t i;
+  for(i = 0; (chunk->ok == true) && (i < chunk->num_lines); i++)
+  {
+    char result[1024];
+    if(calculator_eval_str(calc, chunk->lines[i], result, sizeof(result)) == false)
+    {
+      strcpy(result, BATCH_ERROR_STR);
+    }
+
+    size_t len = strlen(result);
+    if((chunk->out_len + len + 1) > chunk->out_size)
+    {
+      size_t new_size = (chunk->out_size == 0) ? (BATCH_CHUNK_LINES * 32) : chunk->out_size;
+      while(new_size < (chunk->out_len + len + 1))
+      {
+        new_size *= 2;
+      }
+      char *p = realloc(chunk->out, new_size);
+      if(p == (char *) 0)
+      {
+        chunk->ok = false;
+        break;
+      }
+      chunk->out      = p;
+      chunk->out_size = new_size;
+    }
+
+    memcpy(&chunk->out[chunk->out_len], result, len);
+    chunk->out_len += len;
+    chunk->out[chunk->out_len++] = '\n';
+  }
+}
+
+/* Get the next chunk for a worker.  Take it from the front of the worker's own
+ * range.  If that's empty, steal one from the back of another worker's range.
+ *
+ * Input:
+ *   this   = A pointer to the batch_worker object.
+ *
+ *   window = A pointer to a variable that receives the window that the chunk
+ *            belongs to.
+ *
+ *   index  = A pointer to a variable that receives the chunk index.
+ *
+ * Output:
+ *   true  = success.  *index is the chunk to evaluate.
+ *   false = failure.  There is no work left.
+ */
+static bool
+batch_worker_next(batch_worker  *this,
+                  batch_window **window,
+                  size_t        *index)
+{
+  bool retcode = false;
+
+  pthread_mutex_lock(&this->lock);
+  if(this->head < this->tail)
+  {
+    *window = this->window;
+    *index  = this->head++;
+    retcode = true;
+  }
+  pthread_mutex_unlock(&this->lock);
+
+  batch_pool *pool = this->pool;
+  int i;
+  for(i = 1; (retcode == false) && (i < pool->num_workers); i++)
+  {
+    batch_worker *victim = &pool->workers[((this - pool->workers) + i) % pool->num_workers];
+
+    pthread_mutex_lock(&victim->lock);
+    if(victim->head < victim->tail)
+    {
+      *window = victim->window;
+      *index  = --victim->tail;
+      retcode = true;
+    }
+    pthread_mutex_unlock(&victim->lock);
+  }
+
+  return retcode;
+}
+
+/* Evaluate chunks until there are none left.  The last chunk of a window wakes
+ * up batch_pool_wait().
+ *
+ * Input:
+ *   this = A pointer to the batch_worker object.
+ *
+ * Output:
+ *   N/A.
+ */
+static void
+batch_worker_work(batch_worker *this)
+{
+  batch_pool *pool = this->pool;
+
+  batch_window *window;
+  size_t        index;
+  while(batch_worker_next(this, &window, &index) == true)
+  {
+    batch_eval_chunk(this->calc, &window->chunks[index]);
+
+    pthread_mutex_lock(&pool->lock);
+    if(++window->chunks_done == window->num_chunks)
+    {
+      pthread_cond_broadcast(&pool->done_cond);
+    }
+    pthread_mutex_unlock(&pool->lock);
+  }
+}
+
+/* This is the body of a worker thread.  Each time a new window is published,
+ * it evaluates chunks until there are none left.  Then it waits for the next
+ * window.
+ *
+ * Input:
+ *   arg = A pointer to the batch_worker object.
+ *
+ * Output:
+ *   Returns 0.
+ */
+static void *
+batch_worker_run(void *arg)
+{
+  batch_worker *this = (batch_worker *) arg;
+  batch_pool   *pool = this->pool;
+
+  uint64_t seen = 0;
+
+  pthread_mutex_lock(&pool->lock);
+  while(true)
+  {
+    while((pool->quit == false) && (pool->generation == seen))
+    {
+      pthread_cond_wait(&pool->work_cond, &pool->lock);
+    }
+    if(pool->quit == true)
+    {
+      break;
+    }
+    seen = pool->generation;
+    pthread_mutex_unlock(&pool->lock);
+
+    batch_worker_work(this);
+
+    pthread_mutex_lock(&pool->lock);
+  }
+  pthread_mutex_unlock(&pool->lock);
+
+  return (void *) 0;
+}
+
+/* Split the first len bytes of a window's input buffer into lines, and divide
+ * the lines into chunks.  The lines are NULL terminated in place.
+ *
+ * Input:
+ *   this = A pointer to the batch_window object.
+ *
+ *   len  = The number of bytes at the front of the input buffer that make up
+ *          complete lines.  The last line may be missing its newline.
+ *
+ * Output:
+ *   true  = success.  this->chunks describes the window.
+ *   false = failure.  Unable to allocate memory.
+ */
+static bool
+batch_window_split(batch_window *this,
+                   size_t        len)
+{
+  bool retcode = true;
+
+  char  *start = this->in_buf;
+  char  *end   = start + len;
+  size_t num_lines = 0;
+
+  while(start < end)
+  {
+    char *nl = memchr(start, '\n', (end - start));
+    if(nl == (char *) 0)
+    {
+      nl = end;
+    }
+
+    /* Accept DOS line endings too. */
+    *nl = 0;
+    if((nl > start) && (nl[-1] == '\r'))
+    {
+      nl[-1] = 0;
+    }
+
+    if(num_lines == this->lines_max)
+    {
+      size_t new_max = (this->lines_max == 0) ? 4096 : (this->lines_max * 2);
+      char **p = realloc(this->lines, new_max * sizeof(*p));
+      if(p == (char **) 0)
+      {
+        retcode = false;
+        break;
+      }
+      this->lines     = p;
+      this->lines_max = new_max;
+    }
+    this->lines[num_lines++] = start;
+
+    start = nl + 1;
+  }
+
+  /* Now divide the lines into chunks. */
+  size_t num_chunks = (num_lines + (BATCH_CHUNK_LINES - 1)) / BATCH_CHUNK_LINES;
+  if((retcode == true) && (num_chunks > this->chunks_max))
+  {
+    batch_chunk *p = realloc(this->chunks, num_chunks * sizeof(*p));
+    if(p != (batch_chunk *) 0)
+    {
+      memset(&p[this->chunks_max], 0, (num_chunks - this->chunks_max) * sizeof(*p));
+      this->chunks     = p;
+      this->chunks_max = num_chunks;
+    }
+    else
+    {
+      retcode = false;
+    }
+  }
+
+  if(retcode == true)
+  {
+    size_t i;
+    for(i = 0; i < num_chunks; i++)
+    {
+      batch_chunk *chunk = &this->chunks[i];
+      chunk->lines     = &this->lines[i * BATCH_CHUNK_LINES];
+      chunk->num_lines = ((num_lines - (i * BATCH_CHUNK_LINES)) < BATCH_CHUNK_LINES) ?
+                         (num_lines - (i * BATCH_CHUNK_LINES)) : BATCH_CHUNK_LINES;
+    }
+    this->num_chunks = num_chunks;
+    this->in_used    = len;
+  }
+
+  return retcode;
+}
+
+/* Fill a window with the next block of input, and split it into chunks.  It
+ * starts with the partial line at the end of the previous window.
+ *
+ * Input:
+ *   this = A pointer to the batch_pool object.
+ *
+ *   win  = A pointer to the window to fill.  Its chunks must be done.
+ *
+ *   prev = A pointer to the previous window, or 0 if this is the first one.
+ *          It might still be evaluated, but its partial line isn't part of
+ *          any chunk, so it's safe to copy.
+ *
+ *   eof  = A pointer to a variable that is set to true if we've reached the
+ *          end of the input.  The window gets the rest of the input.
+ *
+ * Output:
+ *   true  = success.  win is ready to be published.
+ *   false = failure.  Unable to read, or unable to allocate memory.
+ */
+static bool
+batch_window_fill(batch_pool   *this,
+                  batch_window *win,
+                  batch_window *prev,
+                  bool         *eof)
+{
+  bool retcode = true;
+
+  size_t carry = (prev != (batch_window *) 0) ? (prev->in_len - prev->in_used) : 0;
+  if(carry > win->in_size)
+  {
+    char *p = realloc(win->in_buf, carry + 1);
+    if(p == (char *) 0)
+    {
+      return false;
+    }
+    win->in_buf  = p;
+    win->in_size = carry;
+  }
+  if(carry > 0)
+  {
+    memcpy(win->in_buf, &prev->in_buf[prev->in_used], carry);
+  }
+  win->in_len     = carry;
+  win->in_used    = 0;
+  win->num_chunks = 0;
+
+  /* Read at least once, so a partial line that's bigger than a window still
+   * makes progress. */
+  do
+  {
+    retcode = batch_read(this->in_fd, &win->in_buf, &win->in_size, &win->in_len, eof);
+  } while((retcode == true) && (*eof == false) && (win->in_len < BATCH_WINDOW_SIZE));
+
+  /* The window ends at the last newline.  At EOF, the last line doesn't need
+   * one. */
+  if(retcode == true)
+  {
+    size_t len = win->in_len;
+    if(*eof == false)
+    {
+      while((len > 0) && (win->in_buf[len - 1] != '\n'))
+      {
+        len--;
+      }
+    }
+    retcode = batch_window_split(win, len);
+  }
+
+  return retcode;
+}
+
+/* Hand a window to the workers.  Its chunks are divided evenly among them, and
+ * the worker threads are woken up.
+ *
+ * Input:
+ *   this = A pointer to the batch_pool object.
+ *
+ *   win  = A pointer to the window.
+ *
+ * Output:
+ *   N/A.
+ */
+static void
+batch_pool_publish(batch_pool   *this,
+                   batch_window *win)
+{
+  /* A worker that is still looking for work in the previous window can steal
+   * from the new ranges as soon as they're set, so the count goes first. */
+  pthread_mutex_lock(&this->lock);
+  win->chunks_done = 0;
+  pthread_mutex_unlock(&this->lock);
+
+  int i;
+  for(i = 0; i < this->num_workers; i++)
+  {
+    batch_worker *w = &this->workers[i];
+    pthread_mutex_lock(&w->lock);
+    w->window = win;
+    w->head   = (win->num_chunks * i) / this->num_workers;
+    w->tail   = (win->num_chunks * (i + 1)) / this->num_workers;
+    pthread_mutex_unlock(&w->lock);
+  }
+
+  pthread_mutex_lock(&this->lock);
+  this->generation++;
+  pthread_cond_broadcast(&this->work_cond);
+  pthread_mutex_unlock(&this->lock);
+}
+
+/* Help the workers with a window, and then wait until all of its chunks are
+ * done.
+ *
+ * Input:
+ *   this = A pointer to the batch_pool object.
+ *
+ *   win  = A pointer to the window.
+ *
+ * Output:
+ *   N/A.
+ */
+static void
+batch_pool_wait(batch_pool   *this,
+                batch_window *win)
+{
+  batch_worker_work(&this->workers[0]);
+
+  pthread_mutex_lock(&this->lock);
+  while(win->chunks_done < win->num_chunks)
+  {
+    pthread_cond_wait(&this->done_cond, &this->lock);
+  }
+  pthread_mutex_unlock(&this->lock);
+}
+
+/* Write the results of a window in input order.
+ *
+ * Input:
+ *   this = A pointer to the batch_pool object.
+ *
+ *   win  = A pointer to the window.  All of its chunks must be done.
+ *
+ * Output:
+ *   true  = success.  The results for the window have been written.
+ *   false = failure.  Unable to allocate memory, or unable to write.
+ */
+static bool
+batch_pool_write(batch_pool   *this,
+                 batch_window *win)
+{
+  bool retcode = true;
+
+  size_t c;
+  for(c = 0; (retcode == true) && (c < win->num_chunks); c++)
+  {
+    batch_chunk *chunk = &win->chunks[c];
+    if((retcode = chunk->ok) == true)
+    {
+      retcode = batch_write_all(this->out_fd, chunk->out, chunk->out_len);
+    }
+  }
+
+  return retcode;
+}
+
+/******************************************************************************
+ ********************************* PUBLIC API *********************************
+ *****************************************************************************/
+
+/* Run the calculator in batch mode.  Read equations (one per line) from in_fd
+ * until EOF, and write the results (one per line) to out_fd.  An equation that
+ * can't be evaluated produces the line "Error", so line N of the output always
+ * belongs to line N of the input.
+ *
+ * Input:
+ *   in_fd  = The file descriptor to read the equations from.
+ *
+ *   out_fd = The file descriptor to write the results to.
+ *
+ * Output:
+ *   true  = success.  All of the equations have been processed.
+ *   false = failure.  There was a problem reading or writing, or we were
+ *                     unable to allocate memory.
+ */
+bool
+batch(int in_fd,
+      int out_fd)
+{
+  bool retcode = false;
+
+  batch_state *this = malloc(sizeof(*this));
+
+  do
+  {
+    if(this == (batch_state *) 0)                                        { break; }
+    memset(this, 0, sizeof(*this));
+    this->in_fd  = in_fd;
+    this->out_fd = out_fd;
+
+    if((this->calc = calculator_new()) == (calculator *) 0)              { break; }
+
+    this->in_size = BATCH_READ_SIZE;
+    if((this->in_buf = malloc(this->in_size + 1)) == (char *) 0)         { break; }
+
+    /* Read until EOF, and evaluate the lines as they arrive. */
+    bool eof = false;
+    while(eof == false)
+    {
+      if(batch_read(this->in_fd, &this->in_buf, &this->in_size, &this->in_len, &eof) == false) { break; }
+
+      if(eof == false)
+      {
+        if(batch_eval_lines(this) == false)                              { break; }
+      }
+
+      /* EOF.  The last line doesn't need a newline. */
+      else
+      {
+        retcode = true;
+        if(this->in_len > 0)
+        {
+          this->in_buf[this->in_len] = 0;
+          retcode = batch_eval_line(this, this->in_buf);
+        }
+      }
+    }
+
+    if(batch_flush(this) == false)
+    {
+      retcode = false;
+    }
+  } while(0);
+
+  if(this != (batch_state *) 0)
+  {
+    calculator_delete(this->calc);
+    free(this->in_buf);
+    free(this);
+  }
+
+  return retcode;
+}
+
+/* Run the calculator in batch mode on a pool of worker threads.  This is the
+ * same as batch(), except that the equations are evaluated in parallel.  The
+ * results are still written in input order.
+ *
+ * Input:
+ *   in_fd       = The file descriptor to read the equations from.
+ *
+ *   out_fd      = The file descriptor to write the results to.
+ *
+ *   num_threads = The number of worker threads (including this one).  0 means
+ *                 one per online CPU.
+ *
+ * Output:
+ *   true  = success.  All of the equations have been processed.
+ *   false = failure.  There was a problem reading or writing, or we were
+ *                     unable to allocate memory.
+ */
+bool
+batch_parallel(int in_fd,
+               int out_fd,
+               int num_threads)
+{
+  bool retcode = false;
+
+  if(num_threads <= 0)
+  {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    num_threads = (cpus > 0) ? (int) cpus : 1;
+  }
+
+  batch_pool *this = malloc(sizeof(*this));
+  int i, num_workers = 0;
+
+  do
+  {
+    if(this == (batch_pool *) 0)                                         { break; }
+    memset(this, 0, sizeof(*this));
+    this->in_fd  = in_fd;
+    this->out_fd = out_fd;
+    pthread_mutex_init(&this->lock, (pthread_mutexattr_t *) 0);
+    pthread_cond_init(&this->work_cond, (pthread_condattr_t *) 0);
+    pthread_cond_init(&this->done_cond, (pthread_condattr_t *) 0);
+
+    for(i = 0; i < 2; i++)
+    {
+      this->windows[i].in_size = BATCH_WINDOW_SIZE;
+      if((this->windows[i].in_buf = malloc(BATCH_WINDOW_SIZE + 1)) == (char *) 0) { break; }
+    }
+    if(i != 2)                                                           { break; }
+
+    /* Create the workers.  Each one has its own calculator. */
+    this->workers = calloc(num_threads, sizeof(*this->workers));
+    if(this->workers == (batch_worker *) 0)                              { break; }
+    for(num_workers = 0; num_workers < num_threads; num_workers++)
+    {
+      batch_worker *w = &this->workers[num_workers];
+      w->pool = this;
+      if((w->calc = calculator_new()) == (calculator *) 0)               { break; }
+      pthread_mutex_init(&w->lock, (pthread_mutexattr_t *) 0);
+    }
+    this->num_workers = num_workers;
+    if(num_workers != num_threads)                                       { break; }
+
+    /* Worker 0 runs on this thread.  If we can't start one of the others, the
+     * remaining workers will steal its chunks. */
+    for(this->num_started = 1; this->num_started < num_workers; this->num_started++)
+    {
+      batch_worker *w = &this->workers[this->num_started];
+      if(pthread_create(&w->thread, (pthread_attr_t *) 0, batch_worker_run, w) != 0)
+      {
+        break;
+      }
+    }
+
+    /* The workers evaluate cur while we fill next.  Then we swap them, and
+     * write the results of the old cur while the workers evaluate the new
+     * one. */
+    batch_window *cur  = &this->windows[0];
+    batch_window *next = &this->windows[1];
+    bool eof = false;
+    bool ok  = batch_window_fill(this, cur, (batch_window *) 0, &eof);
+    if(ok == true)
+    {
+      batch_pool_publish(this, cur);
+    }
+    while(ok == true)
+    {
+      bool more = (eof == false) ? true : false;
+      if(more == true)
+      {
+        ok = batch_window_fill(this, next, cur, &eof);
+      }
+
+      batch_pool_wait(this, cur);
+      if((more == true) && (ok == true))
+      {
+        batch_pool_publish(this, next);
+      }
+      if(ok == true)
+      {
+        ok = batch_pool_write(this, cur);
+      }
+
+      if(more == false)
+      {
+        retcode = ok;
+        break;
+      }
+
+      batch_window *tmp = cur;
+      cur  = next;
+      next = tmp;
+    }
+  } while(0);
+
+  if(this != (batch_pool *) 0)
+  {
+    /* The workers finish the window they're on, and then they quit. */
+    pthread_mutex_lock(&this->lock);
+    this->quit = true;
+    pthread_cond_broadcast(&this->work_cond);
+    pthread_mutex_unlock(&this->lock);
+    for(i = 1; i < this->num_started; i++)
+    {
+      pthread_join(this->workers[i].thread, (void **) 0);
+    }
+
+    for(i = 0; i < num_workers; i++)
+    {
+      calculator_delete(this->workers[i].calc);
+      pthread_mutex_destroy(&this->workers[i].lock);
+    }
+    for(i = 0; i < 2; i++)
+    {
+      batch_window *win = &this->windows[i];
+      size_t c;
+      for(c = 0; c < win->chunks_max; c++)
+      {
+        free(win->chunks[c].out);
+      }
+      free(win->chunks);
+      free(win->lines);
+      free(win->in_buf);
+    }
+    free(this->workers);
+    pthread_cond_destroy(&this->done_cond);
+    pthread_cond_destroy(&this->work_cond);
+    pthread_mutex_destroy(&this->lock);
+    free(this);
+  }
+
+  return retcode;
+}
+
+/******************************************************************************
+ ********************************** TEST API **********************************
+ *****************************************************************************/
+
+#if defined(TEST)
+
+/* Run a batch through temporary files, and compare the output.
+ *
+ * Input:
+ *   in          = The input data.
+ *
+ *   in_len      = The length of the input data.
+ *
+ *   expected    = The expected output.
+ *
+ *   num_threads = The number of threads for batch_parallel().  0 means run
+ *                 batch() instead.
+ *
+ * Output:
+ *   true  = success.  The output matches.
+ *   false = failure.
+ */
+static bool
+batch_test_run(const char *in,
+               size_t      in_len,
+               const char *expected,
+               int         num_threads)
+{
+  bool retcode = false;
+
+  FILE *in_file  = tmpfile();
+  FILE *out_file = tmpfile();
+  char *out      = malloc(strlen(expected) + 2);
+
+  do
+  {
+    if((in_file == (FILE *) 0) || (out_file == (FILE *) 0) || (out == (char *) 0)) { break; }
+
+    if(fwrite(in, 1, in_len, in_file) != in_len)                                  { break; }
+    if(fflush(in_file) != 0)                                                       { break; }
+    rewind(in_file);
+
+    bool ok = (num_threads == 0) ? batch(fileno(in_file), fileno(out_file)) :
+                                   batch_parallel(fileno(in_file), fileno(out_file), num_threads);
+    if(ok != true)                                                                 { break; }
+
+    rewind(out_file);
+    size_t out_len = fread(out, 1, (strlen(expected) + 1), out_file);
+    out[out_len] = 0;
+    if(strcmp(out, expected) != 0)
+    {
+      printf("%d threads: '%s' != '%s'.\n", num_threads, out, expected);
+      break;
+    }
+
+    retcode = true;
+  } while(0);
+
+  if(in_file != (FILE *) 0)
+  {
+    fclose(in_file);
+  }
+  if(out_file != (FILE *) 0)
+  {
+    fclose(out_file);
+  }
+  free(out);
+
+  return retcode;
+}
+
+/* Run a batch sequentially, and then on 1 and 4 worker threads.  The output
+ * must be the same every time.
+ *
+ * Input:
+ *   in       = The input data.
+ *
+ *   in_len   = The length of the input data.
+ *
+ *   expected = The expected output.
+ *
+ * Output:
+ *   true  = success.  The output matches.
+ *   false = failure.
+ */
+static bool
+batch_test_one(const char *in,
+               size_t      in_len,
+               const char *expected)
+{
+  return ((batch_test_run(in, in_len, expected, 0) == true) &&
+          (batch_test_run(in, in_len, expected, 1) == true) &&
+          (batch_test_run(in, in_len, expected, 4) == true)) ? true : false;
+}
+
+bool
+batch_test(void)
+{
+  printf("  Simple equations.\n");
+  const char *in = "1+2*3\n"
+                   "10/0\n"
+                   "\n"
+                   "(1+2)*3\r\n"
+                   "2^3s";
+  if(batch_test_one(in, strlen(in), "7\nError\n0\n9\n0.125\n") != true)            return false;
+
+  printf("  Empty input.\n");
+  if(batch_test_one("", 0, "") != true)                                            return false;
+
+  /* Enough lines to fill the input and output buffers several times, and a
+   * line that's longer than the input buffer. */
+  printf("  Large input.\n");
+  size_t lines = 50000;
+  size_t long_line = (BATCH_READ_SIZE * 3);
+  size_t big_in_size = (lines * 6) + long_line + 16;
+  char *big_in  = malloc(big_in_size);
+  char *big_out = malloc((lines * 4) + 16);
+  if((big_in == (char *) 0) || (big_out == (char *) 0))                            return false;
+  char *p = big_in, *q = big_out;
+  size_t x;
+  for(x = 0; x < lines; x++)
+  {
+    p += sprintf(p, "%d+%d\n", (int) (x % 100), 1);
+    q += sprintf(q, "%d\n", (int) ((x % 100) + 1));
+  }
+  memset(p, ' ', long_line);
+  p += long_line;
+  p += sprintf(p, "1+1\n");
+  q += sprintf(q, "2\n");
+  bool retcode = batch_test_one(big_in, (p - big_in), big_out);
+  free(big_in);
+  free(big_out);
+
+  /* A mix of fast and slow equations, so the workers have to steal from each
+   * other.  The first half of the input is all fractional exponents. */
+  if(retcode == true)
+  {
+    printf("  Uneven work.\n");
+    lines = 2000;
+    big_in  = malloc(lines * 16);
+    big_out = malloc(lines * 8);
+    if((big_in == (char *) 0) || (big_out == (char *) 0))                          return false;
+    p = big_in;
+    q = big_out;
+    for(x = 0; x < lines; x++)
+    {
+      if(x < (lines / 2))
+      {
+        p += sprintf(p, "%d^0.5\n", (int) ((x % 10) * (x % 10)));
+        q += sprintf(q, "%d\n", (int) (x % 10));
+      }
+      else
+      {
+        p += sprintf(p, "%d*2\n", (int) (x % 500));
+        q += sprintf(q, "%d\n", (int) ((x % 500) * 2));
+      }
+    }
+    retcode = batch_test_one(big_in, (p - big_in), big_out);
+    free(big_in);
+    free(big_out);
+  }
+
+  return retcode;
+}
+
+#endif // TEST
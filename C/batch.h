@@ -0,0 +1,25 @@
+/* This is the header file for the entrypoint to the calculator batch mode.
+ */
+
+#ifndef __BATCH_H__
+#define __BATCH_H__
+
+/****************************** CLASS DEFINITION ******************************/
+
+/********************************* PUBLIC OPS *********************************/
+
+/********************************* PUBLIC API *********************************/
+
+bool batch(int in_fd, int out_fd);
+
+bool batch_parallel(int in_fd, int out_fd, int num_threads);
+
+/********************************** TEST API **********************************/
+
+#if defined(TEST)
+
+bool batch_test(void);
+
+#endif // TEST
+
+#endif // __BATCH_H__
@@ -0,0 +1,282 @@
+/* This is a benchmark program that measures the speed of the classes that
+ * comprise the calculator.
+ */
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "common.h"
+
+#include "bench.h"
+#include "calculator.h"
+#include "display.h"
+#include "operand_base_10.h"
+#include "operator.h"
+#include "raw_stdin.h"
+#include "server.h"
+
+/******************************** PRIVATE API *********************************/
+
+/* The number of heap allocations the program has made, and the number of
+ * heap bytes it's holding right now.  The bench program is linked with
+ * --wrap=malloc (etc.), so every allocation that the calculator code makes
+ * comes through here first.  The bytes are the usable size of each block, so
+ * they include the allocator's rounding.  Other threads (i.e. the server
+ * bench's client) allocate too, so the counters are updated atomically. */
+static uint64_t bench_allocs = 0;
+static uint64_t bench_bytes  = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void  __real_free(void *ptr);
+
+void *
+__wrap_malloc(size_t size)
+{
+  void *ptr = __real_malloc(size);
+  __atomic_fetch_add(&bench_allocs, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&bench_bytes, malloc_usable_size(ptr), __ATOMIC_RELAXED);
+  return ptr;
+}
+
+void *
+__wrap_calloc(size_t nmemb,
+              size_t size)
+{
+  void *ptr = __real_calloc(nmemb, size);
+  __atomic_fetch_add(&bench_allocs, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&bench_bytes, malloc_usable_size(ptr), __ATOMIC_RELAXED);
+  return ptr;
+}
+
+void *
+__wrap_realloc(void   *ptr,
+               size_t  size)
+{
+  size_t old_size = malloc_usable_size(ptr);
+  void  *new_ptr  = __real_realloc(ptr, size);
+  __atomic_fetch_add(&bench_allocs, 1, __ATOMIC_RELAXED);
+  if(new_ptr != (void *) 0)
+  {
+    __atomic_fetch_add(&bench_bytes, malloc_usable_size(new_ptr) - old_size, __ATOMIC_RELAXED);
+  }
+  return new_ptr;
+}
+
+void
+__wrap_free(void *ptr)
+{
+  __atomic_fetch_sub(&bench_bytes, malloc_usable_size(ptr), __ATOMIC_RELAXED);
+  __real_free(ptr);
+}
+
+typedef bool (*bench_func)(void);
+
+/* Run a benchmark, print the result, and return a pass/fail status.  All
+ * benchmarks print their own measurements and return a boolean that indicates
+ * whether they were able to run (true) or not (false).
+ *
+ * Input:
+ *   name  = An ASCII string that contains the name of the benchmark.
+ *
+ *   bench = A pointer to the benchmark function.
+ *
+ * Output:
+ *   true  = success.  The benchmark ran.
+ *   false = failure.  The benchmark was unable to run.
+ */
+static bool
+bench_run_one_bench(const char *name,
+                    bench_func  bench)
+{
+  printf("%s:\n", name);
+  bool retcode = bench();
+  printf("%s: %s.\n", name, (retcode == true) ? "DONE" : "FAIL");
+  return retcode;
+}
+
+/********************************* PUBLIC API *********************************/
+
+/* Start a benchmark timer.
+ *
+ * Input:
+ *   this = A pointer to the bench_timer object.
+ *
+ * Output:
+ *   N/A.
+ */
+void
+bench_timer_start(bench_timer *this)
+{
+  clock_gettime(CLOCK_MONOTONIC, &this->start);
+}
+
+/* Return the number of seconds that have elapsed since bench_timer_start().
+ *
+ * Input:
+ *   this = A pointer to the bench_timer object.
+ *
+ * Output:
+ *   Returns the elapsed time in seconds.
+ */
+double
+bench_timer_elapsed(bench_timer *this)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return ((double) (now.tv_sec  - this->start.tv_sec)) +
+         ((double) (now.tv_nsec - this->start.tv_nsec) / 1000000000.0);
+}
+
+/* Print the rate at which a benchmark loop ran.  The rate is calculated from
+ * the time that has elapsed since bench_timer_start().
+ *
+ * Input:
+ *   name  = An ASCII string that describes the thing that was measured.
+ *
+ *   timer = A pointer to the bench_timer object that timed the loop.
+ *
+ *   count = The number of operations that the loop performed.
+ *
+ *   units = An ASCII string that describes one operation (i.e. "adds").
+ *
+ * Output:
+ *   N/A.
+ */
+void
+bench_report(const char  *name,
+             bench_timer *timer,
+             uint64_t     count,
+             const char  *units)
+{
+  double elapsed = bench_timer_elapsed(timer);
+  double rate = (elapsed > 0.0) ? ((double) count / elapsed) : 0.0;
+
+  printf("  %-40s %14.0f %s/sec (%.3f sec).\n", name, rate, units, elapsed);
+}
+
+/* Return the number of heap allocations that have been made since the program
+ * started.  Take the difference of 2 readings to count the allocations made
+ * by a benchmark loop.
+ *
+ * Input:
+ *   N/A.
+ *
+ * Output:
+ *   Returns the number of allocations.
+ */
+uint64_t
+bench_alloc_count(void)
+{
+  return __atomic_load_n(&bench_allocs, __ATOMIC_RELAXED);
+}
+
+/* Return the number of heap bytes that the program is holding right now.
+ * Take the difference of 2 readings to find out how much memory a data
+ * structure is holding on to.
+ *
+ * Input:
+ *   N/A.
+ *
+ * Output:
+ *   Returns the number of bytes.
+ */
+uint64_t
+bench_alloc_bytes(void)
+{
+  return __atomic_load_n(&bench_bytes, __ATOMIC_RELAXED);
+}
+
+/* Print the number of heap allocations that a benchmark loop made per
+ * operation.
+ *
+ * Input:
+ *   name   = An ASCII string that describes the thing that was measured.
+ *
+ *   allocs = The number of allocations that the loop made.
+ *
+ *   count  = The number of operations that the loop performed.
+ *
+ *   units  = An ASCII string that describes one operation (i.e. "cmp").
+ *
+ * Output:
+ *   N/A.
+ */
+void
+bench_report_allocs(const char *name,
+                    uint64_t    allocs,
+                    uint64_t    count,
+                    const char *units)
+{
+  double rate = (count > 0) ? ((double) allocs / (double) count) : 0.0;
+
+  printf("  %-40s %14.2f allocs/%s.\n", name, rate, units);
+}
+
+/* Print the number of heap bytes that a data structure holds per element.
+ *
+ * Input:
+ *   name  = An ASCII string that describes the thing that was measured.
+ *
+ *   bytes = The number of heap bytes that the data structure holds.
+ *
+ *   count = The number of elements in the data structure.
+ *
+ *   units = An ASCII string that describes one element (i.e. "token").
+ *
+ * Output:
+ *   N/A.
+ */
+void
+bench_report_bytes(const char *name,
+                   uint64_t    bytes,
+                   uint64_t    count,
+                   const char *units)
+{
+  double rate = (count > 0) ? ((double) bytes / (double) count) : 0.0;
+
+  printf("  %-40s %14.1f bytes/%s.\n", name, rate, units);
+}
+
+bool bench(void)
+{
+  bool retcode = true;
+
+  printf("Run benchmarks.\n");
+
+  /* Loop through each of the benchmarks.  Stop immediately if any of them is
+   * unable to run. */
+  typedef struct unit_bench {
+    const char *name;
+    bench_func  func;
+  } unit_bench;
+  unit_bench benches[] = {
+    { "Operand Base 10",   operand_base_10_bench },
+    { "Operator",          operator_bench        },
+    { "Calculator",        calculator_bench      },
+    { "Display",           display_bench         },
+    { "Raw Console",       raw_stdin_bench       },
+    { "Server",            server_bench          },
+  };
+  size_t benches_size = (sizeof(benches) / sizeof(unit_bench));
+
+  int x;
+  for(x = 0; (x < benches_size) && (retcode == true); x++)
+  {
+    unit_bench *b = &benches[x];
+    retcode = bench_run_one_bench(b->name, b->func);
+  }
+
+  if(retcode == true)
+  {
+    return 0;
+  }
+  else
+  {
+    return 1;
+  }
+}
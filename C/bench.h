@@ -0,0 +1,44 @@
+/* This is the header file for the entrypoint to the calculator benchmark
+ * program.
+ */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stdint.h>
+#include <time.h>
+
+/****************************** CLASS DEFINITION ******************************/
+
+/* A simple stopwatch that the per-module benchmarks use to time a loop. */
+typedef struct bench_timer {
+  struct timespec start;
+} bench_timer;
+
+/********************************* PUBLIC OPS *********************************/
+
+/********************************* PUBLIC API *********************************/
+
+#if defined(BENCH)
+
+void bench_timer_start(bench_timer *this);
+
+double bench_timer_elapsed(bench_timer *this);
+
+void bench_report(const char *name, bench_timer *timer, uint64_t count, const char *units);
+
+uint64_t bench_alloc_count(void);
+
+void bench_report_allocs(const char *name, uint64_t allocs, uint64_t count, const char *units);
+
+uint64_t bench_alloc_bytes(void);
+
+void bench_report_bytes(const char *name, uint64_t bytes, uint64_t count, const char *units);
+
+bool bench(void);
+
+#endif // BENCH
+
+/********************************** TEST API **********************************/
+
+#endif // __BENCH_H__
@@ -11,35 +11,129 @@
 #include <termios.h>
 #include <unistd.h>
 
+/* Only the multi-threaded test uses threads. */
+#if defined(TEST)
+#include <pthread.h>
+#endif // TEST
+
 #include "common.h"
 
+#include "bench.h"
 #include "calculator.h"
-#include "list.h"
 #include "operand.h"
 #include "operator.h"
-#include "stack.h"
 
-/* These are the types of objects that we store in the infix/postfix lists. */
+/* These are the types of objects that we store in the infix/postfix equations. */
 #define LIST_OBJ_TYPE_OPERAND  1
 #define LIST_OBJ_TYPE_OPERATOR 2
 #define LIST_OBJ_TYPE_ERROR    3
 #define LIST_OBJ_TYPE_NONE     4
 
+/* calculator_compile() adds one more type of token.  A placeholder is a named
+ * or numbered parameter ("$price" or "$1") whose value is supplied each time
+ * the program is run.  The object is the index of the name in the program's
+ * slot_names table (cast to a pointer). */
+#define LIST_OBJ_TYPE_PLACEHOLDER 5
+
+/* These are the opcodes in a compiled program.  Each instruction has an
+ * opcode and an index.  The index selects a constant, a parameter slot, or
+ * an operator (by its character), depending on the opcode. */
+#define PROGRAM_OP_PUSH_CONST 1
+#define PROGRAM_OP_PUSH_SLOT  2
+#define PROGRAM_OP_UNARY      3
+#define PROGRAM_OP_BINARY     4
+
+/* The maximum number of parameter slots in a program.  This also limits the
+ * positional placeholders to "$1" - "$256". */
+#define PROGRAM_MAX_SLOTS 256
+
+/* The most room that the text of one token takes on the console.  It's big
+ * enough for the longest operand that operand_to_str() creates. */
+#define CONSOLE_TOKEN_MAX 128
+
 /******************************************************************************
  ****************************** CLASS DEFINITION ******************************
  *****************************************************************************/
 
+/* A token in an equation that is evaluated by calculator_eval_str().  The type
+ * is one of the LIST_OBJ_TYPE_* values, and object points to the operand or
+ * operator. */
+typedef struct calculator_token {
+  int   type;
+  void *object;
+} calculator_token;
+
+/* An instruction in a compiled program. */
+typedef struct calculator_program_op {
+  uint32_t opcode;
+  uint32_t index;
+} calculator_program_op;
+
+/* This is a compiled program.  It's created by calculator_compile(), and it
+ * isn't modified after that, so it can be run by many calculators (even on
+ * separate threads) at the same time. */
+struct calculator_program {
+  /* The number base that the program was compiled for. */
+  operand_type            base;
+
+  /* The postfix instructions. */
+  calculator_program_op  *code;
+  size_t                  code_len;
+
+  /* The constant pool.  PROGRAM_OP_PUSH_CONST copies one of these onto the
+   * evaluation stack. */
+  operand               **constants;
+  size_t                  num_constants;
+
+  /* The names of the parameter slots (without the '$').  A positional slot
+   * that isn't used in the equation has no name. */
+  char                  **slot_names;
+  size_t                  num_slots;
+
+  /* The deepest the evaluation stack gets. */
+  size_t                  max_depth;
+};
+
+/* A growable array of tokens.  The memory is reused from one equation to the
+ * next, so once it's big enough, adding a token is just a store. */
+typedef struct calculator_tokens {
+  calculator_token *tokens;
+  size_t            len;
+  size_t            max;
+} calculator_tokens;
+
 /* This is the calculator class. */
 struct calculator {
   /* As we accept operands and operators from the outside world, we store them
-   * on this list. */
-  list *infix_list;
-
-  /* We convert infix-to-postfix on this list. */
-  list *postfix_list;
-
-  /* A buffer that's used to build the console output. */
-  char console_buf[1024];
+   * here.  The calculator owns the operand and operator objects. */
+  calculator_tokens infix;
+
+  /* The operator stack and the operand stack that are used to evaluate the
+   * equation.  They reference the objects that are in the infix equation. */
+  calculator_tokens operators;
+  calculator_tokens operands;
+
+  /* Processing mode.  The equation is evaluated as it's typed in.  run_len is
+   * the number of infix tokens that have been folded into run_operators and
+   * run_operands so far.  The run_operands stack holds copies of the operands
+   * (the infix operands are displayed, so we can't do the math in them).  It
+   * owns the operand objects in its first run_num_objects slots. */
+  bool              processing_mode;
+  bool              run_error;
+  size_t            run_len;
+  calculator_tokens run_operators;
+  calculator_tokens run_operands;
+  size_t            run_num_objects;
+
+  /* The text of the infix equation, as it's shown on the console.  The text of
+   * each token is cached.  Token i starts at console_offsets[i], and ends at
+   * console_offsets[i + 1].  The first console_valid tokens are up to date, so
+   * only the tokens after them need to be rendered again. */
+  char   *console;
+  size_t  console_max;
+  size_t *console_offsets;
+  size_t  console_offsets_max;
+  size_t  console_valid;
 
   /* The operand number base we're configured to use.  This refers to things
    * like base_10 or base_16. */
@@ -49,6 +143,24 @@ struct calculator {
    * unmatched left parentheses.  The point is to make sure we know how many
    * open parentheses are currently waiting for a closing parentheses. */
   uint16_t paren_count;
+
+  /* The infix equation for calculator_eval_str() and calculator_compile().
+   * They use the operators and operands arrays above as their operator stack
+   * and operand stack (or postfix equation).  It's reused from one equation to
+   * the next, so a typical equation doesn't touch the heap at all. */
+  calculator_tokens eval;
+
+  /* The operand pool.  When an equation is done with an operand object (it was
+   * consumed by '=', deleted by a backspace, or calculator_eval_str() or
+   * calculator_program_eval() is finished), the object goes here instead of
+   * back to the heap, and calculator_operand_get() hands it out again.  Once
+   * the pool is warm, equations don't touch the heap. */
+  operand          **operand_pool;
+  size_t             operand_pool_len;
+  size_t             operand_pool_max;
+
+  /* How well the operand pool is working. */
+  calculator_pool_stats pool_stats;
 };
   
 /******************************************************************************
@@ -101,348 +213,334 @@ calculator_add_paren(calculator *this,
   return retcode;
 }
 
-/* This function evaluates the postfix equation.
+/* Get an operand object for an equation.  It comes from the operand pool if
+ * there's one there, otherwise it's created.  Either way it's zero,
+ * it's set to the calculator's current base, and it accepts
+ * operand_add_char().
  *
  * Input:
- *   this = A pointer to the calculator object.  The postfix equation is
- *          already stored in postfix_list.  You can get it onto that list by
- *          calling the calculator_infix2postfix() member.
+ *   this = A pointer to the calculator object.
  *
  * Output:
- *   true  = success.  The result is stored at the tail of the infix list.
- *   false = failure.  No result.  infix and postfix lists are empty.
+ *   Returns a pointer to the operand object.
+ *   Returns 0 if unable to create the object.
  */
-static bool
-calculator_postfix(calculator *this)
+static operand *
+calculator_operand_get(calculator *this)
 {
-  bool retcode = true;
+  operand *o = (operand *) 0;
 
-  /* A stack to use while processing the postfix. */
-  stack *tmp_stack;
-  if((tmp_stack = stack_new()) == (stack *) 0)
+  if(this->operand_pool_len > 0)
+  {
+    o = this->operand_pool[--this->operand_pool_len];
+    if(operand_reset(o, this->base) == true)
+    {
+      this->pool_stats.operand_hits++;
+    }
+    else
+    {
+      operand_delete(o);
+      o = (operand *) 0;
+    }
+  }
+  else if((o = operand_new(this->base)) != (operand *) 0)
   {
-    return false;
+    this->pool_stats.operand_misses++;
   }
 
-  /* These are used while processing the infix equation. */
-  void *cur_obj;
-  int type;
-  while(retcode == true)
+  return o;
+}
+
+/* Give an operand object back to the operand pool.  If the pool can't grow,
+ * the object is deleted instead.
+ *
+ * Input:
+ *   this = A pointer to the calculator object.
+ *
+ *   o    = A pointer to the operand object.
+ *
+ * Output:
+ *   N/A.
+ */
+static void
+calculator_operand_put(calculator *this,
+                       operand    *o)
+{
+  if(this->operand_pool_len == this->operand_pool_max)
   {
-    /* When the postfix_list is empty, we're done. */
-    if((retcode = list_rem_head(this->postfix_list, &cur_obj, &type)) == false)
+    size_t new_max = (this->operand_pool_max == 0) ? 64 : (this->operand_pool_max * 2);
+    operand **p = realloc(this->operand_pool, new_max * sizeof(*p));
+    if(p == (operand **) 0)
     {
-      retcode = true;
-      break;
+      operand_delete(o);
+      return;
     }
+    this->operand_pool     = p;
+    this->operand_pool_max = new_max;
+  }
 
-    /* Operands immediately go onto the stack. */
-    if(type == LIST_OBJ_TYPE_OPERAND)
-    {
-      retcode = stack_push(tmp_stack, cur_obj);
-    }
+  this->operand_pool[this->operand_pool_len++] = o;
+}
 
-    /* Operators are processed immediately. */
-    else if(type == LIST_OBJ_TYPE_OPERATOR)
-    {
-      operator *cur_operator = (operator *) cur_obj;
-      operator_type op_type;
-      if((retcode = operator_get_op_type(cur_operator, &op_type)) == true)
-      {
-        if(op_type == op_type_unary)
-        {
-          void *op;
-          if(((retcode = stack_pop(tmp_stack, &op)) == true) &&
-             ((retcode = operator_do_unary(cur_operator, op)) == true))
-          {
-            retcode = stack_push(tmp_stack, op);
-          }
-        }
+/* Release the operand or operator object in a token of the infix equation.
+ * Operands go back to the operand pool.  Operators are shared, so there's
+ * nothing to do for them.
+ *
+ * Input:
+ *   this = A pointer to the calculator object.
+ *
+ *   t    = A pointer to the token.
+ *
+ * Output:
+ *   N/A.
+ */
+static void
+calculator_token_release(calculator       *this,
+                         calculator_token *t)
+{
+  if(t->type == LIST_OBJ_TYPE_OPERAND)
+  {
+    calculator_operand_put(this, (operand *) t->object);
+  }
 
-        else if(op_type == op_type_binary)
-        {
-          void *op1, *op2;
-          if(((retcode = stack_pop(tmp_stack, &op2)) == true) &&
-             ((retcode = stack_pop(tmp_stack, &op1)) == true) &&
-             ((retcode = operator_do_binary(cur_operator, op1, op2)) == true))
-          {
-            retcode = stack_push(tmp_stack, op1);
-          }
-        }
+  t->object = (void *) 0;
+}
 
-        else
-        {
-          retcode = false;
-          break;
-        }
-      }
-    }
+/* Make sure a token array can hold at least the specified number of tokens.
+ *
+ * Input:
+ *   this  = A pointer to the calculator_tokens object.
+ *
+ *   count = The number of tokens that the array needs to hold.
+ *
+ * Output:
+ *   true  = success.  The array can hold count tokens.
+ *   false = failure.  The array is unchanged.
+ */
+static bool
+calculator_tokens_reserve(calculator_tokens *this,
+                          size_t             count)
+{
+  bool retcode = true;
 
-    /* Unknown operand type.  Shouldn't happen. */
-    else
+  if(count > this->max)
+  {
+    size_t new_max = (this->max == 0) ? 64 : this->max;
+    while(new_max < count)
     {
-      retcode = false;
+      new_max *= 2;
     }
-  }
 
-  /* We must meet all of the following criteria in order for the equation to be
-   * deemed successful:
-   * 1. retcode == true.
-   * 2. The postfix_list is empty.
-   * 3. The stack:
-   *    A. Is empty (Result is zero).
-   *    B. Contains exactly one OPERAND (the result).
-   */
-  if(retcode == true)
-  {
-    if(list_get_tail(this->postfix_list, &cur_obj, &type) == false)
+    calculator_token *p = realloc(this->tokens, new_max * sizeof(*p));
+    if(p != (calculator_token *) 0)
     {
-      void *result;
-      if(stack_pop(tmp_stack, &result) == true)
-      {
-        if(stack_pop(tmp_stack, &result) == false)
-        {
-          /* If we were totally successful, this is where we set retcode. */
-          retcode = list_add_tail(this->infix_list, result, LIST_OBJ_TYPE_OPERAND);
-        }
-        else
-        {
-          /* There are too many values on the stack.  That's an error. */
-          retcode = false;
-        }
-      }
+      this->tokens = p;
+      this->max    = new_max;
     }
     else
     {
-      /* The postfix_list isn't empty.  That's an error. */
       retcode = false;
     }
   }
 
-  /* If we failed, purge the infix and postfix lists, and insert a token onto
-   * the infix list that indicates an error. */
-  if(retcode == false)
+  return retcode;
+}
+
+/* Add a token to the end of a token array.
+ *
+ * Input:
+ *   this   = A pointer to the calculator_tokens object.
+ *
+ *   type   = The type of the token (LIST_OBJ_TYPE_*).
+ *
+ *   object = The operand or operator object.
+ *
+ * Output:
+ *   true  = success.  The token was added.
+ *   false = failure.  The token was NOT added.
+ */
+static bool
+calculator_tokens_add_tail(calculator_tokens *this,
+                           int                type,
+                           void              *object)
+{
+  bool retcode = calculator_tokens_reserve(this, (this->len + 1));
+
+  if(retcode == true)
   {
-    list_del_all(this->postfix_list);
-    list_del_all(this->infix_list);
-    list_add_tail(this->infix_list, 0, LIST_OBJ_TYPE_ERROR);
+    this->tokens[this->len].type     = type;
+    this->tokens[this->len++].object = object;
   }
 
-  stack_delete(tmp_stack);
-
   return retcode;
 }
 
-/* This function is the workhorse of the class.  It converts an infix equation
- * to postfix.
+/* The infix equation has changed, starting at the specified token.  Forget
+ * the console text for that token and the ones after it.
  *
  * Input:
- *   this = A pointer to the calculator object.  The infix equation is already
- *          stored in infix_list.
+ *   this  = A pointer to the calculator object.
+ *
+ *   index = The index of the first token that changed.
+ *
+ * Output:
+ *   N/A.
+ */
+static void
+calculator_console_invalidate(calculator *this,
+                              size_t      index)
+{
+  if(index < this->console_valid)
+  {
+    this->console_valid = index;
+  }
+}
+
+/* Delete the last token of the infix equation, and forget its console text.
+ *
+ * Input:
+ *   this = A pointer to the calculator object.
  *
  * Output:
- *   true  = success.  You can feed the postfix list into the postfix evaluator.
- *   false = failure.  infix and postfix lists are empty.
+ *   true  = success.  The last token is gone.
+ *   false = failure.  The infix equation is empty.
  */
 static bool
-calculator_infix2postfix(calculator *this)
+calculator_infix_del_tail(calculator *this)
 {
-  bool retcode = true;
-  stack *tmp_stack;
+  bool retcode = false;
 
-  /* If we need to add closing parentheses (in order to balance out the open and
-   * close parentheses), do it now. */
-  if(this->paren_count > 0)
+  if(this->infix.len > 0)
   {
-    char dbg_buf[1024];
-    calculator_get_console(this, dbg_buf, sizeof(dbg_buf));
-    DBG_PRINT("%s(): paren_count BEFORE: %d '%s'.\n", __func__, this->paren_count, dbg_buf);
-    while(this->paren_count > 0)
-    {
-      operator *paren_operator;
-      if((paren_operator = operator_new(')')) == (operator *) 0)
-      {
-        break;
-      }
+    calculator_console_invalidate(this, (this->infix.len - 1));
+    calculator_token_release(this, &this->infix.tokens[--this->infix.len]);
+    retcode = true;
+  }
 
-      if((retcode = list_add_tail(this->infix_list, paren_operator, LIST_OBJ_TYPE_OPERATOR)) == false)
-      {
-        operator_delete(paren_operator);
-        break;
-      }
+  return retcode;
+}
 
-      this->paren_count--;
-    }
-    if((this->paren_count > 0) || (retcode == false))
+/* Render the console text for one token of the infix equation, and append it
+ * to the console text.
+ *
+ * Input:
+ *   this = A pointer to the calculator object.
+ *
+ *   t    = A pointer to the token.  The type tells us what type of object it
+ *          contains.
+ *
+ *   len  = A pointer to the length of the console text.  The text of the token
+ *          is added at this offset, and it's updated to include the token.
+ *
+ * Output:
+ *   true  = success.  The operand or operator is added to this->console.
+ *   false = failure.
+ */
+static bool
+calculator_console_render_token(calculator             *this,
+                                const calculator_token *t,
+                                size_t                 *len)
+{
+  bool retcode = false;
+
+  /* Make sure there's room for a space, the token, and the NULL terminator. */
+  size_t need = *len + 1 + CONSOLE_TOKEN_MAX + 1;
+  if(need > this->console_max)
+  {
+    size_t new_max = (this->console_max == 0) ? 1024 : this->console_max;
+    while(new_max < need)
     {
-      return false;
+      new_max *= 2;
     }
-    calculator_get_console(this, dbg_buf, sizeof(dbg_buf));
-    DBG_PRINT("%s(): paren_count AFTER:  %d '%s'.\n", __func__, this->paren_count, dbg_buf);
-  }
 
-  /* Start with an empty stack and a brand new postfix_list. */
-  if(this->postfix_list != (list *) 0)
-  {
-    if((retcode = list_delete(this->postfix_list)) == false)
+    char *p = realloc(this->console, new_max);
+    if(p == (char *) 0)
     {
-      return retcode;
+      return false;
     }
-    this->postfix_list = (list *) 0;
+    this->console     = p;
+    this->console_max = new_max;
   }
 
-  if(((retcode = ((tmp_stack = stack_new()) != (stack *) 0)) == false) ||
-     ((retcode = ((this->postfix_list = list_new()) != (list *) 0)) == false) )
+  char *dst = &this->console[*len];
+  if(*len > 0)
   {
-    stack_delete(tmp_stack);
-    list_delete(this->postfix_list);
-    return retcode;
+    *(dst++) = ' ';
   }
 
-  /* Used while processing the infix equation. */
-  void *cur_obj;
-  int type;
-  void *stk_operator;
-
-  while((retcode == true) && (list_rem_head(this->infix_list, &cur_obj, &type) == true))
+  switch(t->type)
   {
-    /* Operands go straight to the postfix equation. */
-    if(type == LIST_OBJ_TYPE_OPERAND)
-    {
-      retcode = list_add_tail(this->postfix_list, cur_obj, LIST_OBJ_TYPE_OPERAND);
-      continue;
-    }
+  case LIST_OBJ_TYPE_OPERAND:
+    retcode = operand_to_str((operand *) t->object, dst, CONSOLE_TOKEN_MAX);
+    break;
 
-    /* Operators are a little trickier. */
-    else if(type == LIST_OBJ_TYPE_OPERATOR)
+  case LIST_OBJ_TYPE_OPERATOR:
     {
-      operator *cur_operator = (operator *) cur_obj;
-
-      /* Keep popping operators until we encounter one that is a lower
-       * precedence or we hit the bottom of the stack. */
-      while((retcode == true) && (stack_peek(tmp_stack, &stk_operator) == true))
-      {
-        int cur_input, cur_stack;
-        int stk_input, stk_stack;
-        if( ((retcode = operator_precedence(cur_operator, &cur_input, &cur_stack)) == true) &&
-            ((retcode = operator_precedence(stk_operator, &stk_input, &stk_stack)) == true) )
-        {
-          if(stk_stack > cur_input)
-          {
-            break;
-          }
-
-          if((retcode = stack_pop(tmp_stack, &stk_operator)) == false)
-          {
-            break;
-          }
-
-          /* If the operator needs to be processed later, add it to the postfix
-           * expression.  This basically means we throw away the parentheses and
-           * we save the unary and binary operators. */
-          operator_type op_type;
-          if((operator_get_op_type(stk_operator, &op_type) == true) && (op_type != op_type_none))
-          {
-            retcode = list_add_tail(this->postfix_list, stk_operator, LIST_OBJ_TYPE_OPERATOR);
-          }
-        }
-      }
-
-      /* Push the new operator after we're done popping. */
-      if(retcode == true)
+      const char *op_name;
+      if((retcode = operator_get_name((const operator *) t->object, &op_name)) == true)
       {
-        retcode = stack_push(tmp_stack, cur_operator);
+        snprintf(dst, CONSOLE_TOKEN_MAX, "%s", op_name);
       }
     }
+    break;
 
-    /* Unknown object type. */
-    else
-    {
-      retcode = false;
-    }
-  }
-
-  /* When we're done, pop the rest of the stack and add it to the postfix. */
-  while((retcode == true) && (stack_pop(tmp_stack, &stk_operator) == true))
-  {
-    operator_type op_type;
-    if((operator_get_op_type(stk_operator, &op_type) == true) && (op_type != op_type_none))
-    {
-      retcode = list_add_tail(this->postfix_list, stk_operator, LIST_OBJ_TYPE_OPERATOR);
-    }
+  case LIST_OBJ_TYPE_ERROR:
+  default:
+    retcode = false;
+    break;
   }
 
-  /* The stack and the infix_list should be empty. */
-  if((list_rem_head(this->infix_list, &cur_obj, &type) == true) ||
-     (stack_peek(tmp_stack, &stk_operator) == true))
+  if(retcode == true)
   {
-    retcode = false;
+    *len = (dst - this->console) + strlen(dst);
   }
 
-  /* Get rid fo the stack and flush the infix_list. */
-  stack_delete(tmp_stack);
-  list_del_all(this->infix_list);
-
   return retcode;
 }
 
-/* This is a callback function for a list traversal.  When we want to create an
- * ASCII string that contains the entire infix or postfix equation, we call
- * list::list_traverse(), and it passes each operand/operator object to this
- * member.  This member then builds a string that contains the ASCII equation.
+/* Apply an operator to the operands at the top of the operand stack.  The
+ * result replaces the operands.
  *
  * Input:
- *   this_void = A pointer to the calculator object.
+ *   op           = A pointer to the operator object.
  *
- *   object    = An opaque value that represents an object.
+ *   operands     = The operand stack.
  *
- *   type      = This defines what type of object is contained in object.  We
- *               use the type to help us identify object.
+ *   num_operands = A pointer to the number of operands on the stack.  It's
+ *                  updated to account for the operands that were consumed.
  *
  * Output:
- *   true  = success.  The operand or operator is added to this->console_buf.
- *   false = failure.
+ *   true  = success.  The result is at the top of the operand stack.
+ *   false = failure.  There weren't enough operands, or the math failed.
  */
 static bool
-calculator_get_console_trv_cb(const void *ctx,
-                              const void *object,
-                              int type)
+calculator_reduce(const operator   *op,
+                  calculator_token *operands,
+                  size_t           *num_operands)
 {
   bool retcode = false;
-  calculator *this = (calculator *) ctx;
 
-  if(this != (calculator *) 0)
+  operator_type op_type;
+  if(operator_get_op_type(op, &op_type) == true)
   {
-    size_t buf_len      = strlen(this->console_buf);
-    size_t buf_dst_max  = sizeof(this->console_buf) - buf_len;
-    char  *buf_dst      = &this->console_buf[buf_len];
-    bool   buf_is_empty = (buf_len == 0);
-
-    switch(type)
+    size_t n = *num_operands;
+    switch(op_type)
     {
-    case LIST_OBJ_TYPE_OPERAND:
-      if(buf_is_empty == false)
-      {
-        *(buf_dst++) = ' ';
-        buf_is_empty = (--buf_dst_max == 0) ? true : false;
-      }
-      retcode = operand_to_str((operand *) object, buf_dst, buf_dst_max);
+    case op_type_unary:
+      retcode = (n >= 1) ? operator_do_unary(op, operands[n - 1].object) : false;
       break;
 
-    case LIST_OBJ_TYPE_OPERATOR:
-      {
-        operator *cur_operator = (operator *) object;
-        const char *op_name;
-        if((retcode = operator_get_name(cur_operator, &op_name)) == true)
-        {
-          snprintf(buf_dst, buf_dst_max, buf_is_empty ? "%s" : " %s", op_name);
-        }
-      }
+    case op_type_binary:
+      retcode = (n >= 2) ? operator_do_binary(op, operands[n - 2].object, operands[n - 1].object) : false;
+      *num_operands = (retcode == true) ? (n - 1) : n;
+      break;
+
+    /* Parentheses don't do anything. */
+    case op_type_none:
+      retcode = true;
       break;
 
-    case LIST_OBJ_TYPE_ERROR:
     default:
-      retcode = false;
       break;
     }
   }
@@ -450,430 +548,2439 @@ calculator_get_console_trv_cb(const void *ctx,
   return retcode;
 }
 
-/* This is a callback function for a list traversal.  When the user switches the
- * calculator base (for example, switching from base10 to base16), we need to
- * walk through the infix data and convert each operand to the new base.  We use
- * list::list_traverse() to walk the list, and it passes each operand object to
- * this member.  This member then tells the operand class to convert the
- * operand.
+/* Feed one operator to the single pass evaluator.  The operators that are
+ * waiting on the operator stack are applied as soon as the precedence rules
+ * say they're ready.  Then the new operator waits on the stack.
+ *
+ * A closing parentheses applies everything down to its open parentheses.  Both
+ * parentheses are thrown away.
  *
  * Input:
- *   ctx    = A pointer to the calculator object.
+ *   op            = A pointer to the operator object.
+ *
+ *   operators     = The operator stack.
+ *
+ *   num_operators = A pointer to the number of operators on the stack.
  *
- *   object = An opaque value that represents an object.
+ *   operands      = The operand stack.
  *
- *   type   = This defines what type of object is contained in object.  We
- *            use the type to help us identify the object.
+ *   num_operands  = A pointer to the number of operands on the stack.
  *
  * Output:
- *   true  = success.  The base is correct for the specified operand.
- *   false = failure.  The base setting for the operand is undefined.
+ *   true  = success.  The stacks are updated.
+ *   false = failure.  The equation is invalid, or the math failed.
  */
 static bool
-calculator_set_base_trv_cb(const void *ctx,
-                           const void *object,
-                           int type)
+calculator_evaluate_operator(const operator   *op,
+                             calculator_token *operators,
+                             size_t           *num_operators,
+                             calculator_token *operands,
+                             size_t           *num_operands)
 {
   bool retcode = false;
 
-  if(ctx != (const void *) 0)
+  size_t n_ops = *num_operators;
+
+  do
   {
-    calculator *this = (calculator *) ctx;
-    if(type == LIST_OBJ_TYPE_OPERAND)
+    operator_special_type special_type;
+    int cur_input, cur_stack;
+    if(operator_get_op_specialtype(op, &special_type) == false)   { break; }
+    if(operator_precedence(op, &cur_input, &cur_stack) == false)  { break; }
+    retcode = true;
+
+    if(special_type == op_special_type_r_paren)
     {
-      /* Set the new base.  Don't worry about setting it to the same value.
-       * Let the operand object fend for itself. */
-      switch(this->base)
+      while((retcode == true) && (n_ops > 0))
       {
-      case operand_type_base_10:
-        retcode = operand_set_base((operand *) object, operand_type_base_10);
-        break;
-
-      case operand_type_base_16:
-        retcode = operand_set_base((operand *) object, operand_type_base_16);
-        break;
+        operator_special_type stk_special_type;
+        const operator *stk_operator = operators[--n_ops].object;
+        if((retcode = operator_get_op_specialtype(stk_operator, &stk_special_type)) == false) { break; }
+        if(stk_special_type == op_special_type_l_paren)
+        {
+          break;
+        }
+        retcode = calculator_reduce(stk_operator, operands, num_operands);
+      }
+      break;
+    }
 
-      default:
+    /* Apply the operators that are waiting until we encounter one that is a
+     * lower precedence or we hit the bottom of the stack.  An open parentheses
+     * has the highest stack precedence, so it always stops us. */
+    while((retcode == true) && (n_ops > 0))
+    {
+      int stk_input, stk_stack;
+      if((retcode = operator_precedence(operators[n_ops - 1].object, &stk_input, &stk_stack)) == false) { break; }
+      if(stk_stack > cur_input)
+      {
         break;
       }
+      retcode = calculator_reduce(operators[--n_ops].object, operands, num_operands);
     }
 
-    /* Operators are a NOP. */
-    else
+    if(retcode == true)
     {
-      retcode = true;
+      operators[n_ops].type     = LIST_OBJ_TYPE_OPERATOR;
+      operators[n_ops++].object = (void *) op;
     }
-  }
+  } while(0);
+
+  *num_operators = n_ops;
 
   return retcode;
 }
 
-/******************************************************************************
- ********************************* PUBLIC API *********************************
- *****************************************************************************/
-
-/* Create a new calculator object.  This object can be used to access the
- * calculator class.
+/* This function is the workhorse of the class.  It evaluates an infix
+ * equation in a single pass.  Operators wait on an operator stack, and
+ * operands wait on an operand stack.  As soon as the precedence rules say an
+ * operator is ready, it's applied to the operands at the top of the operand
+ * stack.  It does the math in the same order as converting to postfix and then
+ * evaluating the postfix, without building the postfix equation.
+ *
+ * Open parentheses that are still on the stack at the end are closed
+ * implicitly.
+ *
+ * The results of the math are stored in the operand objects, so the operands
+ * in the infix equation are modified.
  *
  * Input:
- *   N/A
+ *   infix      = The tokens of the infix equation.
+ *
+ *   num_tokens = The number of tokens in the infix equation.
+ *
+ *   operators  = The operator stack.  It must have room for num_tokens tokens.
+ *
+ *   operands   = The operand stack.  It must have room for num_tokens tokens.
+ *
+ *   result     = A pointer to a variable that receives a pointer to the
+ *                operand that contains the result.  It's set to 0 if the
+ *                equation is empty (the result is zero).
  *
  * Output:
- *   Returns a pointer to the object.
- *   Returns 0 if unable to create the object.
+ *   true  = success.  *result contains the result.
+ *   false = failure.  The equation is invalid, or the math failed.
  */
-calculator *
-calculator_new(void)
+static bool
+calculator_evaluate_tokens(const calculator_token *infix,
+                           size_t                  num_tokens,
+                           calculator_token       *operators,
+                           calculator_token       *operands,
+                           operand               **result)
 {
-  calculator *this = (calculator *) 0;
+  bool retcode = true;
 
-  /* Initialize. */
-  if((this = (calculator *) malloc(sizeof(*this))) != (calculator *) 0)
+  size_t n_ops  = 0;
+  size_t n_vals = 0;
+
+  size_t i;
+  for(i = 0; (retcode == true) && (i < num_tokens); i++)
   {
-    memset(this, 0, sizeof(*this));
+    const calculator_token *t = &infix[i];
 
-    /* Create an empty infix list. */
-    if((this->infix_list = list_new()) != (list *) 0)
+    switch(t->type)
     {
-      /* Okay, we have successfully allocated everything that needs to be
-       * allocated for a new calculator object.  We are successful.  Go ahead
-       * and initialize the object. */
+    /* Operands wait on the operand stack. */
+    case LIST_OBJ_TYPE_OPERAND:
+      operands[n_vals++] = *t;
+      break;
 
-      /* The default base is decimal (base_10). */
-      this->base = operand_type_base_10;
+    case LIST_OBJ_TYPE_OPERATOR:
+      retcode = calculator_evaluate_operator(t->object, operators, &n_ops, operands, &n_vals);
+      break;
 
-      /* Start the parentheses counter at zero. */
-      this->paren_count = 0;
+    /* Unknown object type. */
+    default:
+      retcode = false;
+      break;
     }
+  }
 
-    else
+  /* When we're done, apply the rest of the operators. */
+  while((retcode == true) && (n_ops > 0))
+  {
+    retcode = calculator_reduce(operators[--n_ops].object, operands, &n_vals);
+  }
+
+  /* The operand stack must be empty (the result is zero), or contain exactly
+   * one operand (the result). */
+  if(retcode == true)
+  {
+    switch(n_vals)
     {
-      calculator_delete(this);
-      this = (calculator *) 0;
+    case 0:
+      *result = (operand *) 0;
+      break;
+
+    case 1:
+      *result = operands[0].object;
+      break;
+
+    default:
+      retcode = false;
+      break;
     }
   }
 
-  return this;
+  return retcode;
 }
 
-/* Delete a calculator object that was created by calculator_new().
+/* Evaluate the infix equation that the user has typed in.
  *
  * Input:
- *   this = A pointer to the calculator object.
+ *   this = A pointer to the calculator object.  The infix equation is already
+ *          stored in this->infix.
  *
  * Output:
- *   true  = success.  The object is deleted.
- *   false = failure.
+ *   true  = success.  The result is the only token in the infix equation.
+ *   false = failure.  No result.  The infix equation contains an error token.
  */
-bool
-calculator_delete(calculator *this)
+static bool
+calculator_evaluate(calculator *this)
 {
   bool retcode = false;
 
-  if(this != (calculator *) 0)
+  /* Neither stack can get deeper than the infix equation is long. */
+  operand *result = (operand *) 0;
+  if((calculator_tokens_reserve(&this->operators, this->infix.len) == true) &&
+     (calculator_tokens_reserve(&this->operands,  this->infix.len) == true))
   {
-    retcode = list_delete(this->infix_list);
+    retcode = calculator_evaluate_tokens(this->infix.tokens, this->infix.len, this->operators.tokens, this->operands.tokens, &result);
+  }
 
-    free(this);
+  /* The result is the only object that we keep.  Everything else in the infix
+   * equation has been consumed. */
+  size_t i;
+  for(i = 0; i < this->infix.len; i++)
+  {
+    if((retcode == false) || (this->infix.tokens[i].object != result))
+    {
+      calculator_token_release(this, &this->infix.tokens[i]);
+    }
+  }
+  this->infix.len   = 0;
+  this->paren_count = 0;
+  calculator_console_invalidate(this, 0);
+
+  /* If we were totally successful, this is where we save the result.  If we
+   * failed, insert a token that indicates an error.  There's room for either
+   * one, because the infix equation is empty. */
+  if(retcode == true)
+  {
+    if(result != (operand *) 0)
+    {
+      calculator_tokens_add_tail(&this->infix, LIST_OBJ_TYPE_OPERAND, result);
+    }
+  }
+  else
+  {
+    calculator_tokens_add_tail(&this->infix, LIST_OBJ_TYPE_ERROR, (void *) 0);
   }
 
   return retcode;
 }
 
-/* Get the current number base that the calculator is configured for.  Note
- * that this refers to the setting of the calculator object.  It doesn't
- * necessarily mean all of the internal operand objects are the same.  They
- * should be correct, but it's worth noting that calculator base settings and
- * operand base settings are not absolutely tied together.
+/* Forget the running result of processing mode.  The next call to
+ * calculator_run_update() starts again at the front of the infix equation.
  *
  * Input:
- *       this = A pointer to the calculator object.
+ *   this = A pointer to the calculator object.
  *
- *   cur_base = A pointer to a variable that is set to the current base.
+ * Output:
+ *   N/A.
+ */
+static void
+calculator_run_reset(calculator *this)
+{
+  this->run_error         = false;
+  this->run_len           = 0;
+  this->run_operators.len = 0;
+  this->run_operands.len  = 0;
+}
+
+/* Bring the running result of processing mode up to date.  The tokens that
+ * were added to the infix equation since the last call are folded into the
+ * running stacks.  The operand at the end of the equation is left alone,
+ * because the user might still be typing it.  Each token is only folded once,
+ * so this is O(1) amortized per token.
+ *
+ * Input:
+ *   this = A pointer to the calculator object.
  *
  * Output:
- *   true  = success.  *base = the current base.
- *   false = failure.  *base is undefined.
+ *   true  = success.  The running stacks are up to date.
+ *   false = failure.  The equation so far is invalid, or the math failed.
  */
-bool
-calculator_get_operand_type(calculator *this,
-                            operand_type *cur_base)
+static bool
+calculator_run_update(calculator *this)
 {
-  bool retcode = false;
+  size_t limit = this->infix.len;
+  if((limit > 0) && (this->infix.tokens[limit - 1].type == LIST_OBJ_TYPE_OPERAND))
+  {
+    limit--;
+  }
 
-  if(cur_base != (operand_type *) 0)
+  /* Neither stack can get deeper than the infix equation is long. */
+  if((this->run_error == false) && (this->run_len < limit))
   {
-    if(this != (calculator *) 0)
+    if((calculator_tokens_reserve(&this->run_operators, limit) == false) ||
+       (calculator_tokens_reserve(&this->run_operands,  limit) == false))
     {
-      *cur_base = this->base;
-      retcode = true;
+      this->run_error = true;
     }
   }
 
-  return retcode;
+  calculator_tokens *ops  = &this->run_operators;
+  calculator_tokens *vals = &this->run_operands;
+  for( ; (this->run_error == false) && (this->run_len < limit); this->run_len++)
+  {
+    const calculator_token *t = &this->infix.tokens[this->run_len];
+
+    switch(t->type)
+    {
+    /* Copy the operand into the next slot on the operand stack.  The slots
+     * keep their operand objects, so they're only created once. */
+    case LIST_OBJ_TYPE_OPERAND:
+      if(vals->len == this->run_num_objects)
+      {
+        operand *o;
+        if((o = operand_new(this->base)) == (operand *) 0)
+        {
+          this->run_error = true;
+          break;
+        }
+        vals->tokens[this->run_num_objects].type     = LIST_OBJ_TYPE_OPERAND;
+        vals->tokens[this->run_num_objects++].object = o;
+      }
+      this->run_error = (operand_copy(t->object, vals->tokens[vals->len++].object) == true) ? false : true;
+      break;
+
+    case LIST_OBJ_TYPE_OPERATOR:
+      this->run_error = (calculator_evaluate_operator(t->object, ops->tokens, &ops->len, vals->tokens, &vals->len) == true) ? false : true;
+      break;
+
+    default:
+      this->run_error = true;
+      break;
+    }
+  }
+
+  return (this->run_error == false) ? true : false;
 }
 
-/* Set the number base that the calculator should use.  Also walk through the
- * list of operands that are currently stored in the infix list and set them to
- * the specified base.
+/* When the user switches the calculator base (for example, switching from
+ * base10 to base16), we need to walk through the infix equation and convert
+ * each operand to the new base.  We pass each token to this member, and it
+ * tells the operand class to convert the operand.
  *
  * Input:
- *       this = A pointer to the calculator object.
+ *   this = A pointer to the calculator object.
  *
- *   new_base = The new base that we should set.
+ *   t    = A pointer to the token.  The type tells us what type of object it
+ *          contains.
  *
  * Output:
- *   true  = success.  The calculator is now using the new base.
- *   false = failure.  The calculator is NOT using the new base.  State unknown.
+ *   true  = success.  The base is correct for the specified operand.
+ *   false = failure.  The base setting for the operand is undefined.
  */
-bool
-calculator_set_operand_type(calculator *this,
-                            operand_type new_base)
+static bool
+calculator_set_base_token(calculator             *this,
+                          const calculator_token *t)
 {
   bool retcode = false;
 
   if(this != (calculator *) 0)
   {
-    switch(new_base)
+    if(t->type == LIST_OBJ_TYPE_OPERAND)
     {
-    case operand_type_base_10:
-    case operand_type_base_16:
-      /* This is a known base.  Save it and then walk the infix list and set
-       * all of the operands to the specified base. */
-      this->base = new_base;
-      retcode = list_traverse(this->infix_list, calculator_set_base_trv_cb, this);
-      break;
+      /* Set the new base.  Don't worry about setting it to the same value.
+       * Let the operand object fend for itself. */
+      switch(this->base)
+      {
+      case operand_type_base_10:
+        retcode = operand_set_base((operand *) t->object, operand_type_base_10);
+        break;
 
-    default:
-      break;
+      case operand_type_base_16:
+        retcode = operand_set_base((operand *) t->object, operand_type_base_16);
+        break;
+
+      default:
+        break;
+      }
+    }
+
+    /* Operators are a NOP. */
+    else
+    {
+      retcode = true;
     }
   }
 
   return retcode;
 }
 
-/* Add a character to the current equation.  As the user enters their equation
- * the data is passed to the calculator object via this member.
+/* Give the operands in this->eval back to the operand pool, and empty it.
  *
  * Input:
  *   this = A pointer to the calculator object.
  *
- *   c = The character to add.  Note that we only support 8-bit characters.
+ * Output:
+ *   N/A.
+ */
+static void
+calculator_eval_release(calculator *this)
+{
+  size_t i;
+  for(i = 0; i < this->eval.len; i++)
+  {
+    calculator_token_release(this, &this->eval.tokens[i]);
+  }
+  this->eval.len = 0;
+}
+
+/* Look up a placeholder name in a program that is being compiled.  The name is
+ * added to the program's slot_names table if it isn't there yet.  At this
+ * point the table is in order of first appearance.
+ *
+ * Input:
+ *   prog  = A pointer to the calculator_program object.
+ *
+ *   name  = The name (without the '$').  It doesn't need to be NULL
+ *           terminated.
+ *
+ *   len   = The length of the name.
+ *
+ *   index = A pointer to a variable that receives the index of the name.
  *
  * Output:
- *   true  = success.  The character has been added to the equation.  Note that
- *                     invalid characters are silently dropped.
- *   false = failure.  The character wasn't processed.  Some type of internal
- *                     error occurred.
+ *   true  = success.  *index is the index of the name.
+ *   false = failure.  Too many names, or unable to allocate memory.
  */
-bool
-calculator_add_char(calculator *this,
-                    const char c)
+static bool
+calculator_program_add_name(calculator_program *prog,
+                            const char         *name,
+                            size_t              len,
+                            size_t             *index)
 {
   bool retcode = false;
 
-  do
+  size_t i;
+  for(i = 0; i < prog->num_slots; i++)
   {
-    if(this == (calculator *) 0)
+    if((strncmp(prog->slot_names[i], name, len) == 0) && (prog->slot_names[i][len] == 0))
     {
+      *index  = i;
+      retcode = true;
       break;
     }
+  }
 
-    /* Backspace.  This is the equivalent of pressing the "Clear" button on a
-     * GUI calculator. */
-    if((c == 0x7F) || (c == 0x08))
+  if((retcode == false) && (prog->num_slots < PROGRAM_MAX_SLOTS))
+  {
+    char *s = malloc(len + 1);
+    if(s != (char *) 0)
     {
-      /* Delete the last item in the list. */
-      retcode = list_del_tail(this->infix_list);
+      memcpy(s, name, len);
+      s[len] = 0;
+      prog->slot_names[prog->num_slots] = s;
+      *index  = prog->num_slots++;
+      retcode = true;
     }
+  }
 
-    /* Get the last token on the infix_list.  If it's an operand we might
-     * need to reuse or delete it later. */
-    void *cur_obj      = (void *) 0;
-    int   cur_obj_type = LIST_OBJ_TYPE_NONE;
-    if(list_get_tail(this->infix_list, &cur_obj, &cur_obj_type) == true)
+  return retcode;
+}
+
+/* Split an equation into operand and operator tokens.  This is done in a
+ * single pass, and it applies the same rules as calculator_add_char():
+ * characters that aren't part of an operand or an operator are ignored, and
+ * closing parentheses that don't have a matching open parentheses are dropped.
+ * Whitespace ends an operand, so "1 2" is 2 operands.
+ *
+ * When we're compiling a program, "$" followed by letters, digits, and
+ * underscores is a placeholder.
+ *
+ * Input:
+ *   this       = A pointer to the calculator object.
+ *
+ *   expr       = The infix equation.
+ *
+ *   prog       = A pointer to the program that is being compiled, or 0 if
+ *                placeholders aren't allowed.
+ *
+ * Output:
+ *   true  = success.  this->eval contains the tokens.  The operands come from
+ *                     the operand pool.  Give them back with
+ *                     calculator_eval_release().
+ *   false = failure.  The equation contains an operand that can't be built,
+ *                     or that has more digits than an operand can hold.
+ */
+static bool
+calculator_eval_tokenize(calculator         *this,
+                         const char         *expr,
+                         calculator_program *prog)
+{
+  bool retcode = true;
+
+  operand *cur_operand = (operand *) 0;
+  size_t   paren_count = 0;
+
+  calculator_eval_release(this);
+
+  const char *p;
+  for(p = expr; (retcode == true) && (*p != 0); p++)
+  {
+    const char c = *p;
+
+    /* Placeholder. */
+    if((c == '$') && (prog != (calculator_program *) 0))
     {
-      /* If the calculator is currently in an error state, reject all input
-       * until the user hits the "Clear" button to erase the error. */
-      if(cur_obj_type == LIST_OBJ_TYPE_ERROR)
+      cur_operand = (operand *) 0;
+
+      size_t len = strspn(p + 1, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_");
+      size_t index;
+      if((retcode = (len > 0) ? true : false) == false)                                   { break; }
+      if((retcode = calculator_program_add_name(prog, (p + 1), len, &index)) == false)    { break; }
+      if((retcode = calculator_tokens_add_tail(&this->eval, LIST_OBJ_TYPE_PLACEHOLDER, (void *) (uintptr_t) index)) == false) { break; }
+      p += len;
+    }
+
+    /* Operand.  Start a new one, or add to the one we're building. */
+    else if(operand_add_char_is_valid_operand(this->base, c) == true)
+    {
+      if(cur_operand == (operand *) 0)
+      {
+        if((cur_operand = calculator_operand_get(this)) == (operand *) 0)
+        {
+          retcode = false;
+          break;
+        }
+        if((retcode = calculator_tokens_add_tail(&this->eval, LIST_OBJ_TYPE_OPERAND, cur_operand)) == false)
+        {
+          calculator_operand_put(this, cur_operand);
+          break;
+        }
+      }
+
+      /* The operand would silently drop a digit that doesn't fit.  That's
+       * fine for the keyboard, but here it would be a wrong answer. */
+      if(operand_add_char_is_full(cur_operand, c) == true)
       {
+        retcode = false;
         break;
       }
+      retcode = operand_add_char(cur_operand, c);
     }
 
-    /* Complete the equation.  Save the result. */
-    if(c == '=')
+    /* Operator. */
+    else if(operator_is_valid_operator(c) == true)
     {
-      if((retcode = calculator_infix2postfix(this)) == true)
+      cur_operand = (operand *) 0;
+
+      const operator *cur_operator;
+      if((cur_operator = operator_get(c)) == (const operator *) 0)
+      {
+        retcode = false;
+        break;
+      }
+
+      /* Keep track of the parentheses, and drop the ones that don't match. */
+      operator_special_type special_type;
+      if((retcode = operator_get_op_specialtype(cur_operator, &special_type)) == false)   { break; }
+      if(special_type == op_special_type_l_paren)
+      {
+        paren_count++;
+      }
+      else if(special_type == op_special_type_r_paren)
       {
-        retcode = calculator_postfix(this);
+        if(paren_count == 0)
+        {
+          continue;
+        }
+        paren_count--;
       }
+
+      retcode = calculator_tokens_add_tail(&this->eval, LIST_OBJ_TYPE_OPERATOR, (void *) cur_operator);
+    }
+
+    /* Anything else ends the current operand, and is otherwise ignored. */
+    else
+    {
+      cur_operand = (operand *) 0;
+    }
+  }
+
+  return retcode;
+}
+
+/* Convert the tokens in this->eval to postfix, so calculator_compile() can
+ * turn them into a program.  The operators come out in the same order that
+ * calculator_evaluate_tokens() applies them.  this->operators is the operator
+ * stack.
+ *
+ * Input:
+ *   this = A pointer to the calculator object.
+ *
+ * Output:
+ *   true  = success.  this->operands contains the postfix equation.
+ *   false = failure.
+ */
+static bool
+calculator_eval_infix2postfix(calculator *this)
+{
+  /* Neither one can get longer than the infix equation. */
+  bool retcode = ((calculator_tokens_reserve(&this->operators, this->eval.len) == true) &&
+                  (calculator_tokens_reserve(&this->operands,  this->eval.len) == true)) ? true : false;
+
+  calculator_token *out   = this->operands.tokens;
+  calculator_token *stk   = this->operators.tokens;
+  size_t            n_out = 0;
+  size_t            n_stk = 0;
+
+  size_t i;
+  for(i = 0; (retcode == true) && (i < this->eval.len); i++)
+  {
+    calculator_token *t = &this->eval.tokens[i];
+
+    /* Operands (and placeholders) go straight to the postfix equation. */
+    if(t->type != LIST_OBJ_TYPE_OPERATOR)
+    {
+      out[n_out++] = *t;
+      continue;
     }
 
-    /* Operand. */
-    else if(operand_add_char_is_valid_operand(this->base, c) == true)
-    {
-      operand *cur_operand = (operand *) 0;
-      if((cur_obj != (void *) 0) && (cur_obj_type == LIST_OBJ_TYPE_OPERAND))
-      {
-        /* We already have an operand object.  Can we use it for this char? */
-        if(operand_add_char_allowed(cur_obj) == true)
-        {
-          /* Yes.  We're all set. */
-          cur_operand = (operand *) cur_obj;
-        }
+    operator_special_type special_type;
+    int cur_input, cur_stack;
+    if(((retcode = operator_get_op_specialtype(t->object, &special_type)) == false) ||
+       ((retcode = operator_precedence(t->object, &cur_input, &cur_stack)) == false))
+    {
+      break;
+    }
+
+    /* A closing parentheses pops everything down to its open parentheses. */
+    if(special_type == op_special_type_r_paren)
+    {
+      while(n_stk > 0)
+      {
+        operator_special_type stk_special_type;
+        calculator_token *s = &stk[--n_stk];
+        if((retcode = operator_get_op_specialtype(s->object, &stk_special_type)) == false) { break; }
+        if(stk_special_type == op_special_type_l_paren)
+        {
+          break;
+        }
+        out[n_out++] = *s;
+      }
+      continue;
+    }
+
+    /* Keep popping operators until we encounter one that is a lower
+     * precedence or we hit the bottom of the stack.  An open parentheses has
+     * the highest stack precedence, so it always stops us. */
+    while(n_stk > 0)
+    {
+      int stk_input, stk_stack;
+      if((retcode = operator_precedence(stk[n_stk - 1].object, &stk_input, &stk_stack)) == false) { break; }
+      if(stk_stack > cur_input)
+      {
+        break;
+      }
+      out[n_out++] = stk[--n_stk];
+    }
+
+    stk[n_stk++] = *t;
+  }
+
+  /* When we're done, pop the rest of the stack and add it to the postfix.  The
+   * parentheses are thrown away. */
+  while((retcode == true) && (n_stk > 0))
+  {
+    operator_type op_type;
+    calculator_token *s = &stk[--n_stk];
+    if((retcode = operator_get_op_type(s->object, &op_type)) == true)
+    {
+      if(op_type != op_type_none)
+      {
+        out[n_out++] = *s;
+      }
+    }
+  }
+
+  this->operands.len = n_out;
+
+  return retcode;
+}
+
+/* Convert the result of an equation to a string.
+ *
+ * Input:
+ *   result   = A pointer to the operand that contains the result, or 0 if the
+ *              equation was empty (the result is zero).
+ *
+ *   out      = The caller-supplied buffer that receives the result.
+ *
+ *   out_size = The size of out.
+ *
+ * Output:
+ *   true  = success.  out contains the result.
+ *   false = failure.  out contains an empty string.
+ */
+static bool
+calculator_eval_result_to_str(operand *result,
+                              char    *out,
+                              size_t   out_size)
+{
+  bool retcode = true;
+
+  /* An empty equation is zero. */
+  if(result == (operand *) 0)
+  {
+    strncpy(out, "0", out_size);
+    out[out_size - 1] = 0;
+  }
+  else
+  {
+    if((retcode = operand_to_str(result, out, out_size)) == false)
+    {
+      out[0] = 0;
+    }
+  }
+
+  return retcode;
+}
+
+/* Assign the parameter slots for a program that is being compiled.  The
+ * positional placeholders ("$1", "$2", ...) get the first slots, and the named
+ * placeholders follow them in order of first appearance.  On success, the
+ * program's slot_names table is indexed by slot.
+ *
+ * Input:
+ *   prog = A pointer to the calculator_program object.
+ *
+ *   map  = An array that receives the slot number for each of the names in
+ *          the program's slot_names table (by order of first appearance).
+ *
+ * Output:
+ *   true  = success.  map[] and the slot_names table are set.
+ *   false = failure.  There is a bad positional placeholder, or there are too
+ *                     many slots, or we were unable to allocate memory.
+ */
+static bool
+calculator_program_assign_slots(calculator_program *prog,
+                                size_t             *map)
+{
+  bool retcode = true;
+
+  size_t num_names = prog->num_slots;
+  size_t num_slots = 0;
+  size_t i;
+
+  /* The positional placeholders select their own slots. */
+  for(i = 0; (retcode == true) && (i < num_names); i++)
+  {
+    const char *name = prog->slot_names[i];
+    map[i] = SIZE_MAX;
+    if(strspn(name, "0123456789") == strlen(name))
+    {
+      long n = strtol(name, (char **) 0, 10);
+      if((n < 1) || (n > PROGRAM_MAX_SLOTS))
+      {
+        retcode = false;
+        break;
+      }
+      map[i] = (n - 1);
+      num_slots = (n > num_slots) ? n : num_slots;
+    }
+  }
+
+  /* The named placeholders go after them. */
+  for(i = 0; (retcode == true) && (i < num_names); i++)
+  {
+    if(map[i] == SIZE_MAX)
+    {
+      map[i] = num_slots++;
+    }
+  }
+
+  char **names = (char **) 0;
+  if((retcode == true) && (num_slots <= PROGRAM_MAX_SLOTS))
+  {
+    names = calloc((num_slots > 0) ? num_slots : 1, sizeof(*names));
+  }
+
+  /* Rebuild the table by slot.  "$1" and "$01" are the same slot, so we only
+   * need one of the names. */
+  if(names != (char **) 0)
+  {
+    for(i = 0; i < num_names; i++)
+    {
+      if(names[map[i]] == (char *) 0)
+      {
+        names[map[i]] = prog->slot_names[i];
+      }
+      else
+      {
+        free(prog->slot_names[i]);
+      }
+    }
+    free(prog->slot_names);
+    prog->slot_names = names;
+    prog->num_slots  = num_slots;
+  }
+  else
+  {
+    retcode = false;
+  }
+
+  return retcode;
+}
+
+/* Try to evaluate the instruction that was just added to a program at compile
+ * time.  If the operator's operands are all constants, the operator and its
+ * operands are replaced with a single constant.  If the math fails (i.e.
+ * divide by zero), the instructions are left alone so that the program fails
+ * when it's run.
+ *
+ * Input:
+ *   prog = A pointer to the calculator_program object.
+ *
+ *   tmp  = A scratch operand.
+ *
+ * Output:
+ *   N/A.
+ */
+static void
+calculator_program_fold(calculator_program *prog,
+                        operand            *tmp)
+{
+  calculator_program_op *op  = &prog->code[prog->code_len - 1];
+  size_t                 num = (op->opcode == PROGRAM_OP_BINARY) ? 2 : 1;
+
+  bool   fold = (prog->code_len > num) ? true : false;
+  size_t i;
+  for(i = 1; (fold == true) && (i <= num); i++)
+  {
+    fold = (op[-i].opcode == PROGRAM_OP_PUSH_CONST) ? true : false;
+  }
+
+  if(fold == true)
+  {
+    const operator *opr = operator_get((char) op->index);
+    operand       **k   = &prog->constants[prog->num_constants - num];
+
+    if(operand_copy(k[0], tmp) == true)
+    {
+      bool ok = (num == 2) ? operator_do_binary(opr, tmp, k[1]) : operator_do_unary(opr, tmp);
+      if((ok == true) && (operand_copy(tmp, k[0]) == true))
+      {
+        if(num == 2)
+        {
+          operand_delete(k[1]);
+          prog->num_constants--;
+        }
+        prog->code_len -= num;
+      }
+    }
+  }
+}
+
+/* Turn the postfix equation in this->operands into the instructions for a
+ * program.  Operands are copied into the program's constant pool.  We check
+ * the stack depth as we go, so a program that compiles can't underflow the
+ * stack when it's run.
+ *
+ * Input:
+ *   this        = A pointer to the calculator object.
+ *
+ *   prog        = A pointer to the calculator_program object.
+ *
+ *   map         = The slot number for each placeholder name.
+ *
+ * Output:
+ *   true  = success.  The program is ready to run.
+ *   false = failure.  The equation is invalid, or we were unable to allocate
+ *                     memory.
+ */
+static bool
+calculator_program_build(calculator         *this,
+                         calculator_program *prog,
+                         const size_t       *map)
+{
+  bool retcode = true;
+
+  size_t num_postfix = this->operands.len;
+
+  size_t alloc_len = (num_postfix > 0) ? num_postfix : 1;
+  prog->code      = malloc(alloc_len * sizeof(*prog->code));
+  prog->constants = malloc(alloc_len * sizeof(*prog->constants));
+  operand *tmp    = operand_new(prog->base);
+  if((prog->code == (calculator_program_op *) 0) || (prog->constants == (operand **) 0) || (tmp == (operand *) 0))
+  {
+    retcode = false;
+  }
+
+  size_t depth = 0;
+  size_t i;
+  for(i = 0; (retcode == true) && (i < num_postfix); i++)
+  {
+    calculator_token      *t  = &this->operands.tokens[i];
+    calculator_program_op *op = &prog->code[prog->code_len];
+
+    switch(t->type)
+    {
+    case LIST_OBJ_TYPE_OPERAND:
+      {
+        operand *k = operand_new(prog->base);
+        if((k == (operand *) 0) || (operand_copy(t->object, k) == false))
+        {
+          operand_delete(k);
+          retcode = false;
+          break;
+        }
+        prog->constants[prog->num_constants] = k;
+        op->opcode = PROGRAM_OP_PUSH_CONST;
+        op->index  = prog->num_constants++;
+        depth++;
+      }
+      break;
+
+    case LIST_OBJ_TYPE_PLACEHOLDER:
+      op->opcode = PROGRAM_OP_PUSH_SLOT;
+      op->index  = map[(uintptr_t) t->object];
+      depth++;
+      break;
+
+    case LIST_OBJ_TYPE_OPERATOR:
+      {
+        /* The program stores the operator's character.  The operator objects
+         * are constant, so any calculator can look them up when it runs. */
+        char c;
+        if((retcode = operator_get_value(t->object, &c)) == false)               { break; }
+
+        operator_type op_type;
+        if((retcode = operator_get_op_type(t->object, &op_type)) == false)        { break; }
+        if((op_type == op_type_unary) && (depth >= 1))
+        {
+          op->opcode = PROGRAM_OP_UNARY;
+        }
+        else if((op_type == op_type_binary) && (depth >= 2))
+        {
+          op->opcode = PROGRAM_OP_BINARY;
+          depth--;
+        }
+        else
+        {
+          retcode = false;
+          break;
+        }
+        op->index = (uint8_t) c;
+      }
+      break;
+
+    default:
+      retcode = false;
+      break;
+    }
+
+    if(retcode == true)
+    {
+      prog->code_len++;
+      prog->max_depth = (depth > prog->max_depth) ? depth : prog->max_depth;
+      if((op->opcode == PROGRAM_OP_UNARY) || (op->opcode == PROGRAM_OP_BINARY))
+      {
+        calculator_program_fold(prog, tmp);
+      }
+    }
+  }
+
+  /* The stack must be empty (the result is zero), or contain exactly one
+   * operand (the result). */
+  if(depth > 1)
+  {
+    retcode = false;
+  }
+
+  operand_delete(tmp);
+
+  return retcode;
+}
+
+/******************************************************************************
+ ********************************* PUBLIC API *********************************
+ *****************************************************************************/
+
+/* Create a new calculator object.  This object can be used to access the
+ * calculator class.
+ *
+ * Input:
+ *   N/A
+ *
+ * Output:
+ *   Returns a pointer to the object.
+ *   Returns 0 if unable to create the object.
+ */
+calculator *
+calculator_new(void)
+{
+  calculator *this = (calculator *) 0;
+
+  /* Initialize. */
+  if((this = (calculator *) malloc(sizeof(*this))) != (calculator *) 0)
+  {
+    memset(this, 0, sizeof(*this));
+
+    /* Create an empty infix equation. */
+    if(calculator_tokens_reserve(&this->infix, 64) == true)
+    {
+      /* Okay, we have successfully allocated everything that needs to be
+       * allocated for a new calculator object.  We are successful.  Go ahead
+       * and initialize the object. */
+
+      /* The default base is decimal (base_10). */
+      this->base = operand_type_base_10;
+
+      /* Start the parentheses counter at zero. */
+      this->paren_count = 0;
+    }
+
+    else
+    {
+      calculator_delete(this);
+      this = (calculator *) 0;
+    }
+  }
+
+  return this;
+}
+
+/* Delete a calculator object that was created by calculator_new().
+ *
+ * Input:
+ *   this = A pointer to the calculator object.
+ *
+ * Output:
+ *   true  = success.  The object is deleted.
+ *   false = failure.
+ */
+bool
+calculator_delete(calculator *this)
+{
+  bool retcode = false;
+
+  if(this != (calculator *) 0)
+  {
+    /* The stacks don't own anything between equations. */
+    while(calculator_infix_del_tail(this) == true);
+    free(this->infix.tokens);
+    free(this->console);
+    free(this->console_offsets);
+    free(this->operators.tokens);
+    free(this->operands.tokens);
+
+    size_t i;
+    for(i = 0; i < this->run_num_objects; i++)
+    {
+      operand_delete(this->run_operands.tokens[i].object);
+    }
+    free(this->run_operators.tokens);
+    free(this->run_operands.tokens);
+
+    calculator_eval_release(this);
+    free(this->eval.tokens);
+    for(i = 0; i < this->operand_pool_len; i++)
+    {
+      operand_delete(this->operand_pool[i]);
+    }
+    free(this->operand_pool);
+
+    free(this);
+    retcode = true;
+  }
+
+  return retcode;
+}
+
+/* Get the current number base that the calculator is configured for.  Note
+ * that this refers to the setting of the calculator object.  It doesn't
+ * necessarily mean all of the internal operand objects are the same.  They
+ * should be correct, but it's worth noting that calculator base settings and
+ * operand base settings are not absolutely tied together.
+ *
+ * Input:
+ *       this = A pointer to the calculator object.
+ *
+ *   cur_base = A pointer to a variable that is set to the current base.
+ *
+ * Output:
+ *   true  = success.  *base = the current base.
+ *   false = failure.  *base is undefined.
+ */
+bool
+calculator_get_operand_type(calculator *this,
+                            operand_type *cur_base)
+{
+  bool retcode = false;
+
+  if(cur_base != (operand_type *) 0)
+  {
+    if(this != (calculator *) 0)
+    {
+      *cur_base = this->base;
+      retcode = true;
+    }
+  }
+
+  return retcode;
+}
+
+/* Set the number base that the calculator should use.  Also walk through the
+ * list of operands that are currently stored in the infix list and set them to
+ * the specified base.
+ *
+ * Input:
+ *       this = A pointer to the calculator object.
+ *
+ *   new_base = The new base that we should set.
+ *
+ * Output:
+ *   true  = success.  The calculator is now using the new base.
+ *   false = failure.  The calculator is NOT using the new base.  State unknown.
+ */
+bool
+calculator_set_operand_type(calculator *this,
+                            operand_type new_base)
+{
+  bool retcode = false;
+
+  if(this != (calculator *) 0)
+  {
+    switch(new_base)
+    {
+    case operand_type_base_10:
+    case operand_type_base_16:
+      /* This is a known base.  Save it and then walk the infix equation and
+       * set all of the operands to the specified base. */
+      this->base = new_base;
+      retcode = true;
+      size_t i;
+      for(i = 0; i < this->infix.len; i++)
+      {
+        retcode = calculator_set_base_token(this, &this->infix.tokens[i]);
+      }
+
+      calculator_console_invalidate(this, 0);
+
+      /* The running result is in the old base.  Build it again. */
+      if(this->processing_mode == true)
+      {
+        calculator_run_reset(this);
+        calculator_run_update(this);
+      }
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  return retcode;
+}
+
+/* Get the processing mode setting of the calculator.
+ *
+ * Input:
+ *   this    = A pointer to the calculator object.
+ *
+ *   enabled = A pointer to a variable that receives the setting.
+ *
+ * Output:
+ *   true  = success.  *enabled contains the setting.
+ *   false = failure.  *enabled is undefined.
+ */
+bool
+calculator_get_processing_mode(calculator *this,
+                               bool       *enabled)
+{
+  bool retcode = false;
+
+  if((this != (calculator *) 0) && (enabled != (bool *) 0))
+  {
+    *enabled = this->processing_mode;
+    retcode = true;
+  }
+
+  return retcode;
+}
+
+/* Turn processing mode on or off.  In processing mode, the calculator
+ * evaluates the equation as it's typed in, and keeps a running result.  Each
+ * token is folded into the running result once, when the token after it
+ * arrives.  Use calculator_get_running_result() to get it.
+ *
+ * Input:
+ *   this    = A pointer to the calculator object.
+ *
+ *   enabled = true to turn processing mode on.  false to turn it off.
+ *
+ * Output:
+ *   true  = success.  The calculator is in the requested mode.
+ *   false = failure.
+ */
+bool
+calculator_set_processing_mode(calculator *this,
+                               bool        enabled)
+{
+  bool retcode = false;
+
+  if(this != (calculator *) 0)
+  {
+    this->processing_mode = enabled;
+    calculator_run_reset(this);
+    if(enabled == true)
+    {
+      calculator_run_update(this);
+    }
+    retcode = true;
+  }
+
+  return retcode;
+}
+
+/* Add a character to the current equation.  As the user enters their equation
+ * the data is passed to the calculator object via this member.
+ *
+ * Input:
+ *   this = A pointer to the calculator object.
+ *
+ *   c = The character to add.  Note that we only support 8-bit characters.
+ *
+ * Output:
+ *   true  = success.  The character has been added to the equation.  Note that
+ *                     invalid characters are silently dropped.
+ *   false = failure.  The character wasn't processed.  Some type of internal
+ *                     error occurred.
+ */
+bool
+calculator_add_char(calculator *this,
+                    const char c)
+{
+  bool retcode = false;
+
+  do
+  {
+    if(this == (calculator *) 0)
+    {
+      break;
+    }
+
+    /* Backspace.  This is the equivalent of pressing the "Clear" button on a
+     * GUI calculator. */
+    if((c == 0x7F) || (c == 0x08))
+    {
+      /* Delete the last token in the equation. */
+      retcode = calculator_infix_del_tail(this);
+    }
+
+    /* Get the last token in the infix equation.  If it's an operand we might
+     * need to reuse or delete it later. */
+    void *cur_obj      = (void *) 0;
+    int   cur_obj_type = LIST_OBJ_TYPE_NONE;
+    if(this->infix.len > 0)
+    {
+      cur_obj      = this->infix.tokens[this->infix.len - 1].object;
+      cur_obj_type = this->infix.tokens[this->infix.len - 1].type;
+
+      /* If the calculator is currently in an error state, reject all input
+       * until the user hits the "Clear" button to erase the error. */
+      if(cur_obj_type == LIST_OBJ_TYPE_ERROR)
+      {
+        break;
+      }
+    }
+
+    /* Complete the equation.  Save the result. */
+    if(c == '=')
+    {
+      retcode = calculator_evaluate(this);
+      calculator_run_reset(this);
+    }
+
+    /* Operand. */
+    else if(operand_add_char_is_valid_operand(this->base, c) == true)
+    {
+      operand *cur_operand = (operand *) 0;
+      if((cur_obj != (void *) 0) && (cur_obj_type == LIST_OBJ_TYPE_OPERAND))
+      {
+        /* We already have an operand object.  Can we use it for this char? */
+        if(operand_add_char_allowed(cur_obj) == true)
+        {
+          /* Yes.  We're all set. */
+          cur_operand = (operand *) cur_obj;
+        }
+
+        /* We have an operand object that we can't use for this char.  Delete
+         * it.  We'll have to allocate a new object later. */
+        else
+        {
+          if(calculator_infix_del_tail(this) == false)
+          {
+            break;
+          }
+          cur_operand = (operand *) 0;
+        }
+      }
+
+      /* If we didn't find an operand object, allocate one now. */
+      if(cur_operand == (operand *) 0)
+      {
+        if((cur_operand = calculator_operand_get(this)) == (operand *) 0)
+        {
+          break;
+        }
+
+        if((retcode = calculator_tokens_add_tail(&this->infix, LIST_OBJ_TYPE_OPERAND, cur_operand)) == false)
+        {
+          calculator_operand_put(this, cur_operand);
+          break;
+        }
+      }
+
+      /* Okay, we have the correct operand object.  Add the character. */
+      calculator_console_invalidate(this, (this->infix.len - 1));
+      retcode = operand_add_char(cur_operand, c);
+    }
+
+    /* Operator. */
+    else if(operator_is_valid_operator(c) == true)
+    {
+      const operator *cur_operator = operator_get(c);
+      if(cur_operator != (const operator *) 0)
+      {
+        /* If the result from the previous calculation is immediately before
+         * us, and if this is an operator that doesn't require operands, then
+         * we need to throw the previous result away. */
+        if((cur_obj != (void *) 0) && (cur_obj_type == LIST_OBJ_TYPE_OPERAND) && (operand_add_char_allowed(cur_obj) == false))
+        {
+          operator_type op_type;
+          if(operator_get_op_type(cur_operator, &op_type) == false)
+          {
+            break;
+          }
+
+          if((op_type == op_type_none) && (calculator_infix_del_tail(this) == false))
+          {
+            break;
+          }
+        }
+
+        /* Check to see if there is any special processing that needs to be done
+         * on this operator. */
+        bool keep_char = true;
+        operator_special_type special_type;
+        if(operator_get_op_specialtype(cur_operator, &special_type) == false)
+        {
+          break;
+        }
+        switch(special_type)
+        {
+        case op_special_type_l_paren:
+          keep_char = calculator_add_paren(this, true);
+          break;
+
+        case op_special_type_r_paren:
+          keep_char = calculator_add_paren(this, false);
+          break;
+
+        case op_special_type_none:
+        default:
+          break;
+        }
+
+        if(keep_char == true)
+        {
+          retcode = calculator_tokens_add_tail(&this->infix, LIST_OBJ_TYPE_OPERATOR, (void *) cur_operator);
+        }
+      }
+    }
+  } while(0);
+
+  /* In processing mode, fold the new tokens into the running result.  If
+   * tokens that were already folded have been deleted, start over. */
+  if((this != (calculator *) 0) && (this->processing_mode == true))
+  {
+    if(this->run_len > this->infix.len)
+    {
+      calculator_run_reset(this);
+    }
+    calculator_run_update(this);
+  }
+
+  return retcode;
+}
+
+/* Evaluate an entire equation, and return the result as a string.  This is
+ * the fast path for callers that have the whole equation up front (i.e. batch
+ * processing).  It doesn't go through calculator_add_char(), and it doesn't
+ * touch the infix list, so it doesn't change what the console displays.
+ *
+ * The equation uses the same characters as calculator_add_char() (without the
+ * '=').  It's evaluated in the calculator's current number base.
+ *
+ * Input:
+ *   this     = A pointer to the calculator object.
+ *
+ *   expr     = The infix equation (i.e. "1+2*3").
+ *
+ *   out      = The caller-supplied buffer that receives the result.
+ *
+ *   out_size = The size of out.  Note that we must allow 1 byte for the NULL
+ *              terminator.
+ *
+ * Output:
+ *   true  = success.  out contains the result.
+ *   false = failure.  The equation is invalid, an operand has too many digits,
+ *                     or the math failed (i.e. divide by zero).  out contains an
+ *                     empty string.
+ */
+bool
+calculator_eval_str(calculator *this,
+                    const char *expr,
+                    char       *out,
+                    size_t      out_size)
+{
+  bool retcode = false;
+
+  do
+  {
+    if((this == (calculator *) 0) || (expr == (const char *) 0))               { break; }
+    if((out == (char *) 0) || (out_size == 0))                                 { break; }
+    out[0] = 0;
+
+    /* Neither stack can get deeper than the infix equation is long. */
+    operand *result = (operand *) 0;
+    if(calculator_eval_tokenize(this, expr, (calculator_program *) 0) == false) { break; }
+    if(calculator_tokens_reserve(&this->operators, this->eval.len) == false)   { break; }
+    if(calculator_tokens_reserve(&this->operands,  this->eval.len) == false)   { break; }
+    if(calculator_evaluate_tokens(this->eval.tokens, this->eval.len, this->operators.tokens, this->operands.tokens, &result) == false) { break; }
+
+    retcode = calculator_eval_result_to_str(result, out, out_size);
+  } while(0);
+
+  if(this != (calculator *) 0)
+  {
+    calculator_eval_release(this);
+  }
+
+  return retcode;
+}
+
+/* Compile an equation into a program that can be run many times.  The
+ * equation is parsed once, here.  Running the program doesn't parse anything,
+ * and doesn't allocate any memory (once the calculator's work buffers are big
+ * enough).
+ *
+ * The equation uses the same characters as calculator_eval_str().  In
+ * addition, it can contain placeholders for values that are supplied when the
+ * program is run:
+ *
+ *   $1, $2, ... = Positional parameters.  "$1" is slot 0.
+ *   $name       = Named parameters.  They get the slots after the positional
+ *                 parameters, in order of first appearance.  Use
+ *                 calculator_program_get_slot() to look them up.
+ *
+ * The program is compiled for the calculator's current number base, and parts
+ * of the equation that only use constants are evaluated here.
+ *
+ * Input:
+ *   this = A pointer to the calculator object.
+ *
+ *   expr = The infix equation (i.e. "$price*(1+$tax)").
+ *
+ * Output:
+ *   Returns a pointer to the program.  Delete it with
+ *   calculator_program_delete().
+ *   Returns 0 if the equation is invalid, or if we were unable to allocate
+ *   memory.
+ */
+calculator_program *
+calculator_compile(calculator *this,
+                   const char *expr)
+{
+  calculator_program *prog = (calculator_program *) 0;
+
+  do
+  {
+    if((this == (calculator *) 0) || (expr == (const char *) 0))               { break; }
+
+    if((prog = malloc(sizeof(*prog))) == (calculator_program *) 0)             { break; }
+    memset(prog, 0, sizeof(*prog));
+    prog->base = this->base;
+
+    prog->slot_names = malloc(PROGRAM_MAX_SLOTS * sizeof(*prog->slot_names));
+    if(prog->slot_names == (char **) 0)
+    {
+      calculator_program_delete(prog);
+      prog = (calculator_program *) 0;
+      break;
+    }
+
+    size_t map[PROGRAM_MAX_SLOTS];
+    if((calculator_eval_tokenize(this, expr, prog) == false)                  ||
+       (calculator_eval_infix2postfix(this) == false)                         ||
+       (calculator_program_assign_slots(prog, map) == false)                  ||
+       (calculator_program_build(this, prog, map) == false))
+    {
+      calculator_program_delete(prog);
+      prog = (calculator_program *) 0;
+    }
+    calculator_eval_release(this);
+  } while(0);
+
+  return prog;
+}
+
+/* Delete a program that was created by calculator_compile().
+ *
+ * Input:
+ *   prog = A pointer to the calculator_program object.
+ *
+ * Output:
+ *   true  = success.  The object is deleted.
+ *   false = failure.
+ */
+bool
+calculator_program_delete(calculator_program *prog)
+{
+  bool retcode = false;
+
+  if(prog != (calculator_program *) 0)
+  {
+    size_t i;
+    for(i = 0; i < prog->num_constants; i++)
+    {
+      operand_delete(prog->constants[i]);
+    }
+    for(i = 0; (prog->slot_names != (char **) 0) && (i < prog->num_slots); i++)
+    {
+      free(prog->slot_names[i]);
+    }
+    free(prog->slot_names);
+    free(prog->constants);
+    free(prog->code);
+    free(prog);
+
+    retcode = true;
+  }
+
+  return retcode;
+}
+
+/* Get the number of parameter slots in a program.  This is the number of
+ * values that must be passed to calculator_program_eval().
+ *
+ * Input:
+ *   prog      = A pointer to the calculator_program object.
+ *
+ *   num_slots = A pointer to a variable that receives the number of slots.
+ *
+ * Output:
+ *   true  = success.  *num_slots is the number of slots.
+ *   false = failure.
+ */
+bool
+calculator_program_get_num_slots(const calculator_program *prog,
+                                 size_t                   *num_slots)
+{
+  bool retcode = false;
+
+  if((prog != (calculator_program *) 0) && (num_slots != (size_t *) 0))
+  {
+    *num_slots = prog->num_slots;
+    retcode = true;
+  }
+
+  return retcode;
+}
+
+/* Look up the slot for a placeholder.
+ *
+ * Input:
+ *   prog  = A pointer to the calculator_program object.
+ *
+ *   name  = The name of the placeholder, without the '$' (i.e. "price" or
+ *           "1").
+ *
+ *   index = A pointer to a variable that receives the slot number.
+ *
+ * Output:
+ *   true  = success.  *index is the slot number.
+ *   false = failure.  The program doesn't use that placeholder.
+ */
+bool
+calculator_program_get_slot(const calculator_program *prog,
+                            const char               *name,
+                            size_t                   *index)
+{
+  bool retcode = false;
+
+  if((prog != (calculator_program *) 0) && (name != (const char *) 0) && (index != (size_t *) 0))
+  {
+    /* Positional.  "1" and "01" are the same slot. */
+    if((name[0] != 0) && (strspn(name, "0123456789") == strlen(name)))
+    {
+      long n = strtol(name, (char **) 0, 10);
+      if((n >= 1) && (n <= prog->num_slots) && (prog->slot_names[n - 1] != (char *) 0))
+      {
+        *index  = (n - 1);
+        retcode = true;
+      }
+    }
+
+    /* Named. */
+    else
+    {
+      size_t i;
+      for(i = 0; i < prog->num_slots; i++)
+      {
+        if((prog->slot_names[i] != (char *) 0) && (strcmp(prog->slot_names[i], name) == 0))
+        {
+          *index  = i;
+          retcode = true;
+          break;
+        }
+      }
+    }
+  }
+
+  return retcode;
+}
+
+/* Run a program that was created by calculator_compile(), and return the
+ * result as a string.  The program isn't modified, so it can be run over and
+ * over (and by more than one calculator at the same time).  The calculator
+ * provides the evaluation stack.
+ *
+ * Input:
+ *   this     = A pointer to the calculator object.
+ *
+ *   prog     = A pointer to the calculator_program object.
+ *
+ *   args     = The values for the parameter slots.  args[0] is slot 0, etc.
+ *              They must use the same number base as the program.  They are
+ *              copied, not modified.
+ *
+ *   num_args = The number of values in args.  It must be at least the number
+ *              of slots in the program.
+ *
+ *   out      = The caller-supplied buffer that receives the result.
+ *
+ *   out_size = The size of out.  Note that we must allow 1 byte for the NULL
+ *              terminator.
+ *
+ * Output:
+ *   true  = success.  out contains the result.
+ *   false = failure.  A value is missing, or the math failed (i.e. divide by
+ *                     zero).  out contains an empty string.
+ */
+bool
+calculator_program_eval(calculator               *this,
+                        const calculator_program *prog,
+                        operand * const          *args,
+                        size_t                    num_args,
+                        char                     *out,
+                        size_t                    out_size)
+{
+  bool retcode = false;
+
+  do
+  {
+    if((this == (calculator *) 0) || (prog == (calculator_program *) 0))       { break; }
+    if((out == (char *) 0) || (out_size == 0))                                 { break; }
+    out[0] = 0;
+    if((num_args < prog->num_slots) || ((num_args > 0) && (args == (operand * const *) 0))) { break; }
+    calculator_eval_release(this);
+    if(calculator_tokens_reserve(&this->eval, prog->max_depth) == false)       { break; }
+
+    /* The evaluation stack is this->eval.  Each push gets an operand from the
+     * operand pool, and each binary operator gives one back. */
+    calculator_token *stk = this->eval.tokens;
+    bool              ok  = true;
+
+    size_t i;
+    for(i = 0; (ok == true) && (i < prog->code_len); i++)
+    {
+      const calculator_program_op *op    = &prog->code[i];
+      size_t                       depth = this->eval.len;
+      switch(op->opcode)
+      {
+      case PROGRAM_OP_PUSH_CONST:
+      case PROGRAM_OP_PUSH_SLOT:
+        {
+          const operand *src = (op->opcode == PROGRAM_OP_PUSH_CONST) ? prog->constants[op->index] : args[op->index];
+          operand       *o   = calculator_operand_get(this);
+          if((ok = (o != (operand *) 0) ? true : false) == true)
+          {
+            stk[this->eval.len].type     = LIST_OBJ_TYPE_OPERAND;
+            stk[this->eval.len++].object = o;
+            ok = operand_copy(src, o);
+          }
+        }
+        break;
+
+      case PROGRAM_OP_UNARY:
+        ok = operator_do_unary(operator_get((char) op->index), stk[depth - 1].object);
+        break;
+
+      case PROGRAM_OP_BINARY:
+        ok = operator_do_binary(operator_get((char) op->index), stk[depth - 2].object, stk[depth - 1].object);
+        calculator_token_release(this, &stk[--this->eval.len]);
+        break;
+
+      default:
+        ok = false;
+        break;
+      }
+    }
+
+    if(ok == true)
+    {
+      retcode = calculator_eval_result_to_str((this->eval.len > 0) ? stk[0].object : (operand *) 0, out, out_size);
+    }
+    calculator_eval_release(this);
+  } while(0);
+
+  return retcode;
+}
+
+/* This member will create an ASCII string that represents the value that
+ * should be displayed by the calculator.
+ *
+ * Input:
+ *   this     = A pointer to the calculator object.
+ *
+ *   buf      = The caller-supplied buffer that will receive the message.
+ *
+ *   buf_size = An int that specifies the size of buf.  This function will only
+ *              place up to (buf_size - 1) characters in the buffer, allowing
+ *              one byte for the NULL terminator.  If the entire string would
+ *              be longer than (buf_size - 1), then the END of the string will
+ *              be placed in the buffer.  This gives the illusion of a message
+ *              that is scrolling horizontally.
+ *
+ * Output:
+ *   true  = success.  The message has been created and placed in buf.
+ *   false = failure.  The contents of buf is undefined.
+ */
+bool
+calculator_get_console(calculator *this,
+                       char *buf,
+                       size_t buf_size)
+{
+  bool retcode = false;
+
+  do
+  {
+    if((this == (calculator *) 0) || (buf == (char *) 0) || (buf_size == 0)) { break; }
+
+    /* There's one more offset than there are tokens. */
+    if((this->infix.len + 1) > this->console_offsets_max)
+    {
+      size_t new_max = this->infix.max + 1;
+      size_t *p = realloc(this->console_offsets, new_max * sizeof(*p));
+      if(p == (size_t *) 0)                                                   { break; }
+      p[0] = 0;
+      this->console_offsets     = p;
+      this->console_offsets_max = new_max;
+    }
+
+    /* Render the tokens that have changed since the last time. */
+    if(this->console_valid > this->infix.len)
+    {
+      this->console_valid = this->infix.len;
+    }
+    retcode = true;
+    size_t len = this->console_offsets[this->console_valid];
+    size_t i;
+    for(i = this->console_valid; (retcode == true) && (i < this->infix.len); i++)
+    {
+      if((retcode = calculator_console_render_token(this, &this->infix.tokens[i], &len)) == true)
+      {
+        this->console_offsets[i + 1] = len;
+        this->console_valid          = i + 1;
+      }
+    }
+
+    if(retcode == true)
+    {
+      /* If the infix equation is empty, pass a zero back to the user. */
+      if(len == 0)
+      {
+        strncpy(buf, "0", buf_size);
+        buf[buf_size - 1] = 0;
+      }
+
+      /* Pass it back to the caller.  Allow room for the NULL terminator. */
+      else if(len > (buf_size - 1))
+      {
+        memcpy(buf, &this->console[len - (buf_size - 1)], (buf_size - 1));
+        buf[buf_size - 1] = 0;
+      }
+      else
+      {
+        memcpy(buf, this->console, len);
+        buf[len] = 0;
+      }
+    }
+  } while(0);
+
+  return retcode;
+}
+
+/* Get the running result of processing mode.  This is the operand at the top
+ * of the running operand stack, which is the value of the part of the equation
+ * that the precedence rules have allowed us to evaluate so far.  For example,
+ * after "1+2*3+" it's 7, and after "1+2*" it's 2.  If nothing has been folded
+ * yet, it's the operand at the front of the equation (i.e. the result of the
+ * previous equation), or zero.
+ *
+ * Input:
+ *   this     = A pointer to the calculator object.
+ *
+ *   buf      = The caller-supplied buffer that receives the result.
+ *
+ *   buf_size = The size of buf.
+ *
+ * Output:
+ *   true  = success.  buf contains the running result.
+ *   false = failure.  The calculator isn't in processing mode, or the equation
+ *                     so far is invalid (i.e. divide by zero).  buf contains
+ *                     an empty string.
+ */
+bool
+calculator_get_running_result(calculator *this,
+                              char       *buf,
+                              size_t      buf_size)
+{
+  bool retcode = false;
+
+  do
+  {
+    if((this == (calculator *) 0) || (buf == (char *) 0) || (buf_size == 0))  { break; }
+    buf[0] = 0;
+    if(this->processing_mode == false)                                         { break; }
+    if(calculator_run_update(this) == false)                                   { break; }
+
+    operand *result = (operand *) 0;
+    if(this->run_operands.len > 0)
+    {
+      result = this->run_operands.tokens[this->run_operands.len - 1].object;
+    }
+    else if((this->infix.len > 0) && (this->infix.tokens[0].type == LIST_OBJ_TYPE_OPERAND))
+    {
+      result = this->infix.tokens[0].object;
+    }
+
+    retcode = calculator_eval_result_to_str(result, buf, buf_size);
+  } while(0);
+
+  return retcode;
+}
+
+/* Get the counters for the calculator's object pools.  The operand pool
+ * recycles the operands of every equation: typed in, calculator_eval_str(),
+ * and calculator_program_eval().  The operator objects are
+ * shared by every equation.  Once the pools are warm, the misses stop going
+ * up.
+ *
+ * Input:
+ *   this  = A pointer to the calculator object.
+ *
+ *   stats = A pointer to a variable that receives the counters.
+ *
+ * Output:
+ *   true  = success.  *stats contains the counters.
+ *   false = failure.  *stats is undefined.
+ */
+bool
+calculator_get_pool_stats(calculator            *this,
+                          calculator_pool_stats *stats)
+{
+  bool retcode = false;
+
+  if((this != (calculator *) 0) && (stats != (calculator_pool_stats *) 0))
+  {
+    *stats  = this->pool_stats;
+    retcode = true;
+  }
+
+  return retcode;
+}
+
+/******************************************************************************
+ ********************************** TEST API **********************************
+ *****************************************************************************/
+
+#if defined(TEST)
+
+/* The multi-threaded stress test runs these equations on many calculators at
+ * the same time, and compares the results with a single-threaded run. */
+#define CALC_MT_THREADS 8
+#define CALC_MT_LOOPS   200
+
+static const char *calculator_mt_equations[] = {
+  "1+2*3",
+  "(1+2)*(3+4)+5",
+  "10/0+20*30",
+  "2^3s",
+  "3^12.345",
+  "2.34^5.678",
+  "7/3",
+  "123456789*987654321",
+  "1.5^0.5+2^0.25",
+  "(99.99-0.01)/(3.3*3.3)",
+  "2^3^2",
+  "0.1+0.2"
+};
+#define CALC_MT_EQUATIONS (sizeof(calculator_mt_equations) / sizeof(calculator_mt_equations[0]))
+
+/* The expected results.  An empty string means the equation should fail. */
+static char calculator_mt_results[CALC_MT_EQUATIONS][64];
+
+/* This is the body of each stress test thread.  It creates its own calculator
+ * and runs all of the equations over and over.  Every other thread switches
+ * to hexadecimal and back for each loop, so the threads aren't in lock step.
+ *
+ * Input:
+ *   arg = A pointer to an int.  It's the thread number on entry, and it's set
+ *         to 1 (success) or 0 (failure) on exit.
+ *
+ * Output:
+ *   Returns 0.
+ */
+static void *
+calculator_mt_thread(void *arg)
+{
+  int *result = (int *) arg;
+  int  id     = *result;
+
+  *result = 0;
+
+  calculator *this = calculator_new();
+  if(this != (calculator *) 0)
+  {
+    bool ok = true;
+    int loop;
+    for(loop = 0; (ok == true) && (loop < CALC_MT_LOOPS); loop++)
+    {
+      char buf[64];
+      if((id & 1) == 1)
+      {
+        ok = ((calculator_set_operand_type(this, operand_type_base_16) == true) &&
+              (calculator_eval_str(this, "ff*10", buf, sizeof(buf)) == true) &&
+              (strcmp(buf, "FF0") == 0) &&
+              (calculator_set_operand_type(this, operand_type_base_10) == true)) ? true : false;
+      }
+
+      size_t x;
+      for(x = 0; (ok == true) && (x < CALC_MT_EQUATIONS); x++)
+      {
+        /* Start at a different equation in each thread. */
+        size_t i = (x + id) % CALC_MT_EQUATIONS;
+        buf[0] = 0;
+        calculator_eval_str(this, calculator_mt_equations[i], buf, sizeof(buf));
+        ok = (strcmp(buf, calculator_mt_results[i]) == 0) ? true : false;
+      }
+    }
+
+    *result = (ok == true) ? 1 : 0;
+    calculator_delete(this);
+  }
+
+  return (void *) 0;
+}
+
+/* Run the multi-threaded stress test.
+ *
+ * Input:
+ *   N/A.
+ *
+ * Output:
+ *   true  = success.  Every thread got the single-threaded results.
+ *   false = failure.
+ */
+static bool
+calculator_mt_test(void)
+{
+  bool retcode = false;
+
+  calculator *this = calculator_new();
+
+  do
+  {
+    if(this == (calculator *) 0)                                         { break; }
+
+    /* Get the expected results on this thread first. */
+    size_t x;
+    for(x = 0; x < CALC_MT_EQUATIONS; x++)
+    {
+      calculator_mt_results[x][0] = 0;
+      calculator_eval_str(this, calculator_mt_equations[x], calculator_mt_results[x], sizeof(calculator_mt_results[x]));
+    }
+
+    pthread_t threads[CALC_MT_THREADS];
+    int       results[CALC_MT_THREADS];
+    int       started;
+    for(started = 0; started < CALC_MT_THREADS; started++)
+    {
+      results[started] = started;
+      if(pthread_create(&threads[started], (pthread_attr_t *) 0, calculator_mt_thread, &results[started]) != 0) { break; }
+    }
+
+    retcode = (started == CALC_MT_THREADS) ? true : false;
+    int i;
+    for(i = 0; i < started; i++)
+    {
+      pthread_join(threads[i], (void **) 0);
+      if(results[i] != 1)
+      {
+        printf("Thread %d got the wrong results.\n", i);
+        retcode = false;
+      }
+    }
+  } while(0);
+
+  calculator_delete(this);
+
+  return retcode;
+}
+
+/* Create an operand from a string, for the calculator_program tests.
+ *
+ * Input:
+ *   str = The number (i.e. "12.5").
+ *
+ * Output:
+ *   Returns a pointer to the operand.  The caller must delete it.
+ *   Returns 0 if unable to create the operand.
+ */
+static operand *
+calculator_program_test_operand(const char *str)
+{
+  operand *op = operand_new(operand_type_base_10);
+
+  while((op != (operand *) 0) && (*str != 0))
+  {
+    if(operand_add_char(op, *str++) == false)
+    {
+      operand_delete(op);
+      op = (operand *) 0;
+    }
+  }
+
+  return op;
+}
+
+/* Test calculator_compile() and friends.
+ *
+ * Input:
+ *   this = A pointer to a calculator object.  It must be in decimal mode.
+ *
+ * Output:
+ *   true  = success.
+ *   false = failure.
+ */
+static bool
+calculator_program_test(calculator *this)
+{
+  bool retcode = false;
+
+  calculator_program *prog = (calculator_program *) 0;
+  operand            *args[4] = { 0 };
+  char                buf[64];
+  size_t              num_slots, slot;
+
+  do
+  {
+    size_t x;
+    for(x = 0; x < (sizeof(args) / sizeof(args[0])); x++)
+    {
+      const char *vals[] = { "100", "0.25", "80", "0" };
+      if((args[x] = calculator_program_test_operand(vals[x])) == (operand *) 0)  { break; }
+    }
+    if(x != (sizeof(args) / sizeof(args[0])))                                     { break; }
+
+    /* Named placeholders get slots in order of first appearance.  The same
+     * program can be run over and over. */
+    printf("  $price*(1+$tax)\n");
+    if((prog = calculator_compile(this, "$price*(1+$tax)")) == (calculator_program *) 0) { break; }
+    if((calculator_program_get_num_slots(prog, &num_slots) != true) || (num_slots != 2))  { break; }
+    if((calculator_program_get_slot(prog, "price", &slot) != true) || (slot != 0))       { break; }
+    if((calculator_program_get_slot(prog, "tax", &slot) != true) || (slot != 1))         { break; }
+    if(calculator_program_get_slot(prog, "$tax", &slot) != false)                        { break; }
+    if(calculator_program_eval(this, prog, args, 2, buf, sizeof(buf)) != true)            { break; }
+    if(strcmp(buf, "125") != 0)                                                          { break; }
+    operand *args2[] = { args[2], args[1] };
+    if(calculator_program_eval(this, prog, args2, 2, buf, sizeof(buf)) != true)           { break; }
+    if(strcmp(buf, "100") != 0)                                                          { break; }
+    if(calculator_program_eval(this, prog, args, 2, buf, sizeof(buf)) != true)            { break; }
+    if(strcmp(buf, "125") != 0)                                                          { break; }
+
+    /* Not enough values. */
+    if(calculator_program_eval(this, prog, args, 1, buf, sizeof(buf)) != false)           { break; }
+    calculator_program_delete(prog);
+
+    /* Positional placeholders select their own slots, and the named ones go
+     * after them.  "$01" is the same as "$1". */
+    printf("  $x-$2*$01\n");
+    if((prog = calculator_compile(this, "$x-$2*$01")) == (calculator_program *) 0)      { break; }
+    if((calculator_program_get_num_slots(prog, &num_slots) != true) || (num_slots != 3))  { break; }
+    if((calculator_program_get_slot(prog, "x", &slot) != true) || (slot != 2))           { break; }
+    if((calculator_program_get_slot(prog, "1", &slot) != true) || (slot != 0))           { break; }
+    operand *args3[] = { args[1], args[3], args[0] };
+    if(calculator_program_eval(this, prog, args3, 3, buf, sizeof(buf)) != true)           { break; }
+    if(strcmp(buf, "100") != 0)                                                          { break; }
+    calculator_program_delete(prog);
+
+    /* Constants are folded at compile time.  The result is the same. */
+    printf("  (2+3)*4^2/$1\n");
+    if((prog = calculator_compile(this, "(2+3)*4^2/$1")) == (calculator_program *) 0)   { break; }
+    if(prog->code_len != 3)                                                              { break; }
+    if(calculator_program_eval(this, prog, &args[2], 1, buf, sizeof(buf)) != true)        { break; }
+    if(strcmp(buf, "1") != 0)                                                            { break; }
+    calculator_program_delete(prog);
+
+    /* A constant divide by zero isn't folded, so it fails every time the
+     * program is run.  So does a divide by zero in the values. */
+    printf("  $1+1/0, $1/$2\n");
+    if((prog = calculator_compile(this, "$1+1/0")) == (calculator_program *) 0)         { break; }
+    if(calculator_program_eval(this, prog, args, 1, buf, sizeof(buf)) != false)           { break; }
+    if(buf[0] != 0)                                                                      { break; }
+    calculator_program_delete(prog);
+    if((prog = calculator_compile(this, "$1/$2")) == (calculator_program *) 0)          { break; }
+    if(calculator_program_eval(this, prog, &args[2], 2, buf, sizeof(buf)) != false)       { break; }
+    calculator_program_delete(prog);
+
+    /* No placeholders, and no equation at all. */
+    printf("  2^10, (empty)\n");
+    if((prog = calculator_compile(this, "2^10")) == (calculator_program *) 0)           { break; }
+    if(calculator_program_eval(this, prog, (operand * const *) 0, 0, buf, sizeof(buf)) != true) { break; }
+    if(strcmp(buf, "1,024") != 0)                                                        { break; }
+    calculator_program_delete(prog);
+    if((prog = calculator_compile(this, "")) == (calculator_program *) 0)               { break; }
+    if(calculator_program_eval(this, prog, (operand * const *) 0, 0, buf, sizeof(buf)) != true) { break; }
+    if(strcmp(buf, "0") != 0)                                                            { break; }
+    calculator_program_delete(prog);
+    prog = (calculator_program *) 0;
+
+    /* Bad equations don't compile. */
+    printf("  Bad equations.\n");
+    const char *bad[] = { "$", "$0+1", "$257", "1 $2", "*$1", "$a $b" };
+    for(x = 0; x < (sizeof(bad) / sizeof(bad[0])); x++)
+    {
+      if((prog = calculator_compile(this, bad[x])) != (calculator_program *) 0)          { break; }
+    }
+    if(x != (sizeof(bad) / sizeof(bad[0])))
+    {
+      printf("'%s' compiled.\n", bad[x]);
+      break;
+    }
+
+    /* A program gets the same results as calculator_eval_str(). */
+    printf("  Compare with calculator_eval_str().\n");
+    if((prog = calculator_compile(this, "($1+1.5)*$1-$1/3^.5")) == (calculator_program *) 0) { break; }
+    for(x = 0; x < 100; x++)
+    {
+      char expr[64], val[16], expected[64];
+      sprintf(val, "%d.%d", (int) x, (int) (x % 7));
+      sprintf(expr, "(%s+1.5)*%s-%s/3^.5", val, val, val);
+      operand *arg = calculator_program_test_operand(val);
+      bool ok = ((arg != (operand *) 0) &&
+                 (calculator_eval_str(this, expr, expected, sizeof(expected)) == true) &&
+                 (calculator_program_eval(this, prog, &arg, 1, buf, sizeof(buf)) == true) &&
+                 (strcmp(buf, expected) == 0)) ? true : false;
+      operand_delete(arg);
+      if(ok == false)
+      {
+        printf("'%s' != '%s'.\n", buf, expr);
+        break;
+      }
+    }
+    if(x != 100)                                                                         { break; }
+
+    retcode = true;
+  } while(0);
+
+  calculator_program_delete(prog);
+  size_t x;
+  for(x = 0; x < (sizeof(args) / sizeof(args[0])); x++)
+  {
+    operand_delete(args[x]);
+  }
+
+  return retcode;
+}
+
+/* Test the console.  After each keystroke, the incrementally rendered console
+ * must match a console that's rendered from scratch.
+ *
+ * Input:
+ *   N/A.
+ *
+ * Output:
+ *   true  = success.
+ *   false = failure.
+ */
+static bool
+calculator_console_test(void)
+{
+  bool retcode = false;
+
+  calculator *this = (calculator *) 0;
+  char buf[4096], expected[4096];
+
+  /* Backspace (B), hex (H), and decimal (D) are mixed in. */
+  const char *keys[] = {
+    "12345.678*(9+10)-B/2=",
+    "*3s+1H+aB5D-7=",
+    "B(1+2",
+    "B=1",
+  };
 
-        /* We have an operand object that we can't use for this char.  Delete
-         * it.  We'll have to allocate a new object later. */
-        else
-        {
-          if(list_del_tail(this->infix_list) == false)
-          {
-            break;
-          }
-          cur_operand = (operand *) 0;
-        }
-      }
+  do
+  {
+    if((this = calculator_new()) == (calculator *) 0)                                     { break; }
 
-      /* If we didn't find an operand object, allocate one now. */
-      if(cur_operand == (operand *) 0)
+    size_t x;
+    for(x = 0; x < (sizeof(keys) / sizeof(keys[0])); x++)
+    {
+      const char *p;
+      for(p = keys[x]; *p != 0; p++)
       {
-        if((cur_operand = operand_new(this->base)) == (operand *) 0)
+        switch(*p)
         {
-          break;
+        case 'B': calculator_add_char(this, 0x08);                          break;
+        case 'H': calculator_set_operand_type(this, operand_type_base_16);  break;
+        case 'D': calculator_set_operand_type(this, operand_type_base_10);  break;
+        default:  calculator_add_char(this, *p);                            break;
         }
 
-        if((retcode = list_add_tail(this->infix_list, cur_operand, LIST_OBJ_TYPE_OPERAND)) == false)
+        bool ok = calculator_get_console(this, buf, sizeof(buf));
+        this->console_valid = 0;
+        if(calculator_get_console(this, expected, sizeof(expected)) != ok)                { break; }
+        if((ok == true) && (strcmp(buf, expected) != 0))
         {
-          operand_delete(cur_operand);
+          printf("'%s' != '%s'.\n", buf, expected);
           break;
         }
       }
-
-      /* Okay, we have the correct operand object.  Add the character. */
-      retcode = operand_add_char(cur_operand, c);
+      if(*p != 0)                                                                        { break; }
     }
+    if(x != (sizeof(keys) / sizeof(keys[0])))                                            { break; }
 
-    /* Operator. */
-    else if(operator_is_valid_operator(c) == true)
+    /* The console isn't limited in length.  A small buffer gets the end of
+     * it. */
+    calculator_add_char(this, 0x08);
+    for(x = 0; x < 500; x++)
     {
-      operator *cur_operator = operator_new(c);
-      if(cur_operator != (operator *) 0)
-      {
-        /* If the result from the previous calculation is immediately before
-         * us, and if this is an operator that doesn't require operands, then
-         * we need to throw the previous result away. */
-        if((cur_obj != (void *) 0) && (cur_obj_type == LIST_OBJ_TYPE_OPERAND) && (operand_add_char_allowed(cur_obj) == false))
-        {
-          operator_type op_type;
-          if(operator_get_op_type(cur_operator, &op_type) == false)
-          {
-            break;
-          }
+      calculator_add_char(this, '1');
+      calculator_add_char(this, '+');
+    }
+    calculator_add_char(this, '2');
+    if(calculator_get_console(this, buf, sizeof(buf)) != true)                            { break; }
+    if((strlen(buf) != 2001) || (strncmp(buf, "1 + 1 + ", 8) != 0))                      { break; }
+    if(calculator_get_console(this, buf, 8) != true)                                      { break; }
+    if(strcmp(buf, " 1 + 1 + 2" + 3) != 0)                                               { break; }
+    calculator_add_char(this, '=');
+    if(calculator_get_console(this, buf, sizeof(buf)) != true)                            { break; }
+    if(strcmp(buf, "502") != 0)                                                          { break; }
+
+    retcode = true;
+  } while(0);
 
-          if((op_type == op_type_none) && (list_del_tail(this->infix_list) == false))
-          {
-            break;
-          }
-        }
+  calculator_delete(this);
 
-        /* Check to see if there is any special processing that needs to be done
-         * on this operator. */
-        bool keep_char = true;
-        operator_special_type special_type;
-        if(operator_get_op_specialtype(cur_operator, &special_type) == false)
-        {
-          break;
-        }
-        switch(special_type)
-        {
-        case op_special_type_l_paren:
-          keep_char = calculator_add_paren(this, true);
-          break;
+  return retcode;
+}
 
-        case op_special_type_r_paren:
-          keep_char = calculator_add_paren(this, false);
-          break;
+/* Test the object pools.  Once they're warm, typing the same equations again
+ * doesn't create any objects.
+ *
+ * Input:
+ *   N/A.
+ *
+ * Output:
+ *   true  = success.
+ *   false = failure.
+ */
+static bool
+calculator_pool_test(void)
+{
+  bool retcode = false;
 
-        case op_special_type_none:
-        default:
-          break;
-        }
+  calculator *this = (calculator *) 0;
+  calculator_pool_stats warm, stats;
+  char buf[64];
 
-        if(keep_char == true)
-        {
-          if((retcode = list_add_tail(this->infix_list, cur_operator, LIST_OBJ_TYPE_OPERATOR)) == false)
-          {
-            operator_delete(cur_operator);
-          }
-        }
+  const char *keys = "12*(3+4)-5/6=\b7^2\b\b8=~\b";
+
+  do
+  {
+    if(calculator_get_pool_stats((calculator *) 0, &stats) != false)                     { break; }
+    if((this = calculator_new()) == (calculator *) 0)                                     { break; }
+    if(calculator_get_pool_stats(this, (calculator_pool_stats *) 0) != false)             { break; }
+    if(calculator_get_pool_stats(this, &stats) != true)                                   { break; }
+    if((stats.operand_hits != 0) || (stats.operand_misses != 0))                          { break; }
+
+    int loop;
+    for(loop = 0; loop < 3; loop++)
+    {
+      const char *p;
+      for(p = keys; *p != 0; p++)
+      {
+        calculator_add_char(this, *p);
+      }
+      if(calculator_eval_str(this, "1+2*(3-4)", buf, sizeof(buf)) != true)                { break; }
+      if(loop == 0)
+      {
+        if(calculator_get_pool_stats(this, &warm) != true)                                { break; }
       }
     }
+    if(loop != 3)                                                                        { break; }
+
+    if(calculator_get_pool_stats(this, &stats) != true)                                   { break; }
+    printf("  operands: %llu hits, %llu misses.\n",
+           (unsigned long long) stats.operand_hits, (unsigned long long) stats.operand_misses);
+    if((stats.operand_misses != warm.operand_misses) || (stats.operand_hits <= warm.operand_hits)) { break; }
+
+    /* Whole equations and programs use the same pool.  There are 4 operands
+     * in the equation, and the program pushes 3 of them. */
+    warm = stats;
+    if(calculator_eval_str(this, "1+2*(3-4)", buf, sizeof(buf)) != true)                  { break; }
+    if(calculator_get_pool_stats(this, &stats) != true)                                   { break; }
+    if((stats.operand_misses != warm.operand_misses) || (stats.operand_hits != (warm.operand_hits + 4))) { break; }
+
+    operand *arg = operand_new(operand_type_base_10);
+    calculator_program *prog = calculator_compile(this, "$1*2+3");
+    bool ok = ((arg != (operand *) 0) && (prog != (calculator_program *) 0) &&
+               (calculator_get_pool_stats(this, &warm) == true) &&
+               (calculator_program_eval(this, prog, &arg, 1, buf, sizeof(buf)) == true) &&
+               (calculator_get_pool_stats(this, &stats) == true)) ? true : false;
+    calculator_program_delete(prog);
+    operand_delete(arg);
+    if(ok == false)                                                                      { break; }
+    if((stats.operand_misses != warm.operand_misses) || (stats.operand_hits != (warm.operand_hits + 3))) { break; }
+
+    retcode = true;
   } while(0);
 
+  calculator_delete(this);
+
   return retcode;
 }
 
-/* This member will create an ASCII string that represents the value that
- * should be displayed by the calculator.
+/* Test processing mode.  Type an equation a piece at a time, and check the
+ * running result after each piece.
  *
  * Input:
- *   this     = A pointer to the calculator object.
- *
- *   buf      = The caller-supplied buffer that will receive the message.
- *
- *   buf_size = An int that specifies the size of buf.  This function will only
- *              place up to (buf_size - 1) characters in the buffer, allowing
- *              one byte for the NULL terminator.  If the entire string would
- *              be longer than (buf_size - 1), then the END of the string will
- *              be placed in the buffer.  This gives the illusion of a message
- *              that is scrolling horizontally.
+ *   N/A.
  *
  * Output:
- *   true  = success.  The message has been created and placed in buf.
- *   false = failure.  The contents of buf is undefined.
+ *   true  = success.
+ *   false = failure.
  */
-bool
-calculator_get_console(calculator *this,
-                       char *buf,
-                       size_t buf_size)
+static bool
+calculator_processing_test(void)
 {
   bool retcode = false;
 
-  if(this != (calculator *) 0)
+  calculator *this = (calculator *) 0;
+  char buf[64];
+
+  /* A NULL result means the equation so far is invalid.  The steps follow on
+   * from each other. */
+  typedef struct calculator_processing_step {
+    const char *keys;
+    const char *result;
+  } calculator_processing_step;
+  calculator_processing_step steps[] = {
+    { "",         "0"   }, // Empty equation.
+    { "1",        "1"   }, // The operand that's being typed.
+    { "+",        "1"   },
+    { "2",        "1"   },
+    { "*",        "2"   }, // * waits for its right operand.
+    { "3",        "2"   },
+    { "+",        "7"   }, // Now 1+2*3 is done.
+    { "4",        "7"   },
+    { "=",        "11"  }, // The result.
+    { "*2+",      "22"  }, // Follow-on to the previous result.
+    { "\b",       "11"  }, // Backspace over the +.  Start over.
+    { "-1",       "22"  },
+    { "=",        "21"  },
+    { "\b",       "0"   }, // Clear.
+    { "2^3^2+",   "512" }, // ^ is right-associative.
+    { "=\b",      "0"   },
+    { "(1+2)*(",  "3"   }, // Parentheses.
+    { "3+4)",     "7"   },
+    { "+",        "21"  },
+    { "5=",       "26"  },
+    { "\b10/0+",  0     }, // Divide by zero.
+    { "\b",       "10"  },
+    { "=",        0     },
+    { "\b",       "0"   },
+  };
+
+  do
   {
-    memset(this->console_buf, 0, sizeof(this->console_buf));
-    if((retcode = list_traverse(this->infix_list, calculator_get_console_trv_cb, this)) == true)
+    if((this = calculator_new()) == (calculator *) 0)                                     { break; }
+
+    /* It's off by default. */
+    bool enabled = true;
+    if((calculator_get_processing_mode(this, &enabled) != true) || (enabled != false))    { break; }
+    if(calculator_get_running_result(this, buf, sizeof(buf)) != false)                    { break; }
+    if(calculator_set_processing_mode(this, true) != true)                                { break; }
+    if((calculator_get_processing_mode(this, &enabled) != true) || (enabled != true))     { break; }
+
+    size_t x;
+    for(x = 0; x < (sizeof(steps) / sizeof(steps[0])); x++)
     {
-      /* If the infix_list is empty, pass a zero back to the user. */
-      if(strlen(this->console_buf) == 0)
+      const char *p;
+      for(p = steps[x].keys; *p != 0; p++)
       {
-        strncpy(buf, "0", buf_size);
+        calculator_add_char(this, *p);
       }
 
-      /* Pass it back to the caller. */
-      else if(strlen(this->console_buf) > (buf_size - 1))
-      {
-        /* Allow room for the NULL terminator. */
-        char *p = this->console_buf + (strlen(this->console_buf) - (buf_size - 1));
-        memcpy(buf, p, (buf_size - 1));
-        buf[buf_size - 1] = 0;
-      }
-      else
-      {
-        strcpy(buf, this->console_buf);
-      }
+      bool ok = calculator_get_running_result(this, buf, sizeof(buf));
+      printf("  %-10s -> %s\n", steps[x].keys, (ok == true) ? buf : "(error)");
+      if(ok != ((steps[x].result != (const char *) 0) ? true : false))                    { break; }
+      if((ok == true) && (strcmp(buf, steps[x].result) != 0))                             { break; }
     }
-  }
+    if(x != (sizeof(steps) / sizeof(steps[0])))                                          { break; }
+
+    /* Switching the base converts the running result. */
+    if(calculator_set_operand_type(this, operand_type_base_16) != true)                  { break; }
+    for(x = 0; x < 3; x++)
+    {
+      calculator_add_char(this, "a+5"[x]);
+    }
+    if(calculator_get_running_result(this, buf, sizeof(buf)) != true)                     { break; }
+    if(strcmp(buf, "A") != 0)                                                            { break; }
+    if(calculator_set_operand_type(this, operand_type_base_10) != true)                  { break; }
+    if(calculator_get_running_result(this, buf, sizeof(buf)) != true)                     { break; }
+    if(strcmp(buf, "10") != 0)                                                           { break; }
+
+    /* Turn it off. */
+    if(calculator_set_processing_mode(this, false) != true)                               { break; }
+    if(calculator_get_running_result(this, buf, sizeof(buf)) != false)                    { break; }
+
+    retcode = true;
+  } while(0);
+
+  calculator_delete(this);
 
   return retcode;
 }
 
-/******************************************************************************
- ********************************** TEST API **********************************
- *****************************************************************************/
-
-#if defined(TEST)
 bool
 calculator_test(void)
 {
@@ -926,7 +3033,12 @@ calculator_test(void)
 //    { "CALC_19", "200+()*3",        true,  true,     "600"                }, // Odd use of parentheses.
 //    { "CALC_20", "11*)",           false, false,        ""                }, // Unablanced parentheses.
     { "CALC_21", "\b7*(2+9",        true,  true,      "77"                }, // Unablanced parentheses.
+    { "CALC_23", "\b(1+2)*(3+4)+5", true, true,      "26"                }, // Back-to-back parentheses.
+    { "CALC_24", "\b2^3^2",         true,  true,     "512"                }, // ^ is right-associative.
     { "CALC_22", "\b2s^.5",        false, false,        ""                }, // Neg base, floating point exp.
+    { "CALC_25", "\b10^32767",      true,  true,       "1e+32767"         }, // Biggest exponent.
+    { "CALC_26", "\b10^32768",     false, false,        ""                }, // Exponent overflow.
+    { "CALC_27", "\b10^40000",     false, false,        ""                }, // Exponent overflow.
 
   };
   size_t calculator_test_size = (sizeof(tests) / sizeof(calculator_test));
@@ -946,17 +3058,11 @@ calculator_test(void)
     /* Traverse the infix list as decimal. */
     DBG_PRINT("calculator_get_console()\n");
     char buf[1024];
-    this->console_buf[0] = 0;
     buf[0] = 0;
     if(calculator_get_console(this, buf, sizeof(buf)) != true)                             return false;
     DBG_PRINT("infix equation: '%s'\n", buf);
 
-    if(calculator_infix2postfix(this) != true)                                             return false;
-    this->console_buf[0] = 0;
-    if(list_traverse(this->postfix_list, calculator_get_console_trv_cb, this) == false)    return false;
-    DBG_PRINT("postfix equation: '%s'\n", this->console_buf);
-
-    if(calculator_postfix(this) != t->postfix_retcode)                                     return false;
+    if(calculator_evaluate(this) != t->postfix_retcode)                                    return false;
     if(t->postfix_retcode == true)
     {
       buf[0] = 0;
@@ -966,10 +3072,355 @@ calculator_test(void)
     }
   }
 
+  /* Now run whole equations through calculator_eval_str().  Each equation
+   * stands on its own, so there is no follow-on from the previous result. */
+  calculator_test eval_tests[] = {
+    { "EVAL_01", "",                true,  true,       "0"                }, // Empty equation.
+    { "EVAL_02", "1+2*3",           true,  true,       "7"                }, // Order of operations.
+    { "EVAL_03", "10/0+20*30",     false, false,        ""                }, // Divide by zero.
+    { "EVAL_04", "2*((5+5)/2)",     true,  true,      "10"                }, // Embedded parentheses.
+    { "EVAL_05", "(1+2)*(3+4)+5",   true,  true,      "26"                }, // Back-to-back parentheses.
+    { "EVAL_06", "2^3s",            true,  true,       "0.125"            }, // int ^ -int.
+    { "EVAL_07", "3^12.345",        true,  true, "776,357.7442839795"     }, // int ^ float.
+    { "EVAL_08", "2^3^2",           true,  true,     "512"                }, // ^ is right-associative.
+    { "EVAL_09", "(10+20)*(30+40",  true,  true,   "2,100"                }, // Unbalanced parentheses.
+    { "EVAL_10", "5+(10))",         true,  true,      "15"                }, // Extra closing parentheses.
+    { "EVAL_11", " 12 + 3 * 4 ",    true,  true,      "24"                }, // Whitespace.
+    { "EVAL_12", "1 2",            false, false,        ""                }, // Whitespace separates operands.
+    { "EVAL_13", "2s^.5",          false, false,        ""                }, // Neg base, floating point exp.
+    { "EVAL_14", "*3",             false, false,        ""                }, // Missing operand.
+    { "EVAL_15", "()",              true,  true,       "0"                }, // Nothing inside parentheses.
+    { "EVAL_16", "1234567890123456+1", true, true, "1,234,567,890,123,457" }, // 16 digits fit.
+    { "EVAL_17", "100000000000000000000", false, false,  ""              }, // Too many digits.
+    { "EVAL_18", "12345678901234567890+1", false, false, ""              }, // Too many digits.
+    { "EVAL_19", "0.12345678901234567", false, false,   ""               }, // Too many digits.
+    { "EVAL_20", "00000000000000000001", true, true,   "1"               }, // Leading zeros don't count.
+    { "EVAL_21", "10^32768",       false, false,        ""                }, // Exponent overflow.
+    { "EVAL_22", "0.1^40000",      false, false,        ""                }, // Exponent underflow.
+  };
+  size_t eval_tests_size = (sizeof(eval_tests) / sizeof(calculator_test));
+
+  for(x = 0; x < eval_tests_size; x++)
+  {
+    calculator_test *t = &eval_tests[x];
+
+    printf("%s: %s\n", t->name, t->infix);
+    char buf[1024];
+    if(calculator_eval_str(this, t->infix, buf, sizeof(buf)) != t->postfix_retcode)        return false;
+    if(t->postfix_retcode == true) printf(" = '%s'\n", buf);
+    if(strcmp(buf, t->result) != 0) { printf("'%s' != '%s'.\n", buf, t->result);           return false; }
+  }
+
+  /* The console. */
+  printf("Console.\n");
+  if(calculator_console_test() != true)                                                    return false;
+
+  /* The object pools. */
+  printf("Object pools.\n");
+  if(calculator_pool_test() != true)                                                       return false;
+
+  /* Processing mode. */
+  printf("Processing mode.\n");
+  if(calculator_processing_test() != true)                                                 return false;
+
+  /* Compiled programs. */
+  printf("Compiled programs.\n");
+  if(calculator_program_test(this) != true)                                                return false;
+
+  /* A small buffer truncates the result.  Hexadecimal works too. */
+  {
+    char buf[4];
+    if(calculator_eval_str(this, "1000*1000", buf, sizeof(buf)) != true)                   return false;
+    if(strcmp(buf, "1,0") != 0)                                                            return false;
+    if(calculator_eval_str(this, "1+1", buf, 0) != false)                                  return false;
+  }
+  {
+    char buf[64];
+    if(calculator_set_operand_type(this, operand_type_base_16) != true)                     return false;
+    if(calculator_eval_str(this, "a+5", buf, sizeof(buf)) != true)                         return false;
+    if(strcmp(buf, "F") != 0)                                                              return false;
+    if(calculator_eval_str(this, "123456789abcdef01", buf, sizeof(buf)) != false)          return false;
+    if(calculator_set_operand_type(this, operand_type_base_10) != true)                     return false;
+    if(calculator_eval_str(this, "a+5", buf, sizeof(buf)) != false)                        return false;
+  }
+
   DBG_PRINT("calculator_delete(this)\n");
   if(calculator_delete(this) != true)                                                      return false;
 
+  /* Now run a lot of calculators at the same time. */
+  printf("Multi-threaded stress test: %d threads.\n", CALC_MT_THREADS);
+  if(calculator_mt_test() != true)                                                         return false;
+
   return true;
 }
 #endif // TEST
 
+/******************************************************************************
+ ********************************* BENCH API **********************************
+ *****************************************************************************/
+
+#if defined(BENCH)
+
+/* The equations that the benchmarks cycle through, and the number of times
+ * they cycle through them.  It's a mix of the things a batch job sees. */
+static const char *calculator_bench_equations[] = {
+  "1+2*3",
+  "10+20*30",
+  "2*((5+5)/2)",
+  "7.4/10",
+  "123456.789*987.654321-1000",
+  "(1+2)*3-4/5",
+  "2.34^5",
+};
+#define CALC_BENCH_EQUATIONS (sizeof(calculator_bench_equations) / sizeof(calculator_bench_equations[0]))
+#define CALC_BENCH_LOOPS     (100000 / CALC_BENCH_EQUATIONS)
+
+/* A pricing formula with a few different sets of inputs.  It's run as text
+ * through calculator_eval_str(), and compiled through calculator_compile(). */
+#define CALC_BENCH_FORMULA "$price*(1+$tax/100)*(1-$discount/100)+2.5*12"
+static const char *calculator_bench_inputs[][3] = {
+  { "19.99",   "8.25", "10" },
+  { "249",     "7",     "0" },
+  { "1234.56", "6.5",  "15" },
+  { "5",       "0",    "50" },
+};
+#define CALC_BENCH_INPUTS (sizeof(calculator_bench_inputs) / sizeof(calculator_bench_inputs[0]))
+
+bool
+calculator_bench(void)
+{
+  bool retcode = false;
+
+  calculator *this = (calculator *) 0;
+  calculator_program *prog = (calculator_program *) 0;
+  operand *args[CALC_BENCH_INPUTS][3] = { { 0 } };
+  uint64_t sink = 0;
+  int x, loop;
+
+  do
+  {
+    bench_timer timer;
+    uint64_t allocs;
+    char buf[128];
+
+    if((this = calculator_new()) == (calculator *) 0) { break; }
+
+    /* One keystroke at a time, the way ui() does it. */
+    allocs = bench_alloc_count();
+    bench_timer_start(&timer);
+    for(loop = 0; loop < CALC_BENCH_LOOPS; loop++)
+    {
+      for(x = 0; x < CALC_BENCH_EQUATIONS; x++)
+      {
+        const char *p;
+        for(p = calculator_bench_equations[x]; *p != 0; p++)
+        {
+          calculator_add_char(this, *p);
+        }
+        calculator_add_char(this, '=');
+        calculator_get_console(this, buf, sizeof(buf));
+        calculator_add_char(this, 0x08);
+        sink += buf[0];
+      }
+    }
+    bench_report("calculator_add_char()", &timer, (uint64_t) CALC_BENCH_LOOPS * CALC_BENCH_EQUATIONS, "equations");
+    bench_report_allocs("calculator_add_char()", (bench_alloc_count() - allocs), (uint64_t) CALC_BENCH_LOOPS * CALC_BENCH_EQUATIONS, "equation");
+
+    /* Tokens through the keystroke path.  A long equation exercises the infix
+     * and postfix token storage more than the short ones do. */
+    char long_eq[2048];
+    size_t len = 0, tokens = 0;
+    for(x = 0; x < 100; x++)
+    {
+      len += sprintf(&long_eq[len], "%s(%d.5+%d)", (x == 0) ? "" : ((x & 1) ? "*" : "-"), x, (x % 7) + 1);
+    }
+    for(x = 0; x < CALC_BENCH_EQUATIONS; x++)
+    {
+      if(calculator_eval_tokenize(this, calculator_bench_equations[x], (calculator_program *) 0) != true) { break; }
+      tokens += this->eval.len;
+    }
+    if(calculator_eval_tokenize(this, long_eq, (calculator_program *) 0) != true) { break; }
+    size_t long_tokens = this->eval.len;
+    tokens += long_tokens;
+    calculator_eval_release(this);
+    allocs = bench_alloc_count();
+    bench_timer_start(&timer);
+    for(loop = 0; loop < (CALC_BENCH_LOOPS / 10); loop++)
+    {
+      for(x = 0; x <= CALC_BENCH_EQUATIONS; x++)
+      {
+        const char *p;
+        for(p = (x < CALC_BENCH_EQUATIONS) ? calculator_bench_equations[x] : long_eq; *p != 0; p++)
+        {
+          calculator_add_char(this, *p);
+        }
+        calculator_add_char(this, '=');
+        calculator_get_console(this, buf, sizeof(buf));
+        calculator_add_char(this, 0x08);
+        sink += buf[0];
+      }
+    }
+    bench_report("calculator_add_char() tokens", &timer, (uint64_t) (CALC_BENCH_LOOPS / 10) * tokens, "tokens");
+    bench_report_allocs("calculator_add_char() tokens", (bench_alloc_count() - allocs), (uint64_t) (CALC_BENCH_LOOPS / 10) * tokens, "token");
+    calculator_pool_stats stats;
+    if(calculator_get_pool_stats(this, &stats) != true) { break; }
+    printf("  %-40s %14llu hits, %llu misses.\n", "operand pool",
+           (unsigned long long) stats.operand_hits, (unsigned long long) stats.operand_misses);
+
+    /* The heap memory that a long equation holds on a cold calculator (the
+     * pools are empty, so every operand has to be created). */
+    calculator *cold;
+    uint64_t bytes = bench_alloc_bytes();
+    allocs         = bench_alloc_count();
+    if((cold = calculator_new()) == (calculator *) 0) { break; }
+    for(x = 0; long_eq[x] != 0; x++)
+    {
+      calculator_add_char(cold, long_eq[x]);
+    }
+    bench_report_allocs("long equation, cold calculator", (bench_alloc_count() - allocs), long_tokens, "token");
+    bench_report_bytes("long equation, cold calculator", (bench_alloc_bytes() - bytes), long_tokens, "token");
+    calculator_delete(cold);
+
+    /* The console after every keystroke, the way ui() does it.  The equation
+     * is kept short enough to fit the old fixed-size console buffer. */
+    char console_eq[512];
+    size_t console_len = 0;
+    for(x = 0; x < 40; x++)
+    {
+      console_len += sprintf(&console_eq[console_len], "%s(%d.5+%d)", (x == 0) ? "" : ((x & 1) ? "*" : "-"), x, (x % 7) + 1);
+    }
+    bench_timer_start(&timer);
+    for(loop = 0; loop < (CALC_BENCH_LOOPS / 100); loop++)
+    {
+      const char *p;
+      for(p = console_eq; *p != 0; p++)
+      {
+        calculator_add_char(this, *p);
+        calculator_get_console(this, buf, sizeof(buf));
+        sink += buf[0];
+      }
+      calculator_add_char(this, '=');
+      calculator_add_char(this, 0x08);
+    }
+    bench_report("calculator_get_console() per keystroke", &timer, (uint64_t) (CALC_BENCH_LOOPS / 100) * console_len, "keystrokes");
+
+    /* Processing mode, with the running result after each operator.  Compare
+     * it with the naive way, which evaluates the whole equation so far each
+     * time. */
+    const char *p;
+    if(calculator_set_processing_mode(this, true) != true) { break; }
+    bench_timer_start(&timer);
+    for(loop = 0; loop < (CALC_BENCH_LOOPS / 100); loop++)
+    {
+      for(p = long_eq; *p != 0; p++)
+      {
+        calculator_add_char(this, *p);
+        if(operator_is_valid_operator(*p) == true)
+        {
+          calculator_get_running_result(this, buf, sizeof(buf));
+          sink += buf[0];
+        }
+      }
+      calculator_add_char(this, '=');
+      calculator_add_char(this, 0x08);
+    }
+    bench_report("processing mode (incremental)", &timer, (uint64_t) (CALC_BENCH_LOOPS / 100) * long_tokens, "tokens");
+    if(calculator_set_processing_mode(this, false) != true) { break; }
+    bench_timer_start(&timer);
+    for(loop = 0; loop < (CALC_BENCH_LOOPS / 1000); loop++)
+    {
+      char prefix[sizeof(long_eq)];
+      for(p = long_eq; *p != 0; p++)
+      {
+        if(operator_is_valid_operator(*p) == true)
+        {
+          memcpy(prefix, long_eq, (p - long_eq));
+          prefix[p - long_eq] = 0;
+          calculator_eval_str(this, prefix, buf, sizeof(buf));
+          sink += buf[0];
+        }
+      }
+    }
+    bench_report("processing mode (re-evaluate)", &timer, (uint64_t) (CALC_BENCH_LOOPS / 1000) * long_tokens, "tokens");
+
+    /* The whole equation at once. */
+    allocs = bench_alloc_count();
+    bench_timer_start(&timer);
+    for(loop = 0; loop < CALC_BENCH_LOOPS; loop++)
+    {
+      for(x = 0; x < CALC_BENCH_EQUATIONS; x++)
+      {
+        if(calculator_eval_str(this, calculator_bench_equations[x], buf, sizeof(buf)) != true) { break; }
+        sink += buf[0];
+      }
+    }
+    bench_report("calculator_eval_str()", &timer, (uint64_t) CALC_BENCH_LOOPS * CALC_BENCH_EQUATIONS, "equations");
+    bench_report_allocs("calculator_eval_str()", (bench_alloc_count() - allocs), (uint64_t) CALC_BENCH_LOOPS * CALC_BENCH_EQUATIONS, "equation");
+
+    /* The pricing formula, as text. */
+    char exprs[CALC_BENCH_INPUTS][128];
+    for(x = 0; x < CALC_BENCH_INPUTS; x++)
+    {
+      sprintf(exprs[x], "%s*(1+%s/100)*(1-%s/100)+2.5*12",
+              calculator_bench_inputs[x][0], calculator_bench_inputs[x][1], calculator_bench_inputs[x][2]);
+    }
+    allocs = bench_alloc_count();
+    bench_timer_start(&timer);
+    for(loop = 0; loop < (100000 / CALC_BENCH_INPUTS); loop++)
+    {
+      for(x = 0; x < CALC_BENCH_INPUTS; x++)
+      {
+        if(calculator_eval_str(this, exprs[x], buf, sizeof(buf)) != true) { break; }
+        sink += buf[0];
+      }
+    }
+    bench_report("formula (eval_str)", &timer, (uint64_t) (100000 / CALC_BENCH_INPUTS) * CALC_BENCH_INPUTS, "equations");
+    bench_report_allocs("formula (eval_str)", (bench_alloc_count() - allocs), (uint64_t) (100000 / CALC_BENCH_INPUTS) * CALC_BENCH_INPUTS, "equation");
+
+    /* The pricing formula, compiled once. */
+    if((prog = calculator_compile(this, CALC_BENCH_FORMULA)) == (calculator_program *) 0) { break; }
+    int y;
+    for(x = 0; x < CALC_BENCH_INPUTS; x++)
+    {
+      for(y = 0; y < 3; y++)
+      {
+        const char *p;
+        if((args[x][y] = operand_new(operand_type_base_10)) == (operand *) 0) { break; }
+        for(p = calculator_bench_inputs[x][y]; *p != 0; p++)
+        {
+          operand_add_char(args[x][y], *p);
+        }
+      }
+    }
+    allocs = bench_alloc_count();
+    bench_timer_start(&timer);
+    for(loop = 0; loop < (100000 / CALC_BENCH_INPUTS); loop++)
+    {
+      for(x = 0; x < CALC_BENCH_INPUTS; x++)
+      {
+        if(calculator_program_eval(this, prog, args[x], 3, buf, sizeof(buf)) != true) { break; }
+        sink += buf[0];
+      }
+    }
+    bench_report("formula (program)", &timer, (uint64_t) (100000 / CALC_BENCH_INPUTS) * CALC_BENCH_INPUTS, "equations");
+    bench_report_allocs("formula (program)", (bench_alloc_count() - allocs), (uint64_t) (100000 / CALC_BENCH_INPUTS) * CALC_BENCH_INPUTS, "equation");
+
+    printf("  (checksum 0x%llX)\n", (unsigned long long) sink);
+    retcode = true;
+  } while(0);
+
+  calculator_program_delete(prog);
+  for(x = 0; x < CALC_BENCH_INPUTS; x++)
+  {
+    int y;
+    for(y = 0; y < 3; y++)
+    {
+      operand_delete(args[x][y]);
+    }
+  }
+  calculator_delete(this);
+
+  return retcode;
+}
+
+#endif // BENCH
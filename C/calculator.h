@@ -6,12 +6,25 @@
 #ifndef __CALCULATOR_H__
 #define __CALCULATOR_H__
 
+#include <stdint.h>
+
 #include "operand.h"
 
 /****************************** CLASS DEFINITION ******************************/
 
 typedef struct calculator calculator;
 
+/* A compiled equation.  Refer to calculator_compile(). */
+typedef struct calculator_program calculator_program;
+
+/* The counters for the calculator's operand pool.  A hit is an operand that
+ * was reused.  A miss is an operand that had to be created.  Refer to
+ * calculator_get_pool_stats(). */
+typedef struct calculator_pool_stats {
+  uint64_t operand_hits;
+  uint64_t operand_misses;
+} calculator_pool_stats;
+
 /********************************* PUBLIC API *********************************/
 
 calculator *calculator_new(void);
@@ -22,10 +35,30 @@ bool calculator_get_operand_type(calculator *this, operand_type *cur_base);
 
 bool calculator_set_operand_type(calculator *this, operand_type  new_base);
 
+bool calculator_get_processing_mode(calculator *this, bool *enabled);
+
+bool calculator_set_processing_mode(calculator *this, bool  enabled);
+
 bool calculator_add_char(calculator *this, char c);
 
 bool calculator_get_console(calculator *this, char *buf, size_t buf_size);
 
+bool calculator_get_running_result(calculator *this, char *buf, size_t buf_size);
+
+bool calculator_get_pool_stats(calculator *this, calculator_pool_stats *stats);
+
+bool calculator_eval_str(calculator *this, const char *expr, char *out, size_t out_size);
+
+calculator_program *calculator_compile(calculator *this, const char *expr);
+
+bool calculator_program_delete(calculator_program *prog);
+
+bool calculator_program_get_num_slots(const calculator_program *prog, size_t *num_slots);
+
+bool calculator_program_get_slot(const calculator_program *prog, const char *name, size_t *index);
+
+bool calculator_program_eval(calculator *this, const calculator_program *prog, operand * const *args, size_t num_args, char *out, size_t out_size);
+
 /********************************** TEST API **********************************/
 
 #if defined(TEST)
@@ -34,4 +67,12 @@ bool calculator_test(void);
 
 #endif // TEST
 
+/********************************* BENCH API **********************************/
+
+#if defined(BENCH)
+
+bool calculator_bench(void);
+
+#endif // BENCH
+
 #endif // __CALCULATOR_H__
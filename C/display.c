@@ -0,0 +1,561 @@
+/* A simple class that draws a one-line display on a terminal.
+ *
+ * The display remembers the last frame that it drew (and where it left the
+ * cursor).  When it's given a new frame, it finds the cells that changed,
+ * moves the cursor to them, rewrites only those cells, and puts the cursor
+ * back.  The whole update goes out in a single write().  That keeps the
+ * number of bytes per keystroke small, which matters when the terminal is at
+ * the other end of a slow link (i.e. ssh).
+ *
+ * The cursor is moved with backspaces, ANSI "cursor forward/back" sequences,
+ * or by rewriting cells that haven't changed, whichever is shortest.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common.h"
+
+#include "bench.h"
+#include "calculator.h"
+#include "display.h"
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ *****************************************************************************/
+
+/* The widest frame that we can draw.  Wider frames are truncated. */
+#define DISPLAY_MAX_WIDTH 256
+
+/* This is the display class. */
+struct display {
+  int fd;
+
+  /* What's on the screen right now, and where the cursor is.  If valid is
+   * false, we don't know what's on the screen, so the next update redraws
+   * the whole line. */
+  char   screen[DISPLAY_MAX_WIDTH];
+  size_t screen_len;
+  size_t cursor;
+  bool   valid;
+
+  /* The bytes for the update that's being built.  A full redraw is the worst
+   * case: "\r", the frame, and a cursor move. */
+  char   out[(DISPLAY_MAX_WIDTH * 2) + 16];
+  size_t out_len;
+
+  /* The number of write() calls, and the number of bytes written.  The test
+   * and bench code check them. */
+  uint64_t num_writes;
+  uint64_t num_bytes;
+};
+
+/******************************************************************************
+ ******************************** PRIVATE API *********************************
+ *****************************************************************************/
+
+/* Add bytes to the update that's being built.
+ *
+ * Input:
+ *   this = A pointer to the display object.
+ *
+ *   src  = The bytes.
+ *
+ *   len  = The number of bytes.
+ *
+ * Output:
+ *   N/A.
+ */
+static void
+display_put(display    *this,
+            const char *src,
+            size_t      len)
+{
+  memcpy(&this->out[this->out_len], src, len);
+  this->out_len += len;
+}
+
+/* Add the shortest sequence that moves the cursor from one cell to another.
+ * Moving right can rewrite the cells in between, so they must already
+ * contain (or be about to contain) what's in the new frame.  Moving left can
+ * also go to the start of the line first, and then move right.
+ *
+ * Input:
+ *   this  = A pointer to the display object.
+ *
+ *   frame = The new frame (padded to the width of the screen).
+ *
+ *   from  = The cell that the cursor is on.
+ *
+ *   to    = The cell that the cursor needs to be on.
+ *
+ * Output:
+ *   N/A.
+ */
+static void
+display_move(display    *this,
+             const char *frame,
+             size_t      from,
+             size_t      to)
+{
+  char   csi[16];
+  char   home[16];
+  size_t n         = (to > from) ? (to - from) : (from - to);
+  size_t csi_len   = snprintf(csi,  sizeof(csi),  "\033[%zu%c", n, (to > from) ? 'C' : 'D');
+  size_t home_len  = snprintf(home, sizeof(home), "\r\033[%zuC", to);
+  size_t home_cost = (to <= (home_len - 1)) ? (1 + to) : home_len;
+
+  if(to > from)
+  {
+    if(n <= csi_len) { display_put(this, &frame[from], n); }
+    else             { display_put(this, csi, csi_len);    }
+  }
+  else if(to < from)
+  {
+    if((n <= csi_len) && (n <= home_cost))
+    {
+      memset(&this->out[this->out_len], '\b', n);
+      this->out_len += n;
+    }
+    else if(csi_len <= home_cost)
+    {
+      display_put(this, csi, csi_len);
+    }
+    else if(home_cost == (1 + to))
+    {
+      display_put(this, "\r", 1);
+      display_put(this, frame, to);
+    }
+    else
+    {
+      display_put(this, home, home_len);
+    }
+  }
+}
+
+/* Write the update that's been built.
+ *
+ * Input:
+ *   this = A pointer to the display object.
+ *
+ * Output:
+ *   true  = success.  The update has been written (or there wasn't one).
+ *   false = failure.  The screen is in an unknown state.
+ */
+static bool
+display_flush(display *this)
+{
+  bool   retcode = true;
+  size_t done    = 0;
+
+  while((retcode == true) && (done < this->out_len))
+  {
+    ssize_t n = write(this->fd, &this->out[done], this->out_len - done);
+    if(n > 0)
+    {
+      done += n;
+    }
+    else if((n < 0) && (errno == EINTR))
+    {
+      continue;
+    }
+
+    /* An error, or a write() that made no progress. */
+    else
+    {
+      retcode = false;
+    }
+  }
+
+  if(this->out_len > 0)
+  {
+    this->num_writes++;
+    this->num_bytes += done;
+  }
+  this->out_len = 0;
+
+  return retcode;
+}
+
+/******************************************************************************
+ ********************************* PUBLIC API *********************************
+ *****************************************************************************/
+
+/* Create a new display object.  This object can be used to access the
+ * display class.
+ *
+ * Input:
+ *   fd = The file descriptor of the terminal.  The object doesn't own it.
+ *
+ * Output:
+ *   Returns a pointer to the object.
+ *   Returns 0 if unable to create the object.
+ */
+display *
+display_new(int fd)
+{
+  display *this = (fd >= 0) ? malloc(sizeof(*this)) : (display *) 0;
+
+  if(this != (display *) 0)
+  {
+    memset(this, 0, sizeof(*this));
+    this->fd = fd;
+  }
+
+  return this;
+}
+
+/* Delete a display object that was created by display_new().
+ *
+ * Input:
+ *   this = A pointer to the display object.
+ *
+ * Output:
+ *   true  = success.  this is deleted.
+ *   false = failure.  this is undefined.
+ */
+bool
+display_delete(display *this)
+{
+  bool retcode = false;
+
+  if(this != (display *) 0)
+  {
+    free(this);
+    retcode = true;
+  }
+
+  return retcode;
+}
+
+/* Draw a frame.  Only the cells that are different from the last frame are
+ * written.  If the new frame is shorter than the last one, the extra cells
+ * are blanked.
+ *
+ * Input:
+ *   this   = A pointer to the display object.
+ *
+ *   frame  = The text to display.  It must only contain printable characters.
+ *
+ *   cursor = The cell to leave the cursor on when we're done.
+ *
+ * Output:
+ *   true  = success.  The frame is on the screen.
+ *   false = failure.  The screen is in an unknown state.  The next update
+ *                     redraws the whole line.
+ */
+bool
+display_update(display    *this,
+               const char *frame,
+               size_t      cursor)
+{
+  bool retcode = false;
+
+  if((this != (display *) 0) && (frame != (const char *) 0))
+  {
+    /* Pad the new frame with spaces out to the width of what's on the screen,
+     * so the cells that the last frame used get blanked. */
+    char   cells[DISPLAY_MAX_WIDTH];
+    size_t len   = strnlen(frame, DISPLAY_MAX_WIDTH);
+    size_t width = ((this->valid == true) && (this->screen_len > len)) ? this->screen_len : len;
+    memcpy(cells, frame, len);
+    memset(&cells[len], ' ', width - len);
+    cursor = (cursor > width) ? width : cursor;
+
+    if(this->valid == false)
+    {
+      /* Redraw the whole line. */
+      display_put(this, "\r", 1);
+      display_put(this, cells, width);
+      display_move(this, cells, width, cursor);
+    }
+    else
+    {
+      /* Find the first and last cells that changed. */
+      size_t first, last;
+      for(first = 0; (first < width) && (cells[first] == this->screen[first]); first++);
+      if(first == width)
+      {
+        display_move(this, cells, this->cursor, cursor);
+      }
+      else
+      {
+        for(last = width - 1; cells[last] == this->screen[last]; last--);
+        display_move(this, cells, this->cursor, first);
+        display_put(this, &cells[first], (last - first) + 1);
+        display_move(this, cells, (last + 1), cursor);
+      }
+    }
+
+    memcpy(this->screen, cells, width);
+    this->screen_len = width;
+    this->cursor     = cursor;
+    this->valid      = retcode = display_flush(this);
+  }
+
+  return retcode;
+}
+
+/* Forget what's on the screen.  Call this after something else has written
+ * to the terminal (i.e. a help message).  The next update redraws the whole
+ * line.
+ *
+ * Input:
+ *   this = A pointer to the display object.
+ *
+ * Output:
+ *   true  = success.
+ *   false = failure.
+ */
+bool
+display_invalidate(display *this)
+{
+  bool retcode = false;
+
+  if(this != (display *) 0)
+  {
+    this->valid = false;
+    retcode     = true;
+  }
+
+  return retcode;
+}
+
+/******************************************************************************
+ ********************************** TEST API **********************************
+ *****************************************************************************/
+
+#if defined(TEST)
+
+/* A tiny terminal.  It understands the bytes that the display class sends. */
+typedef struct display_test_term {
+  char   screen[DISPLAY_MAX_WIDTH + 1];
+  size_t cursor;
+} display_test_term;
+
+/* Feed bytes to the test terminal.
+ *
+ * Input:
+ *   term = A pointer to the test terminal.
+ *
+ *   src  = The bytes.
+ *
+ *   len  = The number of bytes.
+ *
+ * Output:
+ *   true  = success.  The terminal understood all of the bytes.
+ *   false = failure.  There was a byte that the display shouldn't send.
+ */
+static bool
+display_test_term_feed(display_test_term *term,
+                       const char        *src,
+                       size_t             len)
+{
+  bool   retcode = true;
+  size_t i;
+
+  for(i = 0; (retcode == true) && (i < len); i++)
+  {
+    if(src[i] == '\r')
+    {
+      term->cursor = 0;
+    }
+    else if(src[i] == '\b')
+    {
+      retcode = (term->cursor > 0) ? true : false;
+      term->cursor--;
+    }
+    else if((src[i] == '\033') && ((i + 1) < len) && (src[i + 1] == '['))
+    {
+      size_t n = 0;
+      for(i += 2; (i < len) && (src[i] >= '0') && (src[i] <= '9'); i++)
+      {
+        n = (n * 10) + (src[i] - '0');
+      }
+      if((i < len) && (src[i] == 'C'))                          { term->cursor += n; }
+      else if((i < len) && (src[i] == 'D') && (term->cursor >= n)) { term->cursor -= n; }
+      else                                                       { retcode = false; }
+    }
+    else if((src[i] >= ' ') && (src[i] <= '~') && (term->cursor < DISPLAY_MAX_WIDTH))
+    {
+      term->screen[term->cursor++] = src[i];
+    }
+    else
+    {
+      retcode = false;
+    }
+  }
+
+  return retcode;
+}
+
+bool
+display_test(void)
+{
+  bool retcode = false;
+
+  display *this = (display *) 0;
+  int fds[2] = { -1, -1 };
+
+  display_test_term term;
+  memset(term.screen, ' ', sizeof(term.screen));
+  term.screen[DISPLAY_MAX_WIDTH] = 0;
+  term.cursor = 0;
+
+  /* The frames, and the most bytes that each one should take. */
+  typedef struct display_test_frame {
+    const char *frame;
+    size_t      cursor;
+    size_t      max_bytes;
+  } display_test_frame;
+  display_test_frame frames[] = {
+    { "-- dec -->                              0<--", 40, 49 }, // Full redraw.
+    { "-- dec -->                              0<--", 40,  0 }, // No change.
+    { "-- dec -->                              1<--", 40,  3 }, // 1 cell.
+    { "-- dec -->                             12<--", 40,  5 },
+    { "-- dec -->                            12+<--", 40,  6 },
+    { "-- hex -->                            12+<--", 40, 12 }, // Far away.
+    { "-- hex -->                            12+<--",  0,  6 }, // Cursor only.
+    { "-- hex -->                            12+<--", 40, 10 },
+    { "-- hex -->         12+<--",                    21, 35 }, // Shorter.
+    { "-- hex -->                            12+<--", 40, 31 }, // Longer.
+  };
+  size_t num_frames = (sizeof(frames) / sizeof(frames[0]));
+
+  do
+  {
+    /* Bad parameters. */
+    if(display_new(-1) != (display *) 0)                                      { break; }
+    if(display_update((display *) 0, "x", 0) != false)                       { break; }
+    if(display_invalidate((display *) 0) != false)                           { break; }
+
+    if(pipe(fds) != 0)                                                        { break; }
+    if((this = display_new(fds[1])) == (display *) 0)                        { break; }
+    if(display_update(this, (const char *) 0, 0) != false)                   { break; }
+
+    /* Draw the frames, and check what the terminal shows after each one. */
+    size_t x;
+    for(x = 0; x < num_frames; x++)
+    {
+      display_test_frame *f = &frames[x];
+      uint64_t bytes = this->num_bytes;
+      uint64_t writes = this->num_writes;
+      if(display_update(this, f->frame, f->cursor) != true)                  { break; }
+      bytes  = this->num_bytes - bytes;
+      writes = this->num_writes - writes;
+      printf("  frame %zu: %llu bytes, %llu writes.\n", x, (unsigned long long) bytes, (unsigned long long) writes);
+      if((bytes > f->max_bytes) || (writes != ((bytes > 0) ? 1 : 0)))      { break; }
+
+      char buf[sizeof(this->out)];
+      if((bytes > 0) && (read(fds[0], buf, bytes) != bytes))                 { break; }
+      if(display_test_term_feed(&term, buf, bytes) != true)                  { break; }
+
+      /* The frame is on the screen, followed by blanks. */
+      size_t len = strlen(f->frame);
+      if(memcmp(term.screen, f->frame, len) != 0)                             { break; }
+      if(strspn(&term.screen[len], " ") != (DISPLAY_MAX_WIDTH - len))       { break; }
+      if(term.cursor != f->cursor)                                           { break; }
+    }
+    if(x != num_frames)                                                       { break; }
+
+    /* After invalidate, the whole line is redrawn. */
+    uint64_t bytes = this->num_bytes;
+    if(display_invalidate(this) != true)                                      { break; }
+    if(display_update(this, frames[0].frame, 40) != true)                    { break; }
+    if((this->num_bytes - bytes) != (1 + strlen(frames[0].frame) + 4))       { break; }
+
+    retcode = true;
+  } while(0);
+
+  display_delete(this);
+  if(fds[0] >= 0)
+  {
+    close(fds[0]);
+  }
+  if(fds[1] >= 0)
+  {
+    close(fds[1]);
+  }
+
+  return retcode;
+}
+
+#endif // TEST
+
+/******************************************************************************
+ ********************************* BENCH API **********************************
+ *****************************************************************************/
+
+#if defined(BENCH)
+
+/* Type equations into a calculator, and draw the display after every
+ * keystroke the way ui() does.  Count the bytes that a full redraw sends, and
+ * the bytes that the display class sends. */
+bool
+display_bench(void)
+{
+  bool retcode = false;
+
+  const char *equations[] = {
+    "123456.789*987.654321-1000=",
+    "(1+2)*3-4/5=",
+    "2.34^5=",
+    "12.5+12.5+12.5+12.5+12.5+12.5+12.5+12.5+12.5=",
+  };
+  const int loops = 10000;
+
+  int         dsp  = open("/dev/null", O_WRONLY);
+  display    *this = (dsp >= 0) ? display_new(dsp) : (display *) 0;
+  calculator *calc = calculator_new();
+
+  do
+  {
+    if((this == (display *) 0) || (calc == (calculator *) 0)) { break; }
+
+    bench_timer timer;
+    uint64_t    frames     = 0;
+    uint64_t    full_bytes = 0;
+    bench_timer_start(&timer);
+    int loop;
+    for(loop = 0; loop < loops; loop++)
+    {
+      size_t x;
+      for(x = 0; x < (sizeof(equations) / sizeof(equations[0])); x++)
+      {
+        const char *p;
+        for(p = equations[x]; *p != 0; p++)
+        {
+          char console[32];
+          char frame[sizeof(console) + 32];
+          calculator_add_char(calc, *p);
+          calculator_get_console(calc, console, sizeof(console));
+          int len = snprintf(frame, sizeof(frame), "-- dec -->%31s<--", console);
+
+          /* The old way was "\r", the frame, and 4 backspaces. */
+          full_bytes += 1 + len + 4;
+          display_update(this, frame, len - 4);
+          frames++;
+        }
+      }
+    }
+    bench_report("display_update()", &timer, frames, "frames");
+    printf("  %-40s %14.1f bytes/frame.\n", "full redraw",   ((double) full_bytes / frames));
+    printf("  %-40s %14.1f bytes/frame.\n", "display_update()", ((double) this->num_bytes / frames));
+
+    retcode = true;
+  } while(0);
+
+  calculator_delete(calc);
+  display_delete(this);
+  if(dsp >= 0)
+  {
+    close(dsp);
+  }
+
+  return retcode;
+}
+
+#endif // BENCH
@@ -0,0 +1,37 @@
+/* A simple class that draws a one-line display on a terminal.  It remembers
+ * what's on the screen, so each update only sends the cells that changed.
+ */
+#ifndef __DISPLAY_H__
+#define __DISPLAY_H__
+
+/****************************** CLASS DEFINITION ******************************/
+
+typedef struct display display;
+
+/********************************* PUBLIC API *********************************/
+
+display *display_new(int fd);
+
+bool display_delete(display *this);
+
+bool display_update(display *this, const char *frame, size_t cursor);
+
+bool display_invalidate(display *this);
+
+/********************************** TEST API **********************************/
+
+#if defined(TEST)
+
+bool display_test(void);
+
+#endif // TEST
+
+/********************************* BENCH API **********************************/
+
+#if defined(BENCH)
+
+bool display_bench(void);
+
+#endif // BENCH
+
+#endif // __DISPLAY_H__
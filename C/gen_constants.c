@@ -0,0 +1,329 @@
+/* This is a build-time program that generates operand_base_10_constants.h.
+ * That file holds the read-only constant tables that the decimal engine uses
+ * in its hot paths (small integers, reciprocals, ln(2), etc.), so that those
+ * values don't have to be built with operand_base_10_import() and
+ * operand_base_10_op_div() every time they're needed.
+ *
+ * The values are computed here with a simple fixed-point decimal number
+ * (nothing more than add, and multiply or divide by a small integer), and then
+ * rounded to BCD_NUM_DIGITS_INTERNAL digits and packed into significand
+ * sections.  The layout comes from operand_base_10.h, so the tables follow any
+ * change to the size of the significand.
+ *
+ * Usage:  gen_constants > operand_base_10_constants.h
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+#include "operand_base_10.h"
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ *****************************************************************************/
+
+/* A fixed-point decimal number.  The first GEN_INT_DIGITS digits are the
+ * integer part, and the rest are the fraction.  There are plenty of guard
+ * digits beyond what the significand can hold. */
+#define GEN_INT_DIGITS 8
+#define GEN_DIGITS     (GEN_INT_DIGITS + BCD_NUM_DIGITS_INTERNAL + 24)
+
+typedef struct { uint8_t d[GEN_DIGITS]; } gen_fixed;
+
+/******************************************************************************
+ ******************************** PRIMITIVES **********************************
+ *****************************************************************************/
+
+/* Set a fixed-point number to an integer. */
+static void
+gen_fixed_set(gen_fixed *this,
+              uint32_t   value)
+{
+  int i;
+  memset(this, 0, sizeof(*this));
+  for(i = GEN_INT_DIGITS - 1; i >= 0; i--)
+  {
+    this->d[i] = value % 10;
+    value /= 10;
+  }
+}
+
+/* Check to see if a fixed-point number is zero. */
+static bool
+gen_fixed_is_zero(const gen_fixed *this)
+{
+  int i;
+  for(i = 0; i < GEN_DIGITS; i++)
+  {
+    if(this->d[i] != 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* this = this + that. */
+static void
+gen_fixed_add(gen_fixed       *this,
+              const gen_fixed *that)
+{
+  int i, carry = 0;
+  for(i = GEN_DIGITS - 1; i >= 0; i--)
+  {
+    int sum = this->d[i] + that->d[i] + carry;
+    carry = (sum >= 10);
+    this->d[i] = sum - (carry * 10);
+  }
+}
+
+/* this = this / divisor. */
+static void
+gen_fixed_div(gen_fixed *this,
+              uint32_t   divisor)
+{
+  int i;
+  uint64_t rem = 0;
+  for(i = 0; i < GEN_DIGITS; i++)
+  {
+    rem = (rem * 10) + this->d[i];
+    this->d[i] = (uint8_t) (rem / divisor);
+    rem %= divisor;
+  }
+}
+
+/* this = this * multiplier. */
+static void
+gen_fixed_mul(gen_fixed *this,
+              uint32_t   multiplier)
+{
+  int i;
+  uint64_t carry = 0;
+  for(i = GEN_DIGITS - 1; i >= 0; i--)
+  {
+    uint64_t product = ((uint64_t) this->d[i] * multiplier) + carry;
+    this->d[i] = (uint8_t) (product % 10);
+    carry = product / 10;
+  }
+}
+
+/* Calculate ln(2) with the series:
+ *   ln(2) = sum(k >= 1) of 1 / (k * 2^k). */
+static void
+gen_fixed_ln2(gen_fixed *this)
+{
+  gen_fixed power, term;
+  uint32_t k;
+
+  gen_fixed_set(this, 0);
+  gen_fixed_set(&power, 1);
+  for(k = 1; ; k++)
+  {
+    gen_fixed_div(&power, 2);
+    if(gen_fixed_is_zero(&power) == true)
+    {
+      break;
+    }
+    term = power;
+    gen_fixed_div(&term, k);
+    gen_fixed_add(this, &term);
+  }
+}
+
+/* Calculate ln(10) = (3 * ln(2)) + ln(1.25), where:
+ *   ln(1.25) = 2 * atanh(1/9) = 2 * sum(k >= 0) of 1 / ((2k + 1) * 9^(2k + 1)). */
+static void
+gen_fixed_ln10(gen_fixed *this)
+{
+  gen_fixed ln2, power, term, sum;
+  uint32_t k;
+
+  gen_fixed_set(&sum, 0);
+  gen_fixed_set(&power, 1);
+  gen_fixed_div(&power, 9);
+  for(k = 1; gen_fixed_is_zero(&power) == false; k += 2)
+  {
+    term = power;
+    gen_fixed_div(&term, k);
+    gen_fixed_add(&sum, &term);
+    gen_fixed_div(&power, 81);
+  }
+  gen_fixed_mul(&sum, 2);
+
+  gen_fixed_ln2(&ln2);
+  gen_fixed_mul(&ln2, 3);
+
+  *this = ln2;
+  gen_fixed_add(this, &sum);
+}
+
+/******************************************************************************
+ ********************************** OUTPUT ************************************
+ *****************************************************************************/
+
+/* Print a fixed-point number as an operand_base_10 initializer.  The number is
+ * normalized (the first digit of the significand isn't zero) and rounded to
+ * BCD_NUM_DIGITS_INTERNAL digits.
+ *
+ * Input:
+ *   this    = A pointer to the fixed-point number.
+ *
+ *   end     = The punctuation that ends the initializer (i.e. "," or ";").
+ *
+ *   comment = A comment to put after the initializer.
+ *
+ * Output:
+ *   N/A.
+ */
+static void
+gen_print_operand(const gen_fixed *this,
+                  const char      *end,
+                  const char      *comment)
+{
+  uint8_t digits[BCD_NUM_DIGITS_INTERNAL] = { 0 };
+  int16_t exponent = 0;
+
+  /* Find the first significant digit.  Zero is all zeroes with exponent 0. */
+  int first;
+  for(first = 0; (first < GEN_DIGITS) && (this->d[first] == 0); first++);
+
+  if(first < GEN_DIGITS)
+  {
+    exponent = (GEN_INT_DIGITS - 1) - first;
+
+    int i;
+    for(i = 0; (i < BCD_NUM_DIGITS_INTERNAL) && ((first + i) < GEN_DIGITS); i++)
+    {
+      digits[i] = this->d[first + i];
+    }
+
+    /* Round half up.  If it carries all the way out, the result is 1000... */
+    if(((first + i) < GEN_DIGITS) && (this->d[first + i] >= 5))
+    {
+      for(i = BCD_NUM_DIGITS_INTERNAL - 1; i >= 0; i--)
+      {
+        if(++digits[i] < 10)
+        {
+          break;
+        }
+        digits[i] = 0;
+      }
+      if(i < 0)
+      {
+        digits[0] = 1;
+        exponent++;
+      }
+    }
+  }
+
+  printf("  { .significand = { .s = {");
+  int section;
+  for(section = 0; section < SIGNIFICAND_SECTIONS_INTERNAL; section++)
+  {
+    uint64_t value = 0;
+    int digit;
+    for(digit = 0; digit < SIGNIFICAND_DIGITS_PER_SECTION; digit++)
+    {
+      value = (value << 4) | digits[(section * SIGNIFICAND_DIGITS_PER_SECTION) + digit];
+    }
+    printf(" 0x%0*llX,", (int) SIGNIFICAND_DIGITS_PER_SECTION, (unsigned long long) value);
+  }
+  printf(" } }, .exponent = %6d }%s // %s\n", exponent, end, comment);
+}
+
+/* Print a table of integers (0 - max). */
+static void
+gen_print_integers(int max)
+{
+  int n;
+  printf("const operand_base_10 operand_base_10_integers[%d] = {\n", max + 1);
+  for(n = 0; n <= max; n++)
+  {
+    char comment[32];
+    gen_fixed value;
+
+    gen_fixed_set(&value, n);
+    snprintf(comment, sizeof(comment), "%d", n);
+    gen_print_operand(&value, ",", comment);
+  }
+  printf("};\n\n");
+}
+
+/* Print a table of reciprocals (1/n, for 0 - max).  Entry 0 is 0. */
+static void
+gen_print_reciprocals(int max)
+{
+  int n;
+  printf("const operand_base_10 operand_base_10_reciprocals[%d] = {\n", max + 1);
+  for(n = 0; n <= max; n++)
+  {
+    char comment[32];
+    gen_fixed value;
+
+    gen_fixed_set(&value, (n == 0) ? 0 : 1);
+    if(n != 0)
+    {
+      gen_fixed_div(&value, n);
+    }
+
+    snprintf(comment, sizeof(comment), "1/%d", n);
+    gen_print_operand(&value, ",", comment);
+  }
+  printf("};\n\n");
+}
+
+/* Print a table of 64-bit powers of 10 (10^0 - 10^19). */
+static void
+gen_print_pow10(void)
+{
+  int n;
+  uint64_t value = 1;
+  printf("static const uint64_t operand_base_10_pow10[20] = {\n");
+  for(n = 0; n < 20; n++)
+  {
+    printf("  %lluull,\n", (unsigned long long) value);
+    value *= 10;
+  }
+  printf("};\n\n");
+}
+
+/******************************************************************************
+ ************************************ MAIN ************************************
+ *****************************************************************************/
+
+int
+main(int argc, char **argv)
+{
+  gen_fixed value;
+
+  printf("/* Generated by gen_constants.c.  DO NOT EDIT. */\n\n");
+
+  printf("/* Powers of 10 for converting between int64_t and BCD. */\n");
+  gen_print_pow10();
+
+  printf("/* n, for 0 <= n <= OPERAND_BASE_10_MAX_INTEGER. */\n");
+  gen_print_integers(OPERAND_BASE_10_MAX_INTEGER);
+
+  printf("/* 1/n, for 1 <= n <= OPERAND_BASE_10_MAX_RECIPROCAL.  Entry 0 is 0. */\n");
+  gen_print_reciprocals(OPERAND_BASE_10_MAX_RECIPROCAL);
+
+  printf("/* Other constants. */\n");
+  printf("const operand_base_10 operand_base_10_ln2 =\n");
+  gen_fixed_ln2(&value);
+  gen_print_operand(&value, ";", "ln(2)");
+
+  printf("const operand_base_10 operand_base_10_ln10 =\n");
+  gen_fixed_ln10(&value);
+  gen_print_operand(&value, ";", "ln(10)");
+
+  printf("const operand_base_10 operand_base_10_three_halves =\n");
+  gen_fixed_set(&value, 3);
+  gen_fixed_div(&value, 2);
+  gen_print_operand(&value, ";", "1.5");
+
+  return 0;
+}
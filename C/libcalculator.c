@@ -0,0 +1,309 @@
+/* This is the embedding API for the calculator engine.  It's what
+ * libcalculator.a and libcalculator.so export.  Refer to libcalculator.h.
+ *
+ * It's a thin layer over the calculator class.  Each libcalculator object owns
+ * one calculator object, and libcalculator_eval() is calculator_eval_str(), so
+ * a program that links with the library evaluates equations at the same speed
+ * as the calculator's own batch mode, without starting a process.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+#include "calculator.h"
+#include "libcalculator.h"
+#include "operand.h"
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ *****************************************************************************/
+
+/* This is the libcalculator class. */
+struct libcalculator {
+  calculator *calc;
+};
+
+/* The number of libcalculator_init() calls that haven't been matched by a
+ * libcalculator_fini() call.  Objects can only be created while it's > 0. */
+static int libcalculator_init_count = 0;
+
+/******************************************************************************
+ ********************************* PUBLIC API *********************************
+ *****************************************************************************/
+
+/* Get the version of the library.  A program can compare it to the version in
+ * the header that it was compiled with.
+ *
+ * Input:
+ *   N/A.
+ *
+ * Output:
+ *   Returns ((LIBCALCULATOR_VERSION_MAJOR << 16) | LIBCALCULATOR_VERSION_MINOR).
+ */
+int
+libcalculator_version(void)
+{
+  return (LIBCALCULATOR_VERSION_MAJOR << 16) | LIBCALCULATOR_VERSION_MINOR;
+}
+
+/* Initialize the library.  This must be called before any libcalculator
+ * objects are created.  It can be called more than once (i.e. by separate
+ * parts of a program), and from any thread, as long as each call is matched
+ * by a call to libcalculator_fini().
+ *
+ * Input:
+ *   N/A.
+ *
+ * Output:
+ *   1 = success.
+ *   0 = failure.  The library can't be used.
+ */
+int
+libcalculator_init(void)
+{
+  int retcode = 0;
+
+  if(operand_initialize() == true)
+  {
+    __atomic_add_fetch(&libcalculator_init_count, 1, __ATOMIC_SEQ_CST);
+    retcode = 1;
+  }
+
+  return retcode;
+}
+
+/* Shut down the library.  Each call matches one call to libcalculator_init().
+ * All of the libcalculator objects must be deleted before the last call.
+ *
+ * Input:
+ *   N/A.
+ *
+ * Output:
+ *   1 = success.
+ *   0 = failure.  The library wasn't initialized.
+ */
+int
+libcalculator_fini(void)
+{
+  int retcode = 0;
+
+  int count = __atomic_load_n(&libcalculator_init_count, __ATOMIC_SEQ_CST);
+  while(count > 0)
+  {
+    if(__atomic_compare_exchange_n(&libcalculator_init_count, &count, (count - 1), false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+    {
+      retcode = 1;
+      break;
+    }
+  }
+
+  return retcode;
+}
+
+/* Create a new libcalculator object.  It starts in base 10.
+ *
+ * Input:
+ *   N/A.
+ *
+ * Output:
+ *   Returns a pointer to the object.
+ *   Returns 0 if unable to create the object (or if the library isn't
+ *   initialized).
+ */
+libcalculator *
+libcalculator_new(void)
+{
+  libcalculator *this = (libcalculator *) 0;
+
+  if(__atomic_load_n(&libcalculator_init_count, __ATOMIC_SEQ_CST) > 0)
+  {
+    this = malloc(sizeof(*this));
+    if(this != (libcalculator *) 0)
+    {
+      if((this->calc = calculator_new()) == (calculator *) 0)
+      {
+        free(this);
+        this = (libcalculator *) 0;
+      }
+    }
+  }
+
+  return this;
+}
+
+/* Delete a libcalculator object that was created by libcalculator_new().
+ *
+ * Input:
+ *   this = A pointer to the libcalculator object.
+ *
+ * Output:
+ *   1 = success.  this is deleted.
+ *   0 = failure.  this is undefined.
+ */
+int
+libcalculator_delete(libcalculator *this)
+{
+  int retcode = 0;
+
+  if(this != (libcalculator *) 0)
+  {
+    calculator_delete(this->calc);
+    free(this);
+    retcode = 1;
+  }
+
+  return retcode;
+}
+
+/* Set the number base for the equations that are evaluated after this.
+ *
+ * Input:
+ *   this = A pointer to the libcalculator object.
+ *
+ *   base = LIBCALCULATOR_BASE_10 or LIBCALCULATOR_BASE_16.
+ *
+ * Output:
+ *   1 = success.
+ *   0 = failure.  The base is unchanged.
+ */
+int
+libcalculator_set_base(libcalculator *this,
+                       int            base)
+{
+  int retcode = 0;
+
+  if(this != (libcalculator *) 0)
+  {
+    switch(base)
+    {
+    case LIBCALCULATOR_BASE_10:
+      retcode = (calculator_set_operand_type(this->calc, operand_type_base_10) == true) ? 1 : 0;
+      break;
+
+    case LIBCALCULATOR_BASE_16:
+      retcode = (calculator_set_operand_type(this->calc, operand_type_base_16) == true) ? 1 : 0;
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  return retcode;
+}
+
+/* Evaluate an equation, and return the result as a string.
+ *
+ * Input:
+ *   this     = A pointer to the libcalculator object.
+ *
+ *   expr     = The equation (i.e. "(1+2)*3").  It's NULL terminated.
+ *
+ *   out      = The buffer to write the result to.
+ *
+ *   out_size = The size of out.
+ *
+ * Output:
+ *   1 = success.  out contains the result.
+ *   0 = failure.  The equation can't be evaluated (i.e. a syntax error or a
+ *                 divide by zero), or out is too small.
+ */
+int
+libcalculator_eval(libcalculator *this,
+                   const char    *expr,
+                   char          *out,
+                   size_t         out_size)
+{
+  int retcode = 0;
+
+  /* The engine truncates a result that doesn't fit, so it writes to a buffer
+   * that's big enough for any result (the same size that batch mode uses),
+   * and we check the size here. */
+  char result[1024];
+
+  if((this != (libcalculator *) 0) && (out != (char *) 0) && (out_size > 0))
+  {
+    out[0] = 0;
+    if(calculator_eval_str(this->calc, expr, result, sizeof(result)) == true)
+    {
+      size_t len = strlen(result);
+      if(len < out_size)
+      {
+        memcpy(out, result, len + 1);
+        retcode = 1;
+      }
+    }
+  }
+
+  return retcode;
+}
+
+/******************************************************************************
+ ********************************** TEST API **********************************
+ *****************************************************************************/
+
+#if defined(TEST)
+
+bool
+libcalculator_test(void)
+{
+  bool retcode = false;
+
+  libcalculator *this = (libcalculator *) 0;
+  char           result[128];
+
+  /* The test program has already initialized the library once. */
+  int count = libcalculator_init_count;
+
+  do
+  {
+    /* Bad parameters. */
+    if(libcalculator_delete((libcalculator *) 0) != 0)                        { break; }
+    if(libcalculator_set_base((libcalculator *) 0, 10) != 0)                  { break; }
+    if(libcalculator_eval((libcalculator *) 0, "1", result, sizeof(result)) != 0) { break; }
+
+    if(libcalculator_version() != ((LIBCALCULATOR_VERSION_MAJOR << 16) | LIBCALCULATOR_VERSION_MINOR)) { break; }
+
+    /* Objects can't be created until the library is initialized. */
+    libcalculator_init_count = 0;
+    if(libcalculator_fini() != 0)                                             { break; }
+    if(libcalculator_new() != (libcalculator *) 0)                            { break; }
+    if(libcalculator_init() != 1)                                             { break; }
+    if(libcalculator_init() != 1)                                             { break; }
+    if(libcalculator_fini() != 1)                                             { break; }
+    if((this = libcalculator_new()) == (libcalculator *) 0)                   { break; }
+
+    /* Equations. */
+    if(libcalculator_eval(this, "(1+2)*3", result, sizeof(result)) != 1)      { break; }
+    if(strcmp(result, "9") != 0)                                              { break; }
+    if(libcalculator_eval(this, "1/0", result, sizeof(result)) != 0)          { break; }
+    if(libcalculator_eval(this, "2.5*4", result, sizeof(result)) != 1)        { break; }
+    if(strcmp(result, "10") != 0)                                             { break; }
+    if(libcalculator_eval(this, "123456789*1000", result, 4) != 0)            { break; }
+
+    /* Number bases. */
+    if(libcalculator_set_base(this, 8) != 0)                                  { break; }
+    if(libcalculator_set_base(this, LIBCALCULATOR_BASE_16) != 1)              { break; }
+    if(libcalculator_eval(this, "FF+1", result, sizeof(result)) != 1)         { break; }
+    printf("  FF+1 = %s (hex).\n", result);
+    if(strcmp(result, "100") != 0)                                            { break; }
+    if(libcalculator_set_base(this, LIBCALCULATOR_BASE_10) != 1)              { break; }
+    if(libcalculator_eval(this, "FF+1", result, sizeof(result)) != 0)         { break; }
+
+    if(libcalculator_delete(this) != 1)                                       { break; }
+    this = (libcalculator *) 0;
+    if(libcalculator_fini() != 1)                                             { break; }
+    if(libcalculator_fini() != 0)                                             { break; }
+
+    retcode = true;
+  } while(0);
+
+  libcalculator_delete(this);
+  libcalculator_init_count = count;
+
+  return retcode;
+}
+
+#endif // TEST
@@ -0,0 +1,75 @@
+/* This is the public header file for libcalculator.a and libcalculator.so.
+ * It's the only header that a program needs in order to use the calculator
+ * engine in-process.
+ *
+ * It doesn't include any of the engine's own headers, and it doesn't use the
+ * engine's bool type, so it can be used along with <stdbool.h> (or from C++).
+ * The functions that succeed or fail return 1 for success and 0 for failure.
+ *
+ * Usage:
+ *
+ *   libcalculator_init();
+ *   libcalculator *calc = libcalculator_new();
+ *   char result[128];
+ *   if(libcalculator_eval(calc, "(1+2)*3", result, sizeof(result)) == 1) ...
+ *   libcalculator_delete(calc);
+ *   libcalculator_fini();
+ *
+ * A libcalculator object isn't meant to be shared between threads, but
+ * separate objects can be used on separate threads at the same time.
+ */
+#ifndef __LIBCALCULATOR_H__
+#define __LIBCALCULATOR_H__
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The version of this API.  It changes when a function is added, and the
+ * major number changes if an existing function changes. */
+#define LIBCALCULATOR_VERSION_MAJOR 1
+#define LIBCALCULATOR_VERSION_MINOR 0
+
+/* The shared library only exports the functions that are marked with this. */
+#define LIBCALCULATOR_API __attribute__((visibility("default")))
+
+/****************************** CLASS DEFINITION ******************************/
+
+typedef struct libcalculator libcalculator;
+
+/* The number bases.  These are the values for libcalculator_set_base(). */
+#define LIBCALCULATOR_BASE_10 10
+#define LIBCALCULATOR_BASE_16 16
+
+/********************************* PUBLIC API *********************************/
+
+LIBCALCULATOR_API int libcalculator_version(void);
+
+LIBCALCULATOR_API int libcalculator_init(void);
+
+LIBCALCULATOR_API int libcalculator_fini(void);
+
+LIBCALCULATOR_API libcalculator *libcalculator_new(void);
+
+LIBCALCULATOR_API int libcalculator_delete(libcalculator *calc);
+
+LIBCALCULATOR_API int libcalculator_set_base(libcalculator *calc, int base);
+
+LIBCALCULATOR_API int libcalculator_eval(libcalculator *calc, const char *expr, char *out, size_t out_size);
+
+/********************************** TEST API **********************************/
+
+/* Only for the calculator's own test program (which includes common.h). */
+#if defined(TEST) && defined(__COMMON_H__)
+
+bool libcalculator_test(void);
+
+#endif // TEST
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LIBCALCULATOR_H__
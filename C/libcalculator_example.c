@@ -0,0 +1,134 @@
+/* An example program that uses the calculator engine through libcalculator.a
+ * (or libcalculator.so).  It only includes libcalculator.h, the way a program
+ * outside of this tree would.
+ *
+ * It measures how many equations per second one thread can evaluate
+ * in-process, and compares that to starting a process per equation (which is
+ * what a service that shells out to "calculator" pays).
+ *
+ *   make lib example
+ *   ./libcalculator_example
+ */
+#include <spawn.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+
+#include "libcalculator.h"
+
+extern char **environ;
+
+/* Get the current time in seconds. */
+static double
+example_now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ts.tv_sec + (ts.tv_nsec / 1000000000.0);
+}
+
+/* Evaluate an equation over and over for about half a second, and report the
+ * calls per second.
+ *
+ * Input:
+ *   calc = A pointer to the libcalculator object.
+ *
+ *   expr = The equation.
+ *
+ * Output:
+ *   true  = success.
+ *   false = failure.  The equation can't be evaluated.
+ */
+static bool
+example_bench(libcalculator *calc,
+              const char    *expr)
+{
+  char     result[128];
+  uint64_t calls = 0;
+  double   start = example_now(), elapsed;
+
+  do
+  {
+    int x;
+    for(x = 0; x < 1000; x++)
+    {
+      if(libcalculator_eval(calc, expr, result, sizeof(result)) != 1)
+      {
+        return false;
+      }
+    }
+    calls += 1000;
+  } while((elapsed = (example_now() - start)) < 0.5);
+
+  printf("  %-40s = %-24s %10.0f calls/sec (%.0f ns/call).\n", expr, result,
+         (calls / elapsed), ((elapsed * 1000000000.0) / calls));
+
+  return true;
+}
+
+int
+main(int argc, char **argv)
+{
+  int retcode = 1;
+
+  const char *equations[] = {
+    "1+2",
+    "(1+2)*3",
+    "123456.789*987.654321-1000",
+    "((1.5+2.25)*(3.125-0.0625))/7",
+    "2^10+2^20+2^30",
+  };
+
+  if(libcalculator_init() != 1)
+  {
+    fprintf(stderr, "libcalculator_init() failed.\n");
+    return retcode;
+  }
+  printf("libcalculator %d.%d\n", (libcalculator_version() >> 16), (libcalculator_version() & 0xFFFF));
+
+  libcalculator *calc = libcalculator_new();
+  if(calc != (libcalculator *) 0)
+  {
+    printf("In-process:\n");
+    size_t x;
+    for(x = 0; x < (sizeof(equations) / sizeof(equations[0])); x++)
+    {
+      if(example_bench(calc, equations[x]) == false)
+      {
+        fprintf(stderr, "\"%s\" failed.\n", equations[x]);
+        break;
+      }
+    }
+    retcode = (x == (sizeof(equations) / sizeof(equations[0]))) ? 0 : 1;
+    libcalculator_delete(calc);
+  }
+
+  /* For comparison, the cheapest process that a service could start per
+   * equation. */
+  printf("One process per call:\n");
+  double start = example_now();
+  int    x;
+  for(x = 0; x < 200; x++)
+  {
+    pid_t pid;
+    char *args[] = { "/bin/true", (char *) 0 };
+    int   status;
+    if(posix_spawn(&pid, args[0], (posix_spawn_file_actions_t *) 0, (posix_spawnattr_t *) 0, args, environ) != 0)
+    {
+      break;
+    }
+    waitpid(pid, &status, 0);
+  }
+  double elapsed = example_now() - start;
+  printf("  %-40s   %-24s %10.0f calls/sec (%.0f ns/call).\n", "spawn /bin/true", "", (x / elapsed),
+         ((elapsed * 1000000000.0) / x));
+
+  libcalculator_fini();
+
+  return retcode;
+}
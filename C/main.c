@@ -1,27 +1,137 @@
-/* This is the main entrypoint for the calculator UI and test program.
+/* This is the main entrypoint for the calculator UI, test program,
+ * and benchmark program.
  */
 
+#include <signal.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #include "common.h"
-#include "operand.h"
+#include "batch.h"
+#include "bench.h"
+#include "libcalculator.h"
+#include "server.h"
 #include "test.h"
 #include "ui.h"
 
+#if !defined(TEST) && !defined(BENCH)
+/* The server that's running (if any).  SIGINT and SIGTERM stop it cleanly, so
+ * the Unix domain socket is removed. */
+static server *main_server = (server *) 0;
+
+static void
+main_stop_server(int sig)
+{
+  server_stop(main_server);
+}
+#endif
+
 int main(int argc, char **argv)
 {
   int retcode = 1;
 
-  /* One-time initialization of the operand class.  It needs to do some init
-   * in order to be able to access all of the classes that manager our data
-   * base types (i.e. base_10 (bcd.c) and base_16 (hex.c)). */
-  if(operand_initialize() == true)
+  /* Initialize the calculator engine (the same way a program that links with
+   * libcalculator does), and shut it down on the way out. */
+  if(libcalculator_init() == 1)
   {
-#ifdef TEST
+#if defined(TEST)
     retcode = test();
+#elif defined(BENCH)
+    retcode = bench();
 #else
-    retcode = ui();
+    /* Batch mode reads equations from stdin, one per line, and writes the
+     * results to stdout.  It's the default when stdin isn't a terminal (i.e.
+     * a file or a pipe), and "-b" forces it.  "-j N" runs it on N threads
+     * (0 = one per CPU).  "-s PATH" and "-t PORT" run it as a server on a
+     * Unix domain socket and/or a loopback TCP port. */
+    bool        use_batch   = (isatty(STDIN_FILENO) == 0) ? true : false;
+    bool        bad_args    = false;
+    int         num_threads = -1;
+    const char *server_path = (const char *) 0;
+    int         server_port = -1;
+    int         i;
+    for(i = 1; (bad_args == false) && (i < argc); i++)
+    {
+      if(strcmp(argv[i], "-b") == 0)
+      {
+        use_batch = true;
+      }
+      else if((strcmp(argv[i], "-j") == 0) && ((i + 1) < argc))
+      {
+        char *end;
+        long n = strtol(argv[++i], &end, 10);
+        bad_args    = ((*end != 0) || (n < 0) || (n > 1024)) ? true : false;
+        num_threads = (int) n;
+        use_batch   = true;
+      }
+      else if((strcmp(argv[i], "-s") == 0) && ((i + 1) < argc))
+      {
+        server_path = argv[++i];
+      }
+      else if((strcmp(argv[i], "-t") == 0) && ((i + 1) < argc))
+      {
+        char *end;
+        long n = strtol(argv[++i], &end, 10);
+        bad_args    = ((*end != 0) || (n < 0) || (n > 65535)) ? true : false;
+        server_port = (int) n;
+      }
+      else
+      {
+        bad_args = true;
+      }
+    }
+
+    if(bad_args == true)
+    {
+      fprintf(stderr, "Usage: %s [-b] [-j N] [-s PATH] [-t PORT]\n"
+                      "  -b      = Batch mode.  Evaluate the equations on stdin (one per line).\n"
+                      "  -j N    = Batch mode on N threads (0 = one per CPU).\n"
+                      "  -s PATH = Server mode.  Listen on a Unix domain socket.\n"
+                      "  -t PORT = Server mode.  Listen on a loopback TCP port (0 = any).\n",
+                      argv[0]);
+    }
+    else if((server_path != (const char *) 0) || (server_port >= 0))
+    {
+      if((main_server = server_new(server_path, server_port)) != (server *) 0)
+      {
+        int port;
+        if(server_get_tcp_port(main_server, &port) == true)
+        {
+          fprintf(stderr, "Listening on 127.0.0.1:%d.\n", port);
+        }
+        signal(SIGINT,  main_stop_server);
+        signal(SIGTERM, main_stop_server);
+        signal(SIGPIPE, SIG_IGN);
+        retcode = (server_run(main_server) == true) ? 0 : 1;
+
+        /* The handlers must not see the server once it's gone. */
+        signal(SIGINT,  SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+        server_delete(main_server);
+        main_server = (server *) 0;
+      }
+      else
+      {
+        perror("server");
+      }
+    }
+    else if(num_threads >= 0)
+    {
+      retcode = (batch_parallel(STDIN_FILENO, STDOUT_FILENO, num_threads) == true) ? 0 : 1;
+    }
+    else if(use_batch == true)
+    {
+      retcode = (batch(STDIN_FILENO, STDOUT_FILENO) == true) ? 0 : 1;
+    }
+    else
+    {
+      retcode = ui();
+    }
 #endif
+
+    libcalculator_fini();
   }
 
   return retcode;
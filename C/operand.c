@@ -17,20 +17,20 @@
  ****************************** CLASS DEFINITION ******************************
  *****************************************************************************/
 
-/* This is the operand class. */
+/* This is the operand class.  The whole object (including the number) is a
+ * single allocation. */
 struct operand {
 
-  /* This is the number when we're running in decimal mode. */
-  operand_base_10 *decnum;
-
-  /* This is the number when we're running in hexadecimal mode. */
-  operand_base_16 *hexnum;
-
-  /* This is a pointer to the number that we're currently using.  It points to
-   * either this->decnum or this->hexnum.  This allows all of the op functions
-   * below to run without having to think about which number base we're using.
-   */
-  void *current_num;
+  /* This is the number.  Only one base is active at a time, so the decimal
+   * and hexadecimal representations share the same storage.  this->base says
+   * which one is valid.  When operand_set_base() switches bases, the number is
+   * converted into the other representation.  Both members start at the same
+   * address, so the op functions below can pass &this->num to either class
+   * without having to think about which number base we're using. */
+  union {
+    operand_base_10 decnum;
+    operand_base_16 hexnum;
+  } num;
 
   /* The number base we're currently configured to use.  This refers to things
    * like base_10 or base_16. */
@@ -48,8 +48,12 @@ struct operand {
 
 /* This is a jump table (indexed via an operand_type value) that defines all of
  * the operations that each data type (base_10, base_16, etc) supports.  If a
- * data type doesn't support an operation, then its pointer will be zero. */
-operand_api *ops[operand_type_base_max] = { 0 };
+ * data type doesn't support an operation, then its pointer will be zero.  It's
+ * filled in at compile time, so it's safe to use from any thread. */
+static const operand_api * const ops[operand_type_base_max] = {
+  [operand_type_base_10] = &operand_base_10_ops,
+  [operand_type_base_16] = &operand_base_16_ops
+};
 
 /* This is the standard processing for a binary operation.  It is called from
  * all of the add, sub, mul, etc. functions below.
@@ -76,7 +80,7 @@ operand_api *ops[operand_type_base_max] = { 0 };
     operand_api_binary_op func = ops[base]->op_##op; \
     if(func != (operand_api_binary_op) 0) \
     { \
-      retcode = func(op1->current_num, op2->current_num); \
+      retcode = func(&op1->num, &op2->num); \
     } \
     op1->add_char_allowed = op2->add_char_allowed = false; \
   }
@@ -104,7 +108,7 @@ operand_api *ops[operand_type_base_max] = { 0 };
     operand_api_unary_op func = ops[base]->op_##op; \
     if(func != (operand_api_unary_op) 0) \
     { \
-      retcode = func(op1->current_num); \
+      retcode = func(&op1->num); \
     } \
     op1->add_char_allowed = false; \
   }
@@ -317,6 +321,10 @@ operand_op_not(operand *this)
  * deleting, or modifying operand objects.  It has to do with giving the operand
  * class an opportunity to initialize some private data.
  *
+ * The jump table is built at compile time now, so all this does is make sure
+ * it agrees with the data type classes.  It doesn't modify anything, so it's
+ * safe to call more than once, and from any thread.
+ *
  * Input:
  *   N/A.
  *
@@ -330,8 +338,8 @@ operand_initialize(void)
 {
   bool retcode = false;
 
-  if(((ops[operand_type_base_10] = operand_base_10_return_ops()) != (operand_api *) 0) &&
-     ((ops[operand_type_base_16] = operand_base_16_return_ops()) != (operand_api *) 0))
+  if((ops[operand_type_base_10] == operand_base_10_return_ops()) &&
+     (ops[operand_type_base_16] == operand_base_16_return_ops()))
   {
     retcode = true;
   }
@@ -356,12 +364,7 @@ operand_new(operand_type base)
 
   if(this != (operand *) 0)
   {
-    memset(this, 0, sizeof(*this));
-    this->add_char_allowed = true;
-
-    if( ((this->decnum = operand_base_10_new()) == (operand_base_10 *) 0) ||
-        ((this->hexnum = operand_base_16_new()) == (operand_base_16 *) 0) ||
-        (operand_set_base(this, operand_type_base_10) == false) )
+    if(operand_reset(this, base) == false)
     {
       operand_delete(this);
       this = (operand *) 0;
@@ -387,10 +390,8 @@ operand_delete(operand *this)
 
   if(this != (operand *) 0)
   {
-    retcode = operand_base_10_delete(this->decnum);
-    retcode = operand_base_16_delete(this->hexnum);
-
     free(this);
+    retcode = true;
   }
 
   return retcode;
@@ -426,7 +427,8 @@ operand_get_base(operand *this,
   return retcode;
 }
 
-/* Set the number base that the operand should use.
+/* Set the number base that the operand should use.  The number is converted
+ * to the new base.
  *
  * Input:
  *   this = A pointer to the operand object.
@@ -445,29 +447,34 @@ operand_set_base(operand *this,
 
   if(this != (operand *) 0)
   {
-    DBG_PRINT("%s(): this->base %s: base %s.\n", __func__, 
-              ops[this->base]->base_name, ops[base]->base_name);
-    if(this->base != base)
+    DBG_PRINT("%s(): this->base %s: base %s.\n", __func__,
+              (ops[this->base] != (operand_api *) 0) ? ops[this->base]->base_name : "NONE",
+              (ops[base]       != (operand_api *) 0) ? ops[base]->base_name       : "NONE");
+    if(this->base == base)
     {
+      retcode = true;
+    }
+    else
+    {
+      /* Both representations live in the same storage, so export the number
+       * before the new representation overwrites it. */
       int64_t new_num;
 
       switch(base)
       {
       case operand_type_base_10:
-        this->base = base;
-        this->current_num = this->decnum;
-        if(operand_base_16_export(this->hexnum, &new_num) == true)
+        if(operand_base_16_export(&this->num.hexnum, &new_num) == true)
         {
-          retcode = operand_base_10_import(this->decnum, new_num);
+          this->base = base;
+          retcode = operand_base_10_import(&this->num.decnum, new_num);
         }
         break;
       
       case operand_type_base_16:
-        this->base = base;
-        this->current_num = this->hexnum;
-        if(operand_base_10_export(this->decnum, &new_num) == true)
+        if(operand_base_10_export(&this->num.decnum, &new_num) == true)
         {
-          retcode = operand_base_16_import(this->hexnum, new_num);
+          this->base = base;
+          retcode = operand_base_16_import(&this->num.hexnum, new_num);
         }
         break;
 
@@ -481,6 +488,94 @@ operand_set_base(operand *this,
   return retcode;
 }
 
+/* Reset an operand object so that it can be reused for a new number.  The
+ * object is set to zero, it's configured for the specified base, and it will
+ * accept input via operand_add_char() again.  This is the same as deleting the
+ * object and creating a new one with operand_new(), without the heap traffic.
+ *
+ * Input:
+ *   this = A pointer to the operand object.
+ *
+ *   base = The number base to use.
+ *
+ * Output:
+ *   true  = success.  The operand is zero, and is ready for input.
+ *   false = failure.  The state of the operand is undefined.
+ */
+bool
+operand_reset(operand      *this,
+              operand_type  base)
+{
+  bool retcode = false;
+
+  if(this != (operand *) 0)
+  {
+    switch(base)
+    {
+    case operand_type_base_10:
+      retcode = operand_base_10_init(&this->num.decnum);
+      break;
+
+    case operand_type_base_16:
+      retcode = operand_base_16_init(&this->num.hexnum);
+      break;
+
+    default:
+      break;
+    }
+
+    if(retcode == true)
+    {
+      this->base             = base;
+      this->add_char_allowed = true;
+    }
+  }
+
+  return retcode;
+}
+
+/* Make a copy of an operand object.  dst is switched to the base that src is
+ * using, and it gets a copy of the number.  Like the result of a math
+ * operation, the copy doesn't accept operand_add_char().
+ *
+ * Input:
+ *   src = A pointer to the operand object to copy.
+ *
+ *   dst = A pointer to the operand object that we will copy into.
+ *
+ * Output:
+ *   true  = success.  src has been copied to dst.
+ *   false = failure.  The contents of dst is undefined.
+ */
+bool
+operand_copy(const operand *src,
+             operand       *dst)
+{
+  bool retcode = false;
+
+  if( (src != (operand *) 0) && (dst != (operand *) 0) )
+  {
+    switch(src->base)
+    {
+    case operand_type_base_10:
+      retcode = operand_base_10_copy(&src->num.decnum, &dst->num.decnum);
+      break;
+
+    case operand_type_base_16:
+      retcode = operand_base_16_copy(&src->num.hexnum, &dst->num.hexnum);
+      break;
+
+    default:
+      break;
+    }
+
+    dst->base             = src->base;
+    dst->add_char_allowed = false;
+  }
+
+  return retcode;
+}
+
 /* Check to see if the specified character is a valid operand character that
  * can be passed to operand_add_char().
  *
@@ -542,6 +637,44 @@ operand_add_char_allowed(operand *this)
   return retcode;
 }
 
+/* Check to see if operand_add_char() would silently drop a digit because the
+ * operand is already full.
+ *
+ * Input:
+ *   this = A pointer to the operand object.
+ *
+ *   c    = The char that is about to be added.
+ *
+ * Output:
+ *   true  = c is a digit, and the operand doesn't have room for it.
+ *   false = c will be added, or it isn't a digit.
+ */
+bool
+operand_add_char_is_full(const operand *this,
+                         char           c)
+{
+  bool retcode = false;
+
+  if(this != (operand *) 0)
+  {
+    switch(this->base)
+    {
+    case operand_type_base_10:
+      retcode = operand_base_10_add_char_is_full(&this->num.decnum, c);
+      break;
+
+    case operand_type_base_16:
+      retcode = operand_base_16_add_char_is_full(&this->num.hexnum, c);
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  return retcode;
+}
+
 /* Attempt to add a character to the operand object.
  *
  * Input:
@@ -570,11 +703,11 @@ operand_add_char(operand *this,
       switch(base)
       {
       case operand_type_base_10:
-        retcode = operand_base_10_add_char(this->decnum, c);
+        retcode = operand_base_10_add_char(&this->num.decnum, c);
         break;
 
       case operand_type_base_16:
-        retcode = operand_base_16_add_char(this->hexnum, c);
+        retcode = operand_base_16_add_char(&this->num.hexnum, c);
         break;
 
       default:
@@ -613,11 +746,11 @@ bool operand_to_str(operand *this,
     switch(this->base)
     {
     case operand_type_base_10:
-      retcode = operand_base_10_to_str(this->decnum, buf, buf_size);
+      retcode = operand_base_10_to_str(&this->num.decnum, buf, buf_size);
       break;
 
     case operand_type_base_16:
-      retcode = operand_base_16_to_str(this->hexnum, buf, buf_size);
+      retcode = operand_base_16_to_str(&this->num.hexnum, buf, buf_size);
       break;
 
     default:
@@ -681,10 +814,40 @@ operand_test(void)
     DBG_PRINT("  str = '%s'.\n", result);
     if(strcmp(result, t->dst) != 0)                                  return false;
 
+    /* A copy has the same value, and doesn't accept more input. */
+    DBG_PRINT("operand_copy()\n");
+    operand *copy;
+    if((copy = operand_new(operand_type_base_16)) == (operand *) 0)  return false;
+    if(operand_copy(this, copy) != true)                             return false;
+    if(operand_to_str(copy, result, sizeof(result)) != true)         return false;
+    if(strcmp(result, t->dst) != 0)                                  return false;
+    if(operand_add_char_allowed(copy) != false)                      return false;
+    if(operand_delete(copy) != true)                                 return false;
+
     DBG_PRINT("operand_delete()\n");
     if(operand_delete(this) != true)                                 return false;
   }
 
+  /* Switching bases converts the number into the other representation. */
+  printf("  operand_set_base()\n");
+  operand *this;
+  char result[1024];
+  if((this = operand_new(operand_type_base_10)) == (operand *) 0)    return false;
+  if(operand_add_char(this, '2') != true)                            return false;
+  if(operand_add_char(this, '5') != true)                            return false;
+  if(operand_add_char(this, '5') != true)                            return false;
+  if(operand_set_base(this, operand_type_base_10) != true)           return false;
+  if(operand_set_base(this, operand_type_base_16) != true)           return false;
+  if(operand_to_str(this, result, sizeof(result)) != true)           return false;
+  if(strcmp(result, "FF") != 0)                                      return false;
+  if(operand_set_base(this, operand_type_base_10) != true)           return false;
+  if(operand_to_str(this, result, sizeof(result)) != true)           return false;
+  if(strcmp(result, "255") != 0)                                     return false;
+  if(operand_reset(this, operand_type_base_16) != true)              return false;
+  if(operand_to_str(this, result, sizeof(result)) != true)           return false;
+  if(strcmp(result, "0") != 0)                                       return false;
+  if(operand_delete(this) != true)                                   return false;
+
   return true;
 }
 #endif // TEST
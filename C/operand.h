@@ -43,10 +43,16 @@ bool operand_get_base(operand *this, operand_type *base);
 
 bool operand_set_base(operand *this, operand_type base);
 
+bool operand_reset(operand *this, operand_type base);
+
+bool operand_copy(const operand *src, operand *dst);
+
 bool operand_add_char_is_valid_operand(operand_type base, char c);
 
 bool operand_add_char_allowed(operand *this);
 
+bool operand_add_char_is_full(const operand *this, char c);
+
 bool operand_add_char(operand *this, char c);
 
 bool operand_to_str(operand *this, char *buf, size_t buf_size);
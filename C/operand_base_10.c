@@ -13,16 +13,20 @@
 
 #include "common.h"
 
+#include "bench.h"
 #include "operand_base_10.h"
 #include "operator_exp.h"
 
+/* The constant tables (generated by gen_constants.c). */
+#include "operand_base_10_constants.h"
+
 #define min(a, b) ((a) < (b) ? (a) : (b))
 #define max(a, b) ((a) > (b) ? (a) : (b))
 
 #define BCD_DBG_STR_TO_DECIMAL       0x0001
-#define BCD_DBG_ADD_HALF_WIDTH       0x0002
+#define BCD_DBG_ADD_WORD             0x0002
 #define BCD_DBG_SIGNIFICAND_ADD      0x0004
-#define BCD_DBG_TENS_COMPLEMENT      0x0008
+#define BCD_DBG_SIGNIFICAND_SUB      0x0008
 #define BCD_DBG_MAKE_EXPONENTS_EQUAL 0x0010
 #define BCD_DBG_OP_ADD               0x0100
 #define BCD_DBG_OP_SUB               0x0200
@@ -39,97 +43,35 @@
  ****************************** CLASS DEFINITION ******************************
  *****************************************************************************/
 
-/* The number of digits the user can push to operand_base_10_add_char(). */
-#define BCD_NUM_DIGITS 16 // Must be a multiple of 2.
-
-#if (BCD_NUM_DIGITS >= 16)
-/* The basic data element that stores the BCD digits internally. */
-typedef uint32_t significand_section_t;
-
-/* The data element that is passed to bcd_add_half_width().  It allows an
- * addition operation to carry at the top end. */
-typedef uint64_t significand_large_section_t;
-
-#define SIGNIFICAND_ADD_HALF_VAL1              0x066666666ll
-#define SIGNIFICAND_ADD_HALF_VAL2              0x111111110ll
-#define SIGNIFICAND_SECTION_MASK                0xFFFFFFFF
-#define SIGNIFICAND_SECT_TENS_COMPLEMENT_VAL    0x99999999
-
-#elif (BCD_NUM_DIGITS >= 8)
-
-/* The basic data element that stores the BCD digits internally. */
-typedef uint16_t significand_section_t;
-
-/* The data element that is passed to bcd_add_half_width().  It allows an
- * addition operation to carry at the top end. */
-typedef uint32_t significand_large_section_t;
+/* The data element that the word-parallel kernels (i.e. bcd_add_word()) work
+ * with.  The sections are packed into words, most significant first.  If the
+ * last word isn't full, its low-order digits are zero. */
+typedef uint64_t significand_word_t;
 
-#define SIGNIFICAND_ADD_HALF_VAL1              0x06666ll
-#define SIGNIFICAND_ADD_HALF_VAL2              0x11110ll
-#define SIGNIFICAND_SECTION_MASK                0xFFFF
-#define SIGNIFICAND_SECT_TENS_COMPLEMENT_VAL    0x9999
+#define SIGNIFICAND_WORD_ADD_VAL1              0x6666666666666666ull
+#define SIGNIFICAND_WORD_ADD_VAL2              0x1111111111111110ull
+#define SIGNIFICAND_WORD_SUB_VAL               0x1111111111111110ull
+#define SIGNIFICAND_WORD_TOP_SIX               0x6000000000000000ull
 
-#else
-
-/* The basic data element that stores the BCD digits internally. */
-typedef uint8_t significand_section_t;
-
-/* The data element that is passed to bcd_add_half_width().  It allows an
- * addition operation to carry at the top end. */
-typedef uint16_t significand_large_section_t;
-
-#define SIGNIFICAND_ADD_HALF_VAL1              0x066ll
-#define SIGNIFICAND_ADD_HALF_VAL2              0x110ll
-#define SIGNIFICAND_SECTION_MASK                0xFF
-#define SIGNIFICAND_SECT_TENS_COMPLEMENT_VAL    0x99
-
-#endif
-
-/* The number of digits that can be stored in a single data element. */
-#define SIGNIFICAND_DIGITS_PER_SECTION (sizeof(significand_section_t) * 2)
-
-/* This is the number of digits that we work with internally.  It gives us a
- * lot of extra precision, thus allowing us to do things like:
- * - Perform repeated operations like exponentiation.
- * - Perform rounding on results.
- */
-#define BCD_NUM_DIGITS_INTERNAL (BCD_NUM_DIGITS * 2)
+/* The number of digits and sections that fit in a single word. */
+#define SIGNIFICAND_DIGITS_PER_WORD   (sizeof(significand_word_t) * 2)
+#define SIGNIFICAND_SECTIONS_PER_WORD (sizeof(significand_word_t) / sizeof(significand_section_t))
 
-/* The number of data elements required to hold all of the digits. */
-#define SIGNIFICAND_SECTIONS_INTERNAL (BCD_NUM_DIGITS_INTERNAL / SIGNIFICAND_DIGITS_PER_SECTION)
+/* The number of words required to hold all of the digits. */
+#define SIGNIFICAND_WORDS_INTERNAL ((SIGNIFICAND_SECTIONS_INTERNAL + SIGNIFICAND_SECTIONS_PER_WORD - 1) / SIGNIFICAND_SECTIONS_PER_WORD)
 
-/* The definition of the significand that is located in each operand_base_10 object. */
-typedef struct { significand_section_t s[SIGNIFICAND_SECTIONS_INTERNAL]; } significand_t;
+/* The multiplication and division engines work on binary limbs instead of BCD
+ * digits.  Each limb holds 8 decimal digits (0 - 99,999,999), so each word of
+ * digits turns into 2 limbs.  Limbs are stored least significant first. */
+#define BCD_LIMB_DIGITS    8
+#define BCD_LIMB_BASE      100000000ull
+#define BCD_LIMBS_INTERNAL (SIGNIFICAND_WORDS_INTERNAL * 2)
 
-/* This is the operand_base_10 class. */
-struct operand_base_10 {
-
-  /* This is the significand.  Each nybble equals one decimal digit.*/
-  significand_t significand;
-
-  /* This is the exponent.
-   * - It's >= 0 if (|number| >= 1).
-   * - It's < 0 if (|number| < 1).
-   */
-  int16_t exponent;
-
-  /* This is the sign.
-   * - true = negative.
-   * - false = positive.
-   */
-  uint8_t sign;
-
-  /* If we're adding one character at a time, these are used to help us know
-   * where we are. */
-  int char_count;
-  bool got_decimal_point;
-};
-  
 /******************************************************************************
  ******************************** OPS STRUCT **********************************
  *****************************************************************************/
 
-operand_api operand_base_10_ops = {
+const operand_api operand_base_10_ops = {
   .base_name = "BCD",
   .op_add = (operand_api_binary_op) operand_base_10_op_add,
   .op_sub = (operand_api_binary_op) operand_base_10_op_sub,
@@ -232,8 +174,8 @@ bcd_sect_set_digit(significand_section_t *section,
  *   If failure, returns 0xF.
  */
 static uint8_t
-bcd_sig_get_digit(significand_t *significand,
-                  int            offset)
+bcd_sig_get_digit(const significand_t *significand,
+                  int                  offset)
 {
   uint8_t retval = 0xF;
 
@@ -280,7 +222,73 @@ bcd_sig_set_digit(significand_t *significand,
   return retcode;
 }
 
+/* Pack the sections of a significand into a significand_word_t.  If the
+ * significand runs out of sections before the word is full, the remaining
+ * (low-order) digits of the word are set to zero.
+ *
+ * Input:
+ *   sig   = A pointer to the significand.
+ *
+ *   index = The index of the word.  0 is the most significant word.
+ *
+ * Output:
+ *   Returns the word.
+ */
+static inline significand_word_t
+bcd_sig_get_word(const significand_t *sig,
+                 int                  index)
+{
+  significand_word_t word = 0;
+
+  int i;
+  for(i = 0; i < SIGNIFICAND_SECTIONS_PER_WORD; i++)
+  {
+    int s = (index * SIGNIFICAND_SECTIONS_PER_WORD) + i;
+    word <<= (sizeof(significand_section_t) * 8);
+    if(s < SIGNIFICAND_SECTIONS_INTERNAL)
+    {
+      word |= sig->s[s];
+    }
+  }
+
+  return word;
+}
+
+/* Unpack a significand_word_t into the sections of a significand.  This is the
+ * opposite of bcd_sig_get_word().  Digits that don't have a section to go to
+ * are discarded.
+ *
+ * Input:
+ *   sig   = A pointer to the significand.
+ *
+ *   index = The index of the word.  0 is the most significant word.
+ *
+ *   word  = The word to store.
+ *
+ * Output:
+ *   N/A.
+ */
+static inline void
+bcd_sig_set_word(significand_t      *sig,
+                 int                 index,
+                 significand_word_t  word)
+{
+  int i;
+  for(i = (SIGNIFICAND_SECTIONS_PER_WORD - 1); i >= 0; i--)
+  {
+    int s = (index * SIGNIFICAND_SECTIONS_PER_WORD) + i;
+    if(s < SIGNIFICAND_SECTIONS_INTERNAL)
+    {
+      sig->s[s] = (significand_section_t) word;
+    }
+    word >>= (sizeof(significand_section_t) * 8);
+  }
+}
+
 /* Shift the significand left or right by the specified number of places.
+ * The digits are moved a whole word at a time, so the cost doesn't depend on
+ * the number of places.  Digits that fall off the end are lost, and zeroes are
+ * shifted in.
  *
  * Input:
  *   sig   = A pointer to the significand.
@@ -302,44 +310,54 @@ bcd_shift_significand(significand_t *sig,
 
   if(sig != (significand_t *) 0)
   {
+    int places     = (shift < 0) ? (0 - shift) : shift;
+    int word_shift = (places / SIGNIFICAND_DIGITS_PER_WORD);
+    int bit_shift  = (places % SIGNIFICAND_DIGITS_PER_WORD) * 4;
+    int bit_carry  = (sizeof(significand_word_t) * 8) - bit_shift;
+
+    significand_word_t src[SIGNIFICAND_WORDS_INTERNAL];
     int i;
+    for(i = 0; i < SIGNIFICAND_WORDS_INTERNAL; i++)
+    {
+      src[i] = bcd_sig_get_word(sig, i);
+    }
 
-    /* Left shift starts at the beginning of the number. */
-    if(shift < 0)
+    for(i = 0; i < SIGNIFICAND_WORDS_INTERNAL; i++)
     {
-      for(i = 0; i < BCD_NUM_DIGITS_INTERNAL; i++)
+      significand_word_t word = 0;
+
+      /* Left shift pulls digits up from the less significant words. */
+      if(shift < 0)
       {
-        int src_offset = i - shift;
-        int dst_offset = i;
-        uint8_t c = (src_offset >= BCD_NUM_DIGITS_INTERNAL) ? 0 : bcd_sig_get_digit(sig, src_offset);
-        if((retcode = bcd_sig_set_digit(sig, dst_offset, c)) != true)
+        int src_index = i + word_shift;
+        if(src_index < SIGNIFICAND_WORDS_INTERNAL)
         {
-          break;
+          word = src[src_index] << bit_shift;
+        }
+        if((bit_shift != 0) && ((src_index + 1) < SIGNIFICAND_WORDS_INTERNAL))
+        {
+          word |= src[src_index + 1] >> bit_carry;
         }
       }
-    }
 
-    /* Right shift starts at the end. */
-    else if(shift > 0)
-    {
-      for(i = (BCD_NUM_DIGITS_INTERNAL - 1); i >= 0; i--)
+      /* Right shift pushes digits down from the more significant words. */
+      else
       {
-        int src_offset = i - shift;
-        int dst_offset = i;
-        uint8_t c = (src_offset < 0) ? 0 : bcd_sig_get_digit(sig, src_offset);
-        if((retcode = bcd_sig_set_digit(sig, dst_offset, c)) != true)
+        int src_index = i - word_shift;
+        if(src_index >= 0)
         {
-          break;
+          word = src[src_index] >> bit_shift;
+        }
+        if((bit_shift != 0) && ((src_index - 1) >= 0))
+        {
+          word |= src[src_index - 1] << bit_carry;
         }
       }
-    }
-   
 
-    /* No shift is okay too. */
-    else
-    {
-      retcode = true;
+      bcd_sig_set_word(sig, i, word);
     }
+
+    retcode = true;
   }
 
   return retcode;
@@ -382,7 +400,7 @@ bcd_sig_initialize(significand_t *significand)
  *   Returns false if it's not zero, or if significand is an invalid pointer.
  */
 static bool
-bcd_sig_is_zero(significand_t *significand)
+bcd_sig_is_zero(const significand_t *significand)
 {
   bool retcode = false;
 
@@ -411,8 +429,8 @@ bcd_sig_is_zero(significand_t *significand)
  *   false = failure.
  */
 static bool
-bcd_sig_copy(significand_t *src,
-             significand_t *dst)
+bcd_sig_copy(const significand_t *src,
+             significand_t       *dst)
 {
   bool retcode = false;
 
@@ -459,23 +477,25 @@ bcd_sig_cmp(significand_t *src,
 
   if( (src != (significand_t *) 0) && (dst != (significand_t *) 0) )
   {
+    /* Packed BCD digits sort the same way as unsigned binary, so we can
+     * compare a whole word of digits at a time. */
     int i;
-    for(i = 0; i < SIGNIFICAND_SECTIONS_INTERNAL; i++)
+    for(i = 0; i < SIGNIFICAND_WORDS_INTERNAL; i++)
     {
-      significand_section_t src_section = src->s[i];
+      significand_word_t src_word = bcd_sig_get_word(src, i);
       if(src_mask != (significand_t *) 0)
       {
-        src_section &= src_mask->s[i];
+        src_word &= bcd_sig_get_word(src_mask, i);
       }
 
-      significand_section_t dst_section = dst->s[i];
+      significand_word_t dst_word = bcd_sig_get_word(dst, i);
       if(dst_mask != (significand_t *) 0)
       {
-        dst_section &= dst_mask->s[i];
+        dst_word &= bcd_sig_get_word(dst_mask, i);
       }
 
-      if( src_section < dst_section) { retval = -1; break; }
-      if( src_section > dst_section) { retval =  1; break; }
+      if( src_word < dst_word) { retval = -1; break; }
+      if( src_word > dst_word) { retval =  1; break; }
     }
   }
 
@@ -492,30 +512,26 @@ bcd_sig_cmp(significand_t *src,
  *   If an error occurs, it returns -1.
  */
 static int
-bcd_sig_num_digits(significand_t *significand)
+bcd_sig_num_digits(const significand_t *significand)
 {
   int retval = -1;
 
   if(significand != (significand_t *) 0)
   {
     /* If the number is zero, then there are zero significant digits. */
-    if(bcd_sig_is_zero(significand) == true)
-    {
-      retval = 0;
-    }
+    retval = 0;
 
     /* If the number is NOT zero, then we need to count the number of
-     * insignificant digits. */
-    else
+     * insignificant (trailing) digits.  Start with the least significant word
+     * and look for the last non-zero digit. */
+    int i;
+    for(i = (SIGNIFICAND_WORDS_INTERNAL - 1); i >= 0; i--)
     {
-      int i;
-      for(i = BCD_NUM_DIGITS_INTERNAL; i > 0; i--)
+      significand_word_t word = bcd_sig_get_word(significand, i);
+      if(word != 0)
       {
-        if(bcd_sig_get_digit(significand, (i - 1)) != 0)
-        {
-          retval = i;
-          break;
-        }
+        retval = ((i + 1) * SIGNIFICAND_DIGITS_PER_WORD) - (__builtin_ctzll(word) / 4);
+        break;
       }
     }
   }
@@ -523,12 +539,40 @@ bcd_sig_num_digits(significand_t *significand)
   return retval;
 }
 
+/* Count the number of leading zeroes in the significand.
+ *
+ * Input:
+ *   significand = A pointer to the significand.
+ *
+ * Output:
+ *   Returns the number of leading zeroes.  If the number is zero, then all of
+ *   the digits are leading zeroes.
+ */
+static int
+bcd_sig_leading_zeroes(const significand_t *significand)
+{
+  int retval = BCD_NUM_DIGITS_INTERNAL;
+
+  int i;
+  for(i = 0; i < SIGNIFICAND_WORDS_INTERNAL; i++)
+  {
+    significand_word_t word = bcd_sig_get_word(significand, i);
+    if(word != 0)
+    {
+      retval = (i * SIGNIFICAND_DIGITS_PER_WORD) + (__builtin_clzll(word) / 4);
+      break;
+    }
+  }
+
+  return retval;
+}
+
 #if defined(DEBUG)
 /* This function will convert a significand_section_t to an ASCII string.  It
  * returns a pointer to the string.
  *
- * WARNING: This function will maintain a limited number of buffers that can
- *          hold a string.  The caller doesn't need to free the string after
+ * WARNING: This function will maintain a limited number of buffers (per
+ *          thread) that can hold a string.  The caller doesn't need to free the string after
  *          they use it, but they shouldn't hold onto it for a long time and
  *          expect it to remain the same.  The purpose of this member is to
  *          provide a string that can be used to debug/test purposes.  It's not
@@ -546,32 +590,24 @@ bcd_sig_section_to_str(significand_section_t section)
 {
   char *retval = "UNKNOWN";
 
-  /* This is a collection of buffers that is used for building strings.
+  /* This is a collection of buffers that is used for building strings.  Each
+   * thread has its own, so there's no need for locking.
    * NOTE: The size has to be a power of 2. */
-  static char *sig_msgs[16] = { 0 };
-  static char  sig_msgs_size = (sizeof(sig_msgs) / sizeof(sig_msgs[0]));
-  static int   sig_msgs_index = 0;
+  static _Thread_local char sig_msgs[16][SIGNIFICAND_DIGITS_PER_SECTION + 1];
+  static _Thread_local int  sig_msgs_index = 0;
+  const int sig_msgs_size = (sizeof(sig_msgs) / sizeof(sig_msgs[0]));
 
-  /* We allocate the pointer the first time we need it. */
-  if(sig_msgs[sig_msgs_index] == (char *) 0)
-  {
-    sig_msgs[sig_msgs_index] = (char *) malloc(SIGNIFICAND_DIGITS_PER_SECTION + 1);
-  }
+  retval = sig_msgs[sig_msgs_index];
+  sig_msgs_index = ((sig_msgs_index + 1) % sig_msgs_size);
 
-  if(sig_msgs[sig_msgs_index] != (char *) 0)
+  /* Create the string now. */
+  int i;
+  for(i = 0; i < SIGNIFICAND_DIGITS_PER_SECTION; i++)
   {
-    retval = sig_msgs[sig_msgs_index];
-    sig_msgs_index = ((sig_msgs_index + 1) % sig_msgs_size);
-
-    /* Create the string now. */
-    int i;
-    for(i = 0; i < SIGNIFICAND_DIGITS_PER_SECTION; i++)
-    {
-      char c = bcd_sect_get_digit(section, i);
-      retval[i] = (c > 9) ? (c + 0x37) : (c + 0x30);
-    }
-    retval[i] = 0;
+    char c = bcd_sect_get_digit(section, i);
+    retval[i] = (c > 9) ? (c + 0x37) : (c + 0x30);
   }
+  retval[i] = 0;
 
   return retval;
 }
@@ -579,8 +615,8 @@ bcd_sig_section_to_str(significand_section_t section)
 /* This function will return a string that contains debug info about the bcd
  * object.
  *
- * WARNING: This function will maintain a limited number of buffers that can
- *          hold a string.  The caller doesn't need to free the string after
+ * WARNING: This function will maintain a limited number of buffers (per
+ *          thread) that can hold a string.  The caller doesn't need to free the string after
  *          they use it, but they shouldn't hold onto it for a long time and
  *          expect it to remain the same.  The purpose of this member is to
  *          provide a string that can be used to debug/test purposes.  It's not
@@ -594,47 +630,29 @@ bcd_sig_section_to_str(significand_section_t section)
  *   If failure, returns a pointer to the string "UNKNOWN".
  */
 static const char *
-bcd_sig_to_str(significand_t *significand)
+bcd_sig_to_str(const significand_t *significand)
 {
   char *retval = "UNKNOWN";
 
-  /* This is a collection of buffers that is used for building strings.
+  /* This is a collection of buffers that is used for building strings.  Each
+   * thread has its own, so there's no need for locking.
    * NOTE: The size has to be a power of 2. */
-  static char *sig_msgs[8] = { 0 };
-  static char  sig_msgs_size = (sizeof(sig_msgs) / sizeof(sig_msgs[0]));
-  static int   sig_msgs_index = 0;
+  static _Thread_local char sig_msgs[8][(SIGNIFICAND_SECTIONS_INTERNAL * (SIGNIFICAND_DIGITS_PER_SECTION + 1)) + 1];
+  static _Thread_local int  sig_msgs_index = 0;
+  const int sig_msgs_size = (sizeof(sig_msgs) / sizeof(sig_msgs[0]));
 
   if(significand != (significand_t *) 0)
   {
-    /* We allocate the pointers the first time we need them. */
-    if(sig_msgs[sig_msgs_index] == (char *) 0)
-    {
-      int   msg_size = ((SIGNIFICAND_SECTIONS_INTERNAL * (SIGNIFICAND_DIGITS_PER_SECTION + 1)) + 1);
-      int alloc_size = (sig_msgs_size * msg_size);
-      char *msg_buf = (char *) malloc(alloc_size);
-      if(msg_buf != (char *) 0)
-      {
-        int j;
-        for(j = 0; j < sig_msgs_size; j++)
-        {
-          sig_msgs[j] = msg_buf + (j * msg_size);
-        }
-      }
-    }
+    retval = sig_msgs[sig_msgs_index];
+    sig_msgs_index = ((sig_msgs_index + 1) % sig_msgs_size);
+    retval[0] = 0;
 
-    if(sig_msgs[sig_msgs_index] != (char *) 0)
+    /* Create the string now. */
+    int i;
+    for(i = 0; i < SIGNIFICAND_SECTIONS_INTERNAL; i++)
     {
-      retval = sig_msgs[sig_msgs_index];
-      sig_msgs_index = ((sig_msgs_index + 1) % sig_msgs_size);
-      retval[0] = 0;
-
-      /* Create the string now. */
-      int i;
-      for(i = 0; i < SIGNIFICAND_SECTIONS_INTERNAL; i++)
-      {
-        strcat(retval, bcd_sig_section_to_str(significand->s[i]));
-        strcat(retval, ":");
-      }
+      strcat(retval, bcd_sig_section_to_str(significand->s[i]));
+      strcat(retval, ":");
     }
   }
 
@@ -776,49 +794,274 @@ bcd_to_str_decimal(significand_t *significand,
   return retcode;
 }
 
-/* Perform a straight addition of 2 significand sections.  The caller passes an
- * extra large value to store the result so we don't have to worry about
- * overflow.  We simply add the 2 values and place the sum in the large
- * container.  If there was a carry above the size of a regular
- * significand_section_t, the caller will handle it.
+/* Convert a BCD word into 2 binary limbs.  The digits are combined in
+ * parallel: pairs of digits first, then pairs of pairs, and so on.
  *
  * Input:
- *   val1   = One significand_section_t value.
+ *   word = The significand_word_t to convert.
  *
- *   val2   = One significand_section_t value.
+ *   hi   = A pointer to the limb that receives the most significant digits.
  *
- *   dst    = A pointer to the place to store the result.  Note that the result
- *            might carry up into the upper-half of *dst.
+ *   lo   = A pointer to the limb that receives the least significant digits.
  *
  * Output:
- *   true  = success.  *dst contains the sum.
- *   false = failure.  *dst is undefined.
+ *   N/A.
  */
-static bool
-bcd_add_half_width(significand_section_t        val1,
-                   significand_section_t        val2,
-                   significand_large_section_t *dst)
+static inline void
+bcd_word_to_limbs(significand_word_t  word,
+                  uint32_t           *hi,
+                  uint32_t           *lo)
 {
-  bool retcode = false;
+  uint64_t v = word;
+  v = (v & 0x0F0F0F0F0F0F0F0Full) + (((v >>  4) & 0x0F0F0F0F0F0F0F0Full) * 10);
+  v = (v & 0x00FF00FF00FF00FFull) + (((v >>  8) & 0x00FF00FF00FF00FFull) * 100);
+  v = (v & 0x0000FFFF0000FFFFull) + (((v >> 16) & 0x0000FFFF0000FFFFull) * 10000);
 
-  if(dst != (significand_large_section_t *) 0)
+  *hi = (uint32_t) (v >> 32);
+  *lo = (uint32_t) v;
+}
+
+/* Convert 2 binary limbs back into a BCD word.  This is the opposite of
+ * bcd_word_to_limbs().
+ *
+ * Input:
+ *   hi = The limb that holds the most significant digits.
+ *
+ *   lo = The limb that holds the least significant digits.
+ *
+ * Output:
+ *   Returns the word.
+ */
+static inline significand_word_t
+bcd_limbs_to_word(uint32_t hi,
+                  uint32_t lo)
+{
+  significand_word_t word = 0;
+
+  int i;
+  for(i = 0; i < BCD_LIMB_DIGITS; i++)
   {
-    BCD_PRINT(BCD_DBG_ADD_HALF_WIDTH, "%s(%s %s)\n", __func__, bcd_sig_section_to_str(val1), bcd_sig_section_to_str(val2));
-    significand_large_section_t t1 = val1 + SIGNIFICAND_ADD_HALF_VAL1;
-    significand_large_section_t t2 = t1 + val2;
-    significand_large_section_t t3 = t1 ^ val2;
-    significand_large_section_t t4 = t2 ^ t3;
-    significand_large_section_t t5 = ~t4 & SIGNIFICAND_ADD_HALF_VAL2;
-    significand_large_section_t t6 = (t5 >> 2) | (t5 >> 3);
-    *dst = t2 - t6;
-    BCD_PRINT(BCD_DBG_ADD_HALF_WIDTH, "%s(): SUM %s:%s.\n", __func__,
-              bcd_sig_section_to_str((*dst) >> (SIGNIFICAND_DIGITS_PER_SECTION * 4)),
-              bcd_sig_section_to_str(*dst));
+    word |= ((significand_word_t) (lo % 10)) << (i * 4);
+    word |= ((significand_word_t) (hi % 10)) << ((i + BCD_LIMB_DIGITS) * 4);
+    lo /= 10;
+    hi /= 10;
+  }
 
-    retcode = true;
+  return word;
+}
+
+/* Convert a significand into binary limbs.  If the last word isn't full, the
+ * limbs hold the significand scaled up by the missing (zero) digits.
+ *
+ * Input:
+ *   sig   = A pointer to the significand.
+ *
+ *   limbs = A pointer to an array of BCD_LIMBS_INTERNAL limbs.
+ *
+ * Output:
+ *   N/A.
+ */
+static void
+bcd_sig_to_limbs(const significand_t *sig,
+                 uint32_t            *limbs)
+{
+  int i;
+  for(i = 0; i < SIGNIFICAND_WORDS_INTERNAL; i++)
+  {
+    int lo = (BCD_LIMBS_INTERNAL - 2) - (i * 2);
+    bcd_word_to_limbs(bcd_sig_get_word(sig, i), &limbs[lo + 1], &limbs[lo]);
   }
+}
 
-  return retcode;
+/* Divide one array of limbs by another.  This is Knuth's Algorithm D (The Art
+ * of Computer Programming, Vol. 2, 4.3.1) in base 10^8.  Each quotient limb
+ * is estimated from the top limbs of the remainder and the divisor, corrected
+ * at most twice, and then multiplied back out and subtracted.  The remainder
+ * is discarded.
+ *
+ * Input:
+ *   num      = A pointer to the dividend limbs (least significant first).
+ *
+ *   num_len  = The number of dividend limbs.  It must be >= den_len, and no
+ *              larger than (BCD_LIMBS_INTERNAL * 2) + 1.
+ *
+ *   den      = A pointer to the divisor limbs (least significant first).
+ *
+ *   den_len  = The number of divisor limbs.  It must be >= 2 and no larger
+ *              than BCD_LIMBS_INTERNAL.  The most significant limb can't be 0.
+ *
+ *   quot     = A pointer to the place to store the quotient.  It receives
+ *              (num_len - den_len + 1) limbs.
+ *
+ * Output:
+ *   N/A.
+ */
+static void
+bcd_limbs_divide(const uint32_t *num,
+                 int             num_len,
+                 const uint32_t *den,
+                 int             den_len,
+                 uint32_t       *quot)
+{
+  uint32_t un[(BCD_LIMBS_INTERNAL * 2) + 2];
+  uint32_t vn[BCD_LIMBS_INTERNAL];
+  int n = den_len;
+  int m = num_len - den_len;
+  int i, j;
+
+  /* Normalize.  Scale both numbers so that the top limb of the divisor is at
+   * least half of the base.  That keeps the quotient estimates close. */
+  uint64_t d = BCD_LIMB_BASE / ((uint64_t) den[n - 1] + 1);
+  uint64_t carry = 0;
+  for(i = 0; i < n; i++)
+  {
+    uint64_t t = ((uint64_t) den[i] * d) + carry;
+    vn[i] = (uint32_t) (t % BCD_LIMB_BASE);
+    carry = t / BCD_LIMB_BASE;
+  }
+  carry = 0;
+  for(i = 0; i < num_len; i++)
+  {
+    uint64_t t = ((uint64_t) num[i] * d) + carry;
+    un[i] = (uint32_t) (t % BCD_LIMB_BASE);
+    carry = t / BCD_LIMB_BASE;
+  }
+  un[num_len] = (uint32_t) carry;
+
+  for(j = m; j >= 0; j--)
+  {
+    /* Estimate the quotient limb from the top 2 limbs of the remainder. */
+    uint64_t top  = ((uint64_t) un[j + n] * BCD_LIMB_BASE) + un[j + n - 1];
+    uint64_t qhat = top / vn[n - 1];
+    uint64_t rhat = top % vn[n - 1];
+    while((qhat >= BCD_LIMB_BASE) ||
+          ((qhat * vn[n - 2]) > ((rhat * BCD_LIMB_BASE) + un[j + n - 2])))
+    {
+      qhat--;
+      rhat += vn[n - 1];
+      if(rhat >= BCD_LIMB_BASE)
+      {
+        break;
+      }
+    }
+
+    /* Multiply and subtract. */
+    int64_t borrow = 0;
+    carry = 0;
+    for(i = 0; i < n; i++)
+    {
+      uint64_t p = (qhat * vn[i]) + carry;
+      carry = p / BCD_LIMB_BASE;
+      int64_t t = (int64_t) un[i + j] - (int64_t) (p % BCD_LIMB_BASE) - borrow;
+      borrow = (t < 0) ? 1 : 0;
+      un[i + j] = (uint32_t) ((t < 0) ? (t + BCD_LIMB_BASE) : t);
+    }
+    int64_t t = (int64_t) un[j + n] - (int64_t) carry - borrow;
+
+    /* The estimate was one too big (this is rare).  Add the divisor back. */
+    if(t < 0)
+    {
+      qhat--;
+      carry = 0;
+      for(i = 0; i < n; i++)
+      {
+        uint64_t s = (uint64_t) un[i + j] + vn[i] + carry;
+        un[i + j] = (uint32_t) (s % BCD_LIMB_BASE);
+        carry = s / BCD_LIMB_BASE;
+      }
+      t += carry;
+    }
+    un[j + n] = (uint32_t) ((t < 0) ? (t + BCD_LIMB_BASE) : t);
+
+    quot[j] = (uint32_t) qhat;
+  }
+}
+
+/* Perform a straight addition of 2 BCD words.  All of the digits are added in
+ * parallel.  The trick is to add 6 to every digit of val1 up front, so that a
+ * digit sum >= 10 carries into the next digit exactly like a binary carry
+ * does.  When we're done, we use the carry bits to find the digits that didn't
+ * carry, and we take the 6 back out of them.
+ *
+ * Input:
+ *   val1  = One significand_word_t value.
+ *
+ *   val2  = One significand_word_t value.
+ *
+ *   carry = A pointer to the carry.  On input it contains the carry (0 or 1)
+ *           into the lowest digit.  On output it contains the carry out of the
+ *           highest digit.
+ *
+ * Output:
+ *   Returns the sum.
+ */
+static inline significand_word_t
+bcd_add_word(significand_word_t  val1,
+             significand_word_t  val2,
+             uint8_t            *carry)
+{
+  significand_word_t t1 = val1 + SIGNIFICAND_WORD_ADD_VAL1;
+  significand_word_t t2 = t1 + val2 + *carry;
+  significand_word_t t3 = t1 ^ val2;
+  significand_word_t t4 = t2 ^ t3;
+  significand_word_t t5 = ~t4 & SIGNIFICAND_WORD_ADD_VAL2;
+  significand_word_t t6 = (t5 >> 2) | (t5 >> 3);
+
+  /* val2 can never be large enough to wrap all the way around, so the sum
+   * carried out of the top digit if and only if it wrapped. */
+  *carry = (t2 < t1) ? 1 : 0;
+
+  significand_word_t sum = t2 - t6;
+  if(*carry == 0)
+  {
+    sum -= SIGNIFICAND_WORD_TOP_SIX;
+  }
+
+  BCD_PRINT(BCD_DBG_ADD_WORD, "%s(0x%016llX 0x%016llX): 0x%016llX %d.\n", __func__,
+            (unsigned long long) val1, (unsigned long long) val2, (unsigned long long) sum, *carry);
+
+  return sum;
+}
+
+/* Perform a straight subtraction of 2 BCD words.  All of the digits are
+ * subtracted in parallel, as if they were binary.  A digit that had to borrow
+ * wrapped around by 16 instead of 10, so we use the borrow bits to find those
+ * digits and take 6 out of each of them.
+ *
+ * Input:
+ *   val1   = The significand_word_t value to subtract from.
+ *
+ *   val2   = The significand_word_t value to subtract.
+ *
+ *   borrow = A pointer to the borrow.  On input it contains the borrow (0 or 1)
+ *            out of the lowest digit.  On output it contains the borrow out of
+ *            the highest digit.
+ *
+ * Output:
+ *   Returns the difference.
+ */
+static inline significand_word_t
+bcd_sub_word(significand_word_t  val1,
+             significand_word_t  val2,
+             uint8_t            *borrow)
+{
+  significand_word_t t1 = val1 - val2 - *borrow;
+  significand_word_t t2 = t1 ^ val1 ^ val2;
+  significand_word_t t3 = t2 & SIGNIFICAND_WORD_SUB_VAL;
+  significand_word_t t4 = (t3 >> 2) | (t3 >> 3);
+
+  *borrow = ((val1 < val2) || ((val1 == val2) && (*borrow != 0))) ? 1 : 0;
+
+  significand_word_t diff = t1 - t4;
+  if(*borrow != 0)
+  {
+    diff -= SIGNIFICAND_WORD_TOP_SIX;
+  }
+
+  BCD_PRINT(BCD_DBG_SIGNIFICAND_SUB, "%s(0x%016llX 0x%016llX): 0x%016llX %d.\n", __func__,
+            (unsigned long long) val1, (unsigned long long) val2, (unsigned long long) diff, *borrow);
+
+  return diff;
 }
 
 /* Perform a straight addition of 2 significands.  No exponents or signs are
@@ -835,9 +1078,9 @@ bcd_add_half_width(significand_section_t        val1,
  *
  *   carry     = [optional] A pointer to a variable that will be set to true if
  *                          a carry occurs "at the end" of the addition.
- *               NULL = Do NOT check for carry.  Only pass in a non-NULL if you
- *                      really want to check for carry.  It's a manual operation
- *                      in this function, so don't request it unless you need it.
+ *               NULL = Do NOT check for carry.  The carry is located in the
+ *                      same pass as the sum, so it's cheap, but don't request
+ *                      it unless you need it.
  *               Examples of when carry is set or not set:
  *                   8 + 5 = 13 is what we're looking for.
  *                  35 + 7 = 42 is NOT what we're looking for.
@@ -867,53 +1110,30 @@ bcd_significand_add(significand_t *val1,
 
     do
     {
-      /* If we're checking for carry, locate the high-order significant digit
-       * before we add.  carry_digit is set to the highest non-zero digit in
-       * val1 and val2. */
-      int carry_digit = 0;
-      if(carry != (bool *) 0)
-      {
-        for(carry_digit = 0; carry_digit < BCD_NUM_DIGITS; carry_digit++)
-        {
-          if( (bcd_sig_get_digit(val1, carry_digit) != 0) || (bcd_sig_get_digit(val2, carry_digit) != 0) )
-          {
-            break;
-          }
-        }
-      }
-
-      /* We'll change this if we encounter an actual overflow. */
-      *overflow = 0;
-
-      /* Loop through all of the significand_section_t chunks, starting with
-       * the least significant. */
+      /* Add the words, starting with the least significant.  The carry ripples
+       * from one word to the next, and whatever falls off the top end is the
+       * overflow.
+       *
+       * If we're checking for carry, we need to locate the high-order
+       * significant digit before we add.  lead_digit is set to the highest
+       * non-zero digit in val1 and val2.  We have to read both words before we
+       * write the sum, because dst can point to val1 or val2. */
+      int lead_digit = BCD_NUM_DIGITS_INTERNAL;
+      uint8_t c = 0;
       int i;
-      for(i = (SIGNIFICAND_SECTIONS_INTERNAL - 1); i >= 0; i--)
+      for(i = (SIGNIFICAND_WORDS_INTERNAL - 1); i >= 0; i--)
       {
-        significand_large_section_t sum;
-
-        /* Add the 2 sections. */
-        if((retcode = bcd_add_half_width(val1->s[i], val2->s[i], &sum)) != true) { break; }
-        dst->s[i] = (sum & SIGNIFICAND_SECTION_MASK);
-        BCD_PRINT(BCD_DBG_SIGNIFICAND_ADD, "%s() LOOP: %s\n", __func__, bcd_sig_section_to_str(dst->s[i]));
+        significand_word_t w1 = bcd_sig_get_word(val1, i);
+        significand_word_t w2 = bcd_sig_get_word(val2, i);
 
-        /* Handle carry. */
-        if((sum >> (SIGNIFICAND_DIGITS_PER_SECTION * 4)) > 0)
+        if((w1 | w2) != 0)
         {
-          if(i > 0)
-          {
-            uint8_t tmp_overflow;
-            significand_t ovf = { .s = { 0 } };
-            ovf.s[i - 1] = 1;
-            if(bcd_significand_add(val1, &ovf, val1, 0, &tmp_overflow) != true) { break; }
-            *overflow += tmp_overflow;
-          }
-          else
-          {
-            (*overflow)++;
-          }
+          lead_digit = (i * SIGNIFICAND_DIGITS_PER_WORD) + (__builtin_clzll(w1 | w2) / 4);
         }
+
+        bcd_sig_set_word(dst, i, bcd_add_word(w1, w2, &c));
       }
+      *overflow = c;
 
       BCD_PRINT(BCD_DBG_SIGNIFICAND_ADD, "%s() AFTER LOOP: %s: 0x%X\n", __func__, bcd_sig_to_str(dst), *overflow);
 
@@ -921,6 +1141,7 @@ bcd_significand_add(significand_t *val1,
        * was a carry at the end. */
       if(carry != (bool *) 0)
       {
+        int carry_digit = min(lead_digit, BCD_NUM_DIGITS);
         *carry = (carry_digit > 0) ? ((bcd_sig_get_digit(dst, (carry_digit - 1)) != 0ll) ? true : false) : 0;
       }
 
@@ -932,41 +1153,56 @@ bcd_significand_add(significand_t *val1,
   return retcode;
 }
 
-/* Perform a 10's complement on a BCD significand.  This changes positives to
- * negatives and negatives to positives.
+/* Perform a straight subtraction of 2 significands.  No exponents or signs
+ * are involved.  That needs to be taken care of somewhere else.  This method
+ * does nothing more than subtract val2 from val1 and return the result.
  *
  * Input:
- *   src  = A pointer to the significand.  We don't need the sign or exponent.
+ *   val1      = A pointer to the significand to subtract from.
  *
- *   dst  = A pointer to the place to store the result.  Note that dst can
- *          point to src.
+ *   val2      = A pointer to the significand to subtract.
+ *
+ *   dst       = A pointer to the place to store the result.  Note that dst can
+ *               point to val1 or val2.
+ *
+ *   borrow    = A pointer to the borrow.  On input it contains the borrow (0 or
+ *               1) to take out of the lowest digit.  On output it is set to 1
+ *               if val2 (plus the borrow) was larger than val1.  In that case
+ *               *dst contains the 10's complement of the difference.  Chaining
+ *               the borrow allows the caller to subtract numbers that are
+ *               spread across more than one significand.
  *
  * Output:
- *   true  = success.  *dst contains the 10's complement of src.
- *   false = failure.  *dst is undefined.
+ *   true  = success.  *dst and *borrow contain the difference.
+ *   false = failure.  *dst and *borrow are undefined.
  */
 static bool
-bcd_tens_complement(significand_t *src,
-                    significand_t *dst)
+bcd_significand_sub(significand_t *val1,
+                    significand_t *val2,
+                    significand_t *dst,
+                    uint8_t       *borrow)
 {
   bool retcode = false;
 
-  if(dst != (significand_t *) 0)
+  if( (  val1 != (significand_t *) 0) &&
+      (  val2 != (significand_t *) 0) &&
+      (   dst != (significand_t *) 0) &&
+      (borrow != (uint8_t *) 0) )
   {
-    BCD_PRINT(BCD_DBG_TENS_COMPLEMENT, "%s(): src: %s.\n", __func__, bcd_sig_to_str(src));
+    BCD_PRINT(BCD_DBG_SIGNIFICAND_SUB, "%s(%s, %s)\n", __func__, bcd_sig_to_str(val1), bcd_sig_to_str(val2));
 
-    /* Do a 9's complement first. */
+    /* Subtract the words, starting with the least significant.  The borrow
+     * ripples from one word to the next. */
     int i;
-    for(i = 0; i < SIGNIFICAND_SECTIONS_INTERNAL; i++)
+    for(i = (SIGNIFICAND_WORDS_INTERNAL - 1); i >= 0; i--)
     {
-      dst->s[i] = SIGNIFICAND_SECT_TENS_COMPLEMENT_VAL - src->s[i];
+      significand_word_t w1 = bcd_sig_get_word(val1, i);
+      significand_word_t w2 = bcd_sig_get_word(val2, i);
+      bcd_sig_set_word(dst, i, bcd_sub_word(w1, w2, borrow));
     }
 
-    /* Now add 1 to complete the 10's complement. */
-    uint8_t overflow;
-    significand_t one = { .s[SIGNIFICAND_SECTIONS_INTERNAL - 1] = 1 };
-    retcode = bcd_significand_add(dst, &one, dst, NULL, &overflow);
-    BCD_PRINT(BCD_DBG_TENS_COMPLEMENT, "%s(): dst: %s.\n", __func__, bcd_sig_to_str(dst));
+    BCD_PRINT(BCD_DBG_SIGNIFICAND_SUB, "%s() RESULT: %s: %d\n", __func__, bcd_sig_to_str(dst), *borrow);
+    retcode = true;
   }
 
   return retcode;
@@ -1034,7 +1270,7 @@ bcd_make_exponents_equal(significand_t *op1,
   return retcode;
 }
 
-/* Shift the significand to remove leading zeroes.
+/* Shift the significand to remove leading zeroes.  Zero is left alone.
  *
  * Input:
  *   sig = A pointer to the significand.
@@ -1053,114 +1289,151 @@ bcd_sig_remove_leading_zeroes(significand_t *sig,
 
   if((sig != (significand_t *) 0) && (exp != (int16_t *) 0))
   {
-    /* Set the success retcode before we do the shift.  That way we'll be able
-     * to detect failures. */
-    retcode = true;
-
-    while((bcd_sig_is_zero(sig) == false) && (bcd_sig_get_digit(sig, 0) == 0))
+    /* Count the leading zeroes and get rid of all of them in one shift. */
+    int zeroes = bcd_sig_leading_zeroes(sig);
+    if((zeroes > 0) && (zeroes < BCD_NUM_DIGITS_INTERNAL))
     {
-      if((retcode = bcd_shift_significand(sig, -1)) != true)
-      {
-        break;
-      }
-      *exp = *exp - 1;
+      retcode = bcd_shift_significand(sig, (0 - zeroes));
+      *exp = *exp - zeroes;
+    }
+    else
+    {
+      retcode = true;
     }
   }
 
   return retcode;
 }
 
-/******************************************************************************
- ********************************* PUBLIC OPS *********************************
- *****************************************************************************/
-
-/* This is the BCD addition function.
+/* Add a signed value to an operand.  This is the engine behind both
+ * operand_base_10_op_add() and operand_base_10_op_sub().  Subtraction is
+ * nothing more than addition with the sign of the 2nd operand flipped.
+ *
+ * If the signs are the same, we add the magnitudes and the sum has the same
+ * sign.  If the signs are different, we compare the magnitudes, subtract the
+ * smaller one from the larger one, and the difference has the sign of the
+ * larger one.  Either way it's one pass over the significands (plus a compare).
  *
  * Input:
- *   op1  = A pointer to the first operand.  The result is returned in this one.
+ *   op1   = A pointer to the first operand.  The result is returned in this
+ *           one.
  *
- *   op2  = The other operand.  Addtion is BINARY.
+ *   op2   = A pointer to the second operand.  It isn't modified.
+ *
+ *   sign2 = The sign to use for op2.
  *
  * Output:
  *   true  = success.  op1 contains the sum.
  *   false = failure.
  */
-bool
-operand_base_10_op_add(operand_base_10 *op1,
-                       operand_base_10 *op2)
+static bool
+bcd_signed_add(operand_base_10       *op1,
+               const operand_base_10 *op2,
+               uint8_t                sign2)
 {
   bool retcode = false;
 
-  if((op1 != (operand_base_10 *) 0) && (op2 != (operand_base_10 *) 0))
+  do
   {
-    do
+    /* Work with a copy of op2 so the caller's object isn't disturbed when we
+     * line up the exponents. */
+    significand_t *sig1 = &op1->significand;
+    significand_t  sig2 = op2->significand;
+    int16_t        exp2 = op2->exponent;
+    BCD_PRINT(BCD_DBG_OP_ADD, "%s()           BEGIN: %s + %s\n", __func__, bcd_sig_to_str(sig1), bcd_sig_to_str(&sig2));
+
+    /* If the exponents aren't the same, adjust the smaller number up to the other. */
+    if((retcode = bcd_make_exponents_equal(sig1, &op1->exponent, &sig2, &exp2)) != true) break;
+
+    /* Same signs.  Add the magnitudes.  If overflow, shift significand,
+     * insert overflow, bump exponent. */
+    if(op1->sign == sign2)
     {
-      significand_t *sig1 = &op1->significand;
-      significand_t *sig2 = &op2->significand;
-      BCD_PRINT(BCD_DBG_OP_ADD, "%s()           BEGIN: %s + %s\n", __func__, bcd_sig_to_str(sig1), bcd_sig_to_str(sig2));
-
-      /* If the exponents aren't the same, adjust the smaller number up to the other. */
-      if((retcode = bcd_make_exponents_equal(sig1, &op1->exponent, sig2, &op2->exponent)) != true) break;
-
-      /* If either num is negative, do a 10's complement before the addition. */
-      if(op1->sign == true) { if((retcode = bcd_tens_complement(sig1, sig1)) == false) break; }
-      if(op2->sign == true) { if((retcode = bcd_tens_complement(sig2, sig2)) == false) break; }
-      BCD_PRINT(BCD_DBG_OP_ADD, "%s() 10'S COMPLEMENT: %s, %s\n", __func__, bcd_sig_to_str(sig1), bcd_sig_to_str(sig2));
-
       uint8_t overflow;
-      if((retcode = bcd_significand_add(sig1, sig2, sig1, NULL, &overflow)) != true) { break; }
+      if((retcode = bcd_significand_add(sig1, &sig2, sig1, NULL, &overflow)) != true) break;
       BCD_PRINT(BCD_DBG_OP_ADD, "%s():         RESULT: %s: overflow %d\n", __func__, bcd_sig_to_str(sig1), overflow);
 
-      /* If exactly one of the operands is negative:
-       * - If we have overflow, then the result is positive.
-       * - If we have no overflow, then the result is negative.
-       */
-      if(op1->sign != op2->sign)
+      if(overflow != 0)
       {
-        if(overflow == 0)
-        {
-          if((retcode = bcd_tens_complement(sig1, sig1)) == false) break;
-        }
-        op1->sign = (overflow == 0) ? true : false;
+        if((retcode = bcd_shift_significand(sig1, 1)) != true) break;
+        if((retcode = bcd_sig_set_digit(sig1, 0, overflow)) != true) break;
+        op1->exponent++;
       }
+    }
 
-      /* Otherwise the signs are the same.  The sum will have the same sign. */
-      else
+    /* Different signs.  Subtract the smaller magnitude from the larger one.
+     * The result takes the sign of the larger one. */
+    else
+    {
+      uint8_t borrow = 0;
+      int cmp = bcd_sig_cmp(sig1, 0, &sig2, 0);
+      if(cmp >= 0)
       {
-        /* If the result is negative, do 10s complement now. */
-        if(op1->sign == true)
-        {
-          if((retcode = bcd_tens_complement(sig1, sig1)) == false) break;
-          overflow ^= 1;
-        }
-
-        /* If overflow, shift significand, insert overflow, bump exponent. */
-        if(overflow != 0)
+        if((retcode = bcd_significand_sub(sig1, &sig2, sig1, &borrow)) != true) break;
+        if(cmp == 0)
         {
-          if((retcode = bcd_shift_significand(sig1, 1)) != true) break;
-          if((retcode = bcd_sig_set_digit(sig1, 0, overflow)) != true) break;
-          op1->exponent++;
+          op1->sign = false;
         }
       }
-      BCD_PRINT(BCD_DBG_OP_ADD, "%s()        OVERFLOW: %s %d %d.\n", __func__, bcd_sig_to_str(sig1), op1->exponent, op1->sign);
+      else
+      {
+        if((retcode = bcd_significand_sub(&sig2, sig1, sig1, &borrow)) != true) break;
+        op1->sign = sign2;
+      }
+      BCD_PRINT(BCD_DBG_OP_ADD, "%s():         RESULT: %s: sign %d\n", __func__, bcd_sig_to_str(sig1), op1->sign);
+    }
 
-      /* Clear out any leading zeroes in the significand. */
-      if((retcode = bcd_sig_remove_leading_zeroes(sig1, &op1->exponent)) != true) break;
-      BCD_PRINT(BCD_DBG_OP_ADD, "%s()    CLEAR ZEROES: %s %d %d.\n", __func__, bcd_sig_to_str(sig1), op1->exponent, op1->sign);
+    /* Clear out any leading zeroes in the significand.  A zero result is
+     * always a plain positive zero, no matter where the exponents were. */
+    if(bcd_sig_is_zero(sig1) == true)
+    {
+      op1->exponent = 0;
+      op1->sign     = false;
+    }
+    if((retcode = bcd_sig_remove_leading_zeroes(sig1, &op1->exponent)) != true) break;
+    BCD_PRINT(BCD_DBG_OP_ADD, "%s()    CLEAR ZEROES: %s %d %d.\n", __func__, bcd_sig_to_str(sig1), op1->exponent, op1->sign);
+
+    /* Done.  Set the object to reflect the fact that we calculated the value.
+     * This is no longer data that came in through operand_base_10_add_char(). */
+    op1->char_count        = 0;
+    op1->got_decimal_point = false;
+    retcode                = true;
+  } while(0);
 
-      /* Done.  Set the object to reflect the fact that we calculated the value.
-       * This is no longer data that came in through bcd_add_char(). */
-      op1->char_count        = 0;
-      op1->got_decimal_point = false;
-      retcode                = true;
-    } while(0);
+  return retcode;
+}
+
+/******************************************************************************
+ ********************************* PUBLIC OPS *********************************
+ *****************************************************************************/
+
+/* This is the BCD addition function.
+ *
+ * Input:
+ *   op1  = A pointer to the first operand.  The result is returned in this one.
+ *
+ *   op2  = The other operand.  Addtion is BINARY.
+ *
+ * Output:
+ *   true  = success.  op1 contains the sum.
+ *   false = failure.
+ */
+bool
+operand_base_10_op_add(operand_base_10       *op1,
+                       const operand_base_10 *op2)
+{
+  bool retcode = false;
+
+  if((op1 != (operand_base_10 *) 0) && (op2 != (operand_base_10 *) 0))
+  {
+    retcode = bcd_signed_add(op1, op2, op2->sign);
   }
     
   return retcode;
 }
 
-/* This is the BCD subtraction function.  Subtraction is nothing more than 10's
- * complement addition.
+/* This is the BCD subtraction function.  Subtraction is nothing more than
+ * addition with the sign of op2 flipped.
  *
  * Input:
  *   op1  = A pointer to the first operand.  The result is returned in this one.
@@ -1172,103 +1445,36 @@ operand_base_10_op_add(operand_base_10 *op1,
  *   false = failure.
  */
 bool
-operand_base_10_op_sub(operand_base_10 *op1,
-                       operand_base_10 *op2)
+operand_base_10_op_sub(operand_base_10       *op1,
+                       const operand_base_10 *op2)
 {
   bool retcode = false;
 
   if((op1 != (operand_base_10 *) 0) && (op2 != (operand_base_10 *) 0))
   {
-    do
-    {
-      operand_base_10 *op2_copy = (operand_base_10 *) 0;
-
-      if((op2_copy = operand_base_10_new()) == (operand_base_10 *) 0) { break; }
-      if(operand_base_10_copy(op2, op2_copy) == false)                { break; }
+    BCD_PRINT(BCD_DBG_OP_SUB, "%s()           BEGIN: %s - %s\n", __func__, bcd_sig_to_str(&op1->significand), bcd_sig_to_str(&op2->significand));
 
-      /* Start with the raw significands. */
-      significand_t *sig1 = &op1->significand;
-      significand_t *sig2 = &op2_copy->significand;
-      BCD_PRINT(BCD_DBG_OP_SUB, "%s()           BEGIN: %s - %s\n", __func__, bcd_sig_to_str(sig1), bcd_sig_to_str(sig2));
-
-      /* If the exponents aren't the same, adjust the smaller number up to the other. */
-      if((retcode = bcd_make_exponents_equal(sig1, &op1->exponent, sig2, &op2_copy->exponent)) != true) break;
+    /* op1 - 0 = op1. */
+    if(bcd_sig_is_zero(&op2->significand) == true)
+    {
+      retcode = true;
+    }
 
-      /* op1 - 0 = op1. */
-      if(bcd_sig_is_zero(&op2_copy->significand) == true)
+    /* 0 - op2 = -op2. */
+    else if(bcd_sig_is_zero(&op1->significand) == true)
+    {
+      if(operand_base_10_copy(op2, op1) == true)
       {
+        op1->sign = (op1->sign == true) ? false : true;
         retcode = true;
       }
+    }
 
-      /* 0 - op2 = -op2. */
-      else if(bcd_sig_is_zero(&op1->significand) == true)
-      {
-        if(operand_base_10_copy(op2, op1) == true)
-        {
-          op1->sign = (op1->sign == true) ? false : true;
-          retcode = true;
-        }
-      }
-
-      /* op1 and op2 are both != 0. */
-      else
-      {
-        /* 10s complement (as required):
-         * POS - POS  = 10's complement b.
-         * POS - NEG  = NO 10's complement.
-         * NEG - POS  = NO 10's complement.
-         * NEG - NEG  = 10's complement a.
-         */
-        if((op1->sign == false) && (op2_copy->sign == false)) { if((retcode = bcd_tens_complement(sig2, sig2)) == false) break; }
-        if((op1->sign ==  true) && (op2_copy->sign ==  true)) { if((retcode = bcd_tens_complement(sig1, sig1)) == false) break; }
-        BCD_PRINT(BCD_DBG_OP_SUB, "%s() 10'S COMPLEMENT: %s, %s\n", __func__, bcd_sig_to_str(sig1), bcd_sig_to_str(sig2));
-
-        uint8_t overflow;
-        if((retcode = bcd_significand_add(sig1, sig2, sig1, NULL, &overflow)) != true) break;
-        BCD_PRINT(BCD_DBG_OP_SUB, "%s():         RESULT: %s CARRY: %d.\n", __func__, bcd_sig_to_str(sig1), overflow);
-
-        /* 10s complement (as required) and set the result sign:
-         * POS - POS  = Sign is defined by overflow.
-         * POS - NEG  = Sign is positive.
-         * NEG - POS  = Sign is negative.
-         * NEG - NEG  = Sign is defined by overflow.
-         */
-        if((op1->sign == false) && (op2_copy->sign == false))
-        {
-          op1->sign = ((overflow != 0) ? false : true);
-          if(op1->sign == true)
-          {
-            if((retcode = bcd_tens_complement(sig1, &op1->significand)) != true) break;
-            BCD_PRINT(BCD_DBG_OP_SUB, "%s():       NEGATIVE: %s.\n", __func__, bcd_sig_to_str(sig1));
-          }
-        }
-        else if((op1->sign == true) && (op2_copy->sign == true))
-        {
-          op1->sign = (overflow != 0) ? false : true;
-          if(op1->sign == true)
-          {
-            if((retcode = bcd_tens_complement(sig1, &op1->significand)) != true) break;
-            BCD_PRINT(BCD_DBG_OP_SUB, "%s():       NEGATIVE: %s.\n", __func__, bcd_sig_to_str(sig1));
-          }
-        }
-        else
-        {
-          op1->sign = (op1->sign == false) ? false : true;
-        }
-
-        /* Clear out any leading zeroes in the significand. */
-        if((retcode = bcd_sig_remove_leading_zeroes(sig1, &op1->exponent)) != true) break;
-        BCD_PRINT(BCD_DBG_OP_SUB, "%s():          SHIFT: %s %d %d.\n", __func__, bcd_sig_to_str(sig1), op1->exponent, op1->sign);
-
-        /* Done.  Set the object to reflect the fact that we calculated the value.
-         * This is no longer data that came in through operand_base_10_add_char(). */
-        op1->char_count        = 0;
-        op1->got_decimal_point = false;
-      }
-
-      operand_base_10_delete(op2_copy);
-
-    } while(0);
+    /* op1 and op2 are both != 0. */
+    else
+    {
+      retcode = bcd_signed_add(op1, op2, (op2->sign == true) ? false : true);
+    }
   }
     
   return retcode;
@@ -1283,11 +1489,12 @@ operand_base_10_op_sub(operand_base_10 *op1,
  *
  * Output:
  *   true  = success.  op1 contains the product.
- *   false = failure.
+ *   false = failure.  i.e. the product's exponent doesn't fit in an int16_t.
+ *                     op1 is undefined.
  */
 bool
-operand_base_10_op_mul(operand_base_10 *op1,
-                       operand_base_10 *op2)
+operand_base_10_op_mul(operand_base_10       *op1,
+                       const operand_base_10 *op2)
 {
   bool retcode = false;
 
@@ -1297,123 +1504,85 @@ operand_base_10_op_mul(operand_base_10 *op1,
     {
       /* Start with the raw significands. */
       significand_t *sig1 = &op1->significand;
-      significand_t *sig2 = &op2->significand;
+      significand_t  sig2_copy = op2->significand, *sig2 = &sig2_copy;
+      int16_t        exp2 = op2->exponent;
       BCD_PRINT(BCD_DBG_OP_MUL, "%s():          BEGIN: %s * %s\n", __func__, bcd_sig_to_str(sig1), bcd_sig_to_str(sig2));
 
-      /* Normalize both numbers before we begin.  We need the exponents. */
+      /* Normalize both numbers before we begin.  We need the exponents.  op2
+       * is normalized in a copy, so that it can be a read-only constant. */
       if((retcode = bcd_sig_remove_leading_zeroes(sig1, &op1->exponent)) != true) break;
-      if((retcode = bcd_sig_remove_leading_zeroes(sig2, &op2->exponent)) != true) break;
-
-      /* We'll store the result here. */
-      significand_t result_hi = { .s = { 0 } }, result_lo = { .s = { 0 } };
+      if((retcode = bcd_sig_remove_leading_zeroes(sig2, &exp2)) != true) break;
 
-      bool carry = false;
+      /* Zero times anything is zero. */
+      if((bcd_sig_is_zero(sig1) == true) || (bcd_sig_is_zero(sig2) == true))
+      {
+        if((retcode = bcd_sig_initialize(sig1)) != true) break;
+        op1->exponent = 0;
+      }
 
-      int b_digit;
-      for(b_digit = BCD_NUM_DIGITS_INTERNAL; b_digit > 0; b_digit--)
+      else
       {
-        int a_digit;
-        for(a_digit = BCD_NUM_DIGITS_INTERNAL; a_digit > 0; a_digit--)
+        /* Convert both significands to limbs, and then multiply them one
+         * column at a time.  Each column sum is accumulated in a binary
+         * integer, and whatever doesn't fit in the column's limb is carried
+         * into the next column.  The result is twice as wide as the operands
+         * (result_hi:result_lo). */
+        uint32_t a[BCD_LIMBS_INTERNAL], b[BCD_LIMBS_INTERNAL], prod[BCD_LIMBS_INTERNAL * 2];
+        bcd_sig_to_limbs(sig1, a);
+        bcd_sig_to_limbs(sig2, b);
+
+        uint64_t column = 0;
+        int k;
+        for(k = 0; k < ((BCD_LIMBS_INTERNAL * 2) - 1); k++)
         {
-          /* 1. Get the 2 digits into a_byte and b_byte.
-           *
-           * 2. If either is zero, continue (zero time anything is zero).
-           *
-           * 3. Multiply them.  This creates a hex result (stored in prod).
-           *
-           * 4. Convert the hex result into a base-10 result (res_digit) and
-           *    remainder (rem_digit).
-           */
-          uint8_t a_byte = bcd_sig_get_digit(sig1, (a_digit - 1));
-          uint8_t b_byte = bcd_sig_get_digit(sig2, (b_digit - 1));
-          if((a_byte == 0) || (b_byte == 0)) continue;
-          uint8_t prod = a_byte * b_byte;
-          uint8_t res_digit = (prod / 10);
-          uint8_t rem_digit = (prod % 10);
-
-          carry = (res_digit > 0) ? true : false;
-
-          /* 1. Set remain_digit and result_digit to the position (relative to
-           *    the left-hand edge of result_hi:result_lo) where the result and
-           *    remainder should be added into the total.
-           * 
-           * 2. Set remain_sig and result_sig to point to either result_hi or
-           *    result_lo, depending on where they fall in the result space.
-           *
-           * 3. Adjust remain_digit and result_digit to their position (relative
-           *    to either result_hi or result_lo).
-           *
-           * 4. Set result and remain to contain the actual result and remain
-           *    digits (positioned correctly).
-           */
-          int remain_digit = (b_digit + a_digit) - 1;
-          int result_digit = remain_digit - 1;
-          significand_t *remain_sig = (remain_digit < BCD_NUM_DIGITS_INTERNAL) ? &result_hi : &result_lo;
-          significand_t *result_sig = (result_digit < BCD_NUM_DIGITS_INTERNAL) ? &result_hi : &result_lo;
-          remain_digit %= BCD_NUM_DIGITS_INTERNAL;
-          result_digit %= BCD_NUM_DIGITS_INTERNAL;
-          significand_t remain;
-          significand_t result;
-          if((retcode = bcd_sig_initialize(&remain))                         != true) break;
-          if((retcode = bcd_sig_initialize(&result))                         != true) break;
-          if((retcode = bcd_sig_set_digit(&remain, remain_digit, rem_digit)) != true) break;
-          if((retcode = bcd_sig_set_digit(&result, result_digit, res_digit)) != true) break;
-
-          /* Create this, in case we need to do an overflow addition. */
-          significand_t overflo_val = { .s = { 0 } };
-          overflo_val.s[SIGNIFICAND_SECTIONS_INTERNAL - 1] = 1;
-
-          /* Now we're ready to add remain and result to the result_hi:result_lo total. */
-          uint8_t overflow;
-          bool tmp_carry = false;
-          if(rem_digit != 0)
+          int i;
+          for(i = max(0, (k - (BCD_LIMBS_INTERNAL - 1))); i <= min(k, (BCD_LIMBS_INTERNAL - 1)); i++)
           {
-            if((retcode = bcd_significand_add(remain_sig, &remain, remain_sig, &tmp_carry, &overflow)) != true) break;
-            carry = (tmp_carry == true) ? true : carry;
-
-            if((overflow != 0) && (remain_sig == &result_lo))
-            {
-              if((retcode = bcd_significand_add(&result_hi, &overflo_val, &result_hi, &tmp_carry, &overflow)) != true) break;
-              carry = (tmp_carry == true) ? true : carry;
-            }
+            column += ((uint64_t) a[i]) * b[k - i];
           }
-          if(res_digit != 0)
-          {
-            if((retcode = bcd_significand_add(result_sig, &result, result_sig, &tmp_carry, &overflow)) != true) break;
-            carry = (tmp_carry == true) ? true : carry;
+          prod[k] = (uint32_t) (column % BCD_LIMB_BASE);
+          column /= BCD_LIMB_BASE;
+        }
+        prod[k] = (uint32_t) column;
 
-            if((overflow != 0) && (result_sig == &result_lo))
-            {
-              if((res_digit != 0) && (retcode = bcd_significand_add(&result_hi, &overflo_val, &result_hi, NULL, &overflow)) != true) break;
-            }
+        /* Convert the result back to BCD words, most significant first. */
+        significand_word_t result[SIGNIFICAND_WORDS_INTERNAL * 2];
+        for(k = 0; k < (SIGNIFICAND_WORDS_INTERNAL * 2); k++)
+        {
+          int lo = ((BCD_LIMBS_INTERNAL * 2) - 2) - (k * 2);
+          result[k] = bcd_limbs_to_word(prod[lo + 1], prod[lo]);
+        }
+        BCD_PRINT(BCD_DBG_OP_MUL, "%s(): RES: 0x%016llX 0x%016llX\n", __func__, (unsigned long long) result[0], (unsigned long long) result[1]);
+
+        /* Both operands are normalized, so the product has either 1 or 2
+         * digits in front of the decimal point.  If it has 2, we carried and
+         * need to bump the exponent.  Otherwise we drop the leading zero.  The
+         * digits that don't fit in op1 are truncated. */
+        int32_t exponent = (int32_t) op1->exponent + exp2;
+        if((result[0] >> ((sizeof(significand_word_t) * 8) - 4)) != 0)
+        {
+          exponent++;
+        }
+        else
+        {
+          for(k = 0; k < SIGNIFICAND_WORDS_INTERNAL; k++)
+          {
+            result[k] = (result[k] << 4) | (result[k + 1] >> ((sizeof(significand_word_t) * 8) - 4));
           }
-
-          BCD_PRINT(BCD_DBG_OP_MUL, "%s(): RES: %s:%s %s %d\n", __func__, bcd_sig_to_str(&result_hi), bcd_sig_to_str(&result_lo), carry ? "true" : "false", overflow);
         }
-      }
-      if(retcode != true) break;
 
-      /* Shift the result. */
-      op1->significand = result_lo;
-      while(bcd_sig_is_zero(&result_hi) == false)
-      {
-        if((retcode = bcd_shift_significand(&op1->significand, 1))  != true) { break; }
-        uint8_t c = bcd_sig_get_digit(&result_hi, (BCD_NUM_DIGITS_INTERNAL - 1));
-        if((retcode = bcd_shift_significand(&result_hi, 1))         != true) { break; }
-        if((retcode = bcd_sig_set_digit(&op1->significand, 0, c))   != true) { break; }
-      }
-
-      /* If the result is zero, then set the exponent to zero and leave. */
-      if(bcd_sig_is_zero(&op1->significand) == true)
-      {
-        op1->exponent = 0;
-      }
+        /* The product is too big (or too small) for the exponent. */
+        if((exponent < INT16_MIN) || (exponent > INT16_MAX))
+        {
+          retcode = false;
+          break;
+        }
+        op1->exponent = (int16_t) exponent;
 
-      else
-      {
-        /* Set the exponent. */
-        op1->exponent += op2->exponent;
-        if(carry == true) op1->exponent++;
+        for(k = 0; k < SIGNIFICAND_WORDS_INTERNAL; k++)
+        {
+          bcd_sig_set_word(sig1, k, result[k]);
+        }
       }
 
       /* Set the sign. */
@@ -1443,8 +1612,8 @@ operand_base_10_op_mul(operand_base_10 *op1,
  *   false = failure.
  */
 bool
-operand_base_10_op_div(operand_base_10 *op1,
-                       operand_base_10 *op2)
+operand_base_10_op_div(operand_base_10       *op1,
+                       const operand_base_10 *op2)
 {
   bool retcode = false;
 
@@ -1457,150 +1626,91 @@ operand_base_10_op_div(operand_base_10 *op1,
       /* Check for divide by zero. */
       if(bcd_sig_is_zero(&op2->significand) == true) break;
 
-      /* Delete leading zeroes from the divisor.  Adjust the exponent too.  We
+      /* Delete leading zeroes from both numbers.  Adjust the exponents too.  We
        * only need to do this if we're dealing with a user-supplied number.
-       * All other numbers won't have leading zeroes. */
-      if((retcode = bcd_sig_remove_leading_zeroes(&op2->significand, &op2->exponent)) != true) break;
-
-      /* We need to work in large data so we have room to calculate a fullsize
-       * quotient.  This allows for rounding at the end of the quotient. */
-      significand_t dividend_hi, dividend_lo;
-      significand_t  divisor_hi,  divisor_lo;
-      significand_t   result_hi,   result_lo;
-      significand_t     mask_hi,     mask_lo;
-      significand_t  add_one_hi,  add_one_lo;
-      if(bcd_sig_initialize(&dividend_hi) != true) break;
-      if(bcd_sig_initialize(&dividend_lo) != true) break;
-      if(bcd_sig_initialize( &divisor_hi) != true) break;
-      if(bcd_sig_initialize( &divisor_lo) != true) break;
-      if(bcd_sig_initialize(  &result_hi) != true) break;
-      if(bcd_sig_initialize(  &result_lo) != true) break;
-      if(bcd_sig_initialize(    &mask_hi) != true) break;
-      if(bcd_sig_initialize(    &mask_lo) != true) break;
-      if(bcd_sig_initialize(& add_one_hi) != true)  break;
-      if(bcd_sig_initialize(& add_one_lo) != true)  break;
-
-      if(bcd_sig_copy(&op1->significand, &dividend_hi) != true) break;
-      if(bcd_sig_copy(&op2->significand,  &divisor_hi) != true) break;
-
-      /* Set mask_hi to mark the range of significant digits in the divisor. */
-      {
-        int i;
-        if(bcd_sig_set_digit(&mask_hi, 0, 0xF) != true) break;
-        for(i = 0; (i < BCD_NUM_DIGITS) && (bcd_sig_cmp(&divisor_hi, &mask_hi, &divisor_hi, 0) != 0); i++)
-        {
-          if(bcd_sig_set_digit(&mask_hi, i, 0xF) != true) break;
-        }
-        BCD_PRINT(BCD_DBG_OP_DIV, "%s() MASK: Divisor %s: Mask %s\n", __func__, bcd_sig_to_str(&divisor_hi), bcd_sig_to_str(&mask_hi));
-      }
+       * All other numbers won't have leading zeroes.  The divisor is copied so
+       * the caller's object isn't disturbed. */
+      significand_t divisor = op2->significand;
+      int16_t divisor_exp = op2->exponent;
+      if((retcode = bcd_sig_remove_leading_zeroes(&divisor, &divisor_exp)) != true) break;
+      if((retcode = bcd_sig_remove_leading_zeroes(&op1->significand, &op1->exponent)) != true) break;
+      op1->exponent -= divisor_exp;
 
-      /* This identifies the digit position where we're currently calculating
-       * the quotient.  Each time we subtract the divisor from the dividend we
-       * will add 1 to the quotient. */
-      if(bcd_sig_set_digit(&add_one_hi, 0, 1) != true) break;
+      /* Set the sign. */
+      op1->sign = (op1->sign == op2->sign) ? false : true;
 
-      /* Loop here until we're done with the division.  We go until we have as
-       * much of 2 full significands as possible.  This should give us at least
-       * one extra digit (to allow for rounding).  Then we're done. */
-      bool done = false;
-      while(done == false)
+      /* Zero divided by anything is zero. */
+      if(bcd_sig_is_zero(&op1->significand) == false)
       {
-        /* Loop here as long as dividend (with mask) is >= divisor (with mask).
-         * There are 2 different tests that we do in order to figure that out:
-         * 1. dividend_hi > divisor_hi.
-         * 2. (dividend_hi == divisor_hi) && (dividend_lo >= divisor_lo). */
-        while( (bcd_sig_cmp(&divisor_hi, &mask_hi, &dividend_hi, &mask_hi) < 0) ||
-              ((bcd_sig_cmp(&divisor_hi, &mask_hi, &dividend_hi, &mask_hi) == 0) && (bcd_sig_cmp(&divisor_lo, &mask_lo, &dividend_lo, &mask_lo) <= 0)) )
+        /* Divide (dividend * base^(limbs + 1)) by the divisor.  The extra limbs
+         * give us more quotient digits than we can hold, plus at least one
+         * more to use for rounding. */
+        uint32_t num[(BCD_LIMBS_INTERNAL * 2) + 1] = { 0 };
+        uint32_t den[BCD_LIMBS_INTERNAL];
+        uint32_t quot[BCD_LIMBS_INTERNAL + 2];
+        bcd_sig_to_limbs(&op1->significand, &num[BCD_LIMBS_INTERNAL + 1]);
+        bcd_sig_to_limbs(&divisor, den);
+        bcd_limbs_divide(num, ((BCD_LIMBS_INTERNAL * 2) + 1), den, BCD_LIMBS_INTERNAL, quot);
+
+        /* Convert the quotient back to BCD words, most significant first. */
+        significand_word_t result[(BCD_LIMBS_INTERNAL + 2) / 2];
+        int result_words = (sizeof(result) / sizeof(significand_word_t));
+        int k;
+        for(k = 0; k < result_words; k++)
         {
-          BCD_PRINT(BCD_DBG_OP_DIV, "%s() LOOP_TOP: DIVIDEND: %s:%s\n", __func__, bcd_sig_to_str(&dividend_hi), bcd_sig_to_str(&dividend_lo));
-          BCD_PRINT(BCD_DBG_OP_DIV, "%s() LOOP_TOP: DIVISOR:  %s:%s\n", __func__, bcd_sig_to_str(&divisor_hi),  bcd_sig_to_str(&divisor_lo));
-          BCD_PRINT(BCD_DBG_OP_DIV, "%s() LOOP_TOP: MASK:     %s:%s\n", __func__, bcd_sig_to_str(&mask_hi),     bcd_sig_to_str(&mask_lo));
-          BCD_PRINT(BCD_DBG_OP_DIV, "%s() LOOP_TOP: RESULT:   %s:%s\n", __func__, bcd_sig_to_str(&result_hi),   bcd_sig_to_str(&result_lo));
-
-          uint8_t overflow;
-          significand_t value_tens;
-
-          significand_t *res = (bcd_sig_is_zero(&divisor_hi) == false) ? &result_hi  : &result_lo;
-          significand_t *one = (bcd_sig_is_zero(&divisor_hi) == false) ? &add_one_hi : &add_one_lo;
-          if(bcd_significand_add(res, one, res, NULL, &overflow) == false) break;
-
-          bool borrow = (bcd_sig_cmp(&dividend_lo, 0, &divisor_lo, 0) < 0) ? true : false;
-          if(bcd_tens_complement(&divisor_lo, &value_tens)                                   == false) break;
-          if(bcd_significand_add(&dividend_lo, &value_tens, &dividend_lo, NULL, &overflow)   == false) break;
+          int lo = ((BCD_LIMBS_INTERNAL + 2) - 2) - (k * 2);
+          result[k] = bcd_limbs_to_word(quot[lo + 1], quot[lo]);
+        }
+        BCD_PRINT(BCD_DBG_OP_DIV, "%s() RESULT: 0x%016llX 0x%016llX 0x%016llX\n", __func__,
+                  (unsigned long long) result[0], (unsigned long long) result[1], (unsigned long long) result[2]);
+
+        /* The ones digit of the quotient is the last digit of the first limb.
+         * Both numbers are normalized, so the first significant digit is
+         * either the ones digit or the one after it.  Line the first
+         * significant digit up with the left-hand edge of op1, and adjust the
+         * exponent to match. */
+        int zeroes = (BCD_LIMB_DIGITS - 1);
+        if((result[0] >> ((sizeof(significand_word_t) * 8) - (BCD_LIMB_DIGITS * 4))) == 0)
+        {
+          zeroes++;
+        }
+        op1->exponent += (BCD_LIMB_DIGITS - 1) - zeroes;
 
-          if(borrow == true)
+        int word_shift = (zeroes / SIGNIFICAND_DIGITS_PER_WORD);
+        int bit_shift  = (zeroes % SIGNIFICAND_DIGITS_PER_WORD) * 4;
+        for(k = 0; k < (result_words - word_shift); k++)
+        {
+          result[k] = result[k + word_shift] << bit_shift;
+          if((bit_shift != 0) && ((k + word_shift + 1) < result_words))
           {
-            significand_t one;
-            if(bcd_sig_initialize(&one) != true)  break;
-            if(bcd_sig_set_digit(&one, (BCD_NUM_DIGITS_INTERNAL - 1), 0x1) != true) break;
-            if(bcd_tens_complement(&one, &value_tens)                                        == false) break;
-            if(bcd_significand_add(&dividend_hi, &value_tens, &dividend_hi, NULL, &overflow) == false) break;
+            result[k] |= result[k + word_shift + 1] >> ((sizeof(significand_word_t) * 8) - bit_shift);
           }
-
-          if(bcd_tens_complement(&divisor_hi, &value_tens)                                   == false) break;
-          if(bcd_significand_add(&dividend_hi, &value_tens, &dividend_hi, NULL, &overflow)   == false) break;
-
-          BCD_PRINT(BCD_DBG_OP_DIV, "%s() LOOP_BOT: DIVIDEND: %s:%s\n", __func__, bcd_sig_to_str(&dividend_hi), bcd_sig_to_str(&dividend_lo));
-          BCD_PRINT(BCD_DBG_OP_DIV, "%s() LOOP_BOT: DIVISOR:  %s:%s\n", __func__, bcd_sig_to_str(&divisor_hi),  bcd_sig_to_str(&divisor_lo));
-          BCD_PRINT(BCD_DBG_OP_DIV, "%s() LOOP_BOT: MASK:     %s:%s\n", __func__, bcd_sig_to_str(&mask_hi),     bcd_sig_to_str(&mask_lo));
-          BCD_PRINT(BCD_DBG_OP_DIV, "%s() LOOP_BOT: RESULT:   %s:%s\n", __func__, bcd_sig_to_str(&result_hi),   bcd_sig_to_str(&result_lo));
         }
-
-        uint8_t c;
-        if((c = bcd_sig_get_digit(&divisor_hi, (BCD_NUM_DIGITS_INTERNAL - 1))) == 0xF) break;
-        if(bcd_shift_significand(&divisor_hi,       1) == false) break;
-        if(bcd_shift_significand(&divisor_lo,       1) == false) break;
-        if(bcd_sig_set_digit(&divisor_lo, 0, c) == false) break;
-
-        if((c = bcd_sig_get_digit(&add_one_hi, (BCD_NUM_DIGITS_INTERNAL - 1))) == 0xF) break;
-        if(bcd_shift_significand(&add_one_hi, 1) == false) break;
-        if(bcd_shift_significand(&add_one_lo, 1) == false) break;
-        if(bcd_sig_set_digit(&add_one_lo, 0, c) == false) break;
-
-        c = bcd_sig_get_digit(&mask_hi, (BCD_NUM_DIGITS_INTERNAL - 1));
-        if(bcd_shift_significand(&mask_hi, 1) == false) break;
-        if(bcd_sig_set_digit(&mask_hi, 0, 0xF) == false) break;
-        if(bcd_sig_get_digit(&mask_lo, (BCD_NUM_DIGITS_INTERNAL - 1)) == 0xF) { done = true; }
-        if(bcd_shift_significand(&mask_lo, 1) == false) break;
-        if(bcd_sig_set_digit(&mask_lo, 0, c) == false) break;
-      }
-      BCD_PRINT(BCD_DBG_OP_DIV, "%s() RESULT: %s:%s\n", __func__, bcd_sig_to_str(&result_hi), bcd_sig_to_str(&result_lo));
-
-      /* Copy the result to op1 so we can return it to the caller. */
-      if(bcd_sig_copy(&result_hi, &op1->significand) == false) break;
-
-      /* Set the exponent, and then adjust to account for any leading zeroes. */
-      {
-        bool shift_ok = true;
-        op1->exponent -= op2->exponent;
-        while((bcd_sig_is_zero(&op1->significand) == false) && ((bcd_sig_get_digit(&op1->significand, 0)) == 0))
+        for(k = 0; k < SIGNIFICAND_WORDS_INTERNAL; k++)
         {
-          char c;
-          if(bcd_shift_significand(&op1->significand, -1) != true)                            { shift_ok = false; break; }
-          if((c = bcd_sig_get_digit(&result_lo, 0)) == 0xF)                                   { shift_ok = false; break; }
-          if(bcd_sig_set_digit(&op1->significand, (BCD_NUM_DIGITS_INTERNAL - 1), c) == false) { shift_ok = false; break; }
-          if(bcd_shift_significand(&result_lo, -1) != true)                                   { shift_ok = false; break; }
-          op1->exponent--;
+          bcd_sig_set_word(&op1->significand, k, result[k]);
+        }
+        BCD_PRINT(BCD_DBG_OP_DIV, "%s() SHIFT: %s\n", __func__, bcd_sig_to_str(&op1->significand));
+
+        /* Now we need to round the result (if necessary).  The digit after the
+         * last one that fits in op1 is the guard digit.  If it's 5 or more, we
+         * round up.  If that carries all the way out of the top, the result is
+         * 1000..., and the exponent goes up by one. */
+        int guard = (BCD_NUM_DIGITS_INTERNAL / SIGNIFICAND_DIGITS_PER_WORD);
+        int guard_shift = ((SIGNIFICAND_DIGITS_PER_WORD - 1) - (BCD_NUM_DIGITS_INTERNAL % SIGNIFICAND_DIGITS_PER_WORD)) * 4;
+        if(((result[guard] >> guard_shift) & 0xF) > 4)
+        {
+          uint8_t overflow;
+          significand_t ulp = { .s = { 0 } };
+          if(bcd_sig_set_digit(&ulp, (BCD_NUM_DIGITS_INTERNAL - 1), 1) == false) break;
+          if(bcd_significand_add(&op1->significand, &ulp, &op1->significand, NULL, &overflow) == false) break;
+          if(overflow != 0)
+          {
+            if(bcd_shift_significand(&op1->significand, 1) == false) break;
+            if(bcd_sig_set_digit(&op1->significand, 0, overflow) == false) break;
+            op1->exponent++;
+          }
         }
-        if(shift_ok == false) break;
-      }
-      BCD_PRINT(BCD_DBG_OP_DIV, "%s() SHIFT: %s\n", __func__, bcd_sig_to_str(&op1->significand));
-
-      /* Set the sign. */
-      op1->sign = (op1->sign == op2->sign) ? false : true;
-
-      /* Now we need to round the result (if necessary).  We'll use the regular
-       * operand_base_10_op_add() function to do that step. */
-      char c;
-      if((c = bcd_sig_get_digit(&result_lo, 0)) == 0xF) break;
-      if(c > 4)
-      {
-        operand_base_10 *round;
-        if((round = operand_base_10_new()) == (operand_base_10 *) NULL) break;
-        if(bcd_sig_set_digit(&round->significand, (BCD_NUM_DIGITS_INTERNAL - 1), 1) == false) break;
-        round->sign = op1->sign;
-        round->exponent = op1->exponent;
-        if(operand_base_10_op_add(op1, round) == false) break;
       }
 
       /* Done.  Set the object to reflect the fact that we calculated the value.
@@ -1626,24 +1736,22 @@ operand_base_10_op_div(operand_base_10 *op1,
  *   false = failure.
  */
 bool
-operand_base_10_op_exp(operand_base_10 *op1,
-                       operand_base_10 *op2)
+operand_base_10_op_exp(operand_base_10       *op1,
+                       const operand_base_10 *op2)
 {
   bool retcode = false;
 
   do
   {
-    operator_exp *fp;
+    operator_exp fp;
 
     if((op1 == (operand_base_10 *) 0) || (op2 == (operand_base_10 *) 0)) { break; }
 
-    if((fp = operator_exp_new(op1, op2)) == (operator_exp *) 0)          { break; }
-
-    if(operator_exp_calc(fp) == false)                                   { break; }
+    if(operator_exp_init(&fp, op1, op2) == false)                        { break; }
 
-    if(operator_exp_get_result(fp, op1) == false)                        { break; }
+    if(operator_exp_calc(&fp) == false)                                  { break; }
 
-    retcode = operator_exp_delete(fp);
+    retcode = operator_exp_get_result(&fp, op1);
   } while(0);
     
   return retcode;
@@ -1662,7 +1770,7 @@ operand_base_10_op_exp(operand_base_10 *op1,
  *   Returns a pointer to the operations.
  *   Returns 0 if unable to return the pointer to the ops.
  */
-operand_api *
+const operand_api *
 operand_base_10_return_ops(void)
 {
   return &operand_base_10_ops;
@@ -1685,7 +1793,7 @@ operand_base_10_new(void)
 
   if(this != (operand_base_10 *) 0)
   {
-    if(operand_base_10_import(this, 0) == false)
+    if(operand_base_10_init(this) == false)
     {
       operand_base_10_delete(this);
       this = (operand_base_10 *) 0;
@@ -1695,6 +1803,27 @@ operand_base_10_new(void)
   return this;
 }
 
+/* Initialize a operand_base_10 object that lives in caller-owned storage (on
+ * the stack, or embedded in another struct).  The object is set to 0.  It's
+ * also okay to call this on an object that is already in use.  That resets it
+ * back to 0.
+ *
+ * Objects that are initialized this way must NOT be passed to
+ * operand_base_10_delete().
+ *
+ * Input:
+ *   this = A pointer to the caller-owned operand_base_10 object.
+ *
+ * Output:
+ *   true  = success.  this contains 0.
+ *   false = failure.  this is undefined.
+ */
+bool
+operand_base_10_init(operand_base_10 *this)
+{
+  return operand_base_10_import(this, 0);
+}
+
 /* Delete a operand_base_10 object that was created by operand_base_10_new().
  *
  * Input:
@@ -1736,6 +1865,40 @@ operand_base_10_add_char_is_valid_operand(char c)
   return retcode;
 }
 
+/* Check to see if operand_base_10_add_char() would drop a digit because the
+ * significand is already full.  Callers that need every digit (i.e. whole
+ * equations) use this to reject the operand instead of truncating it.  Leading
+ * zeros are always dropped, so they never count as lost.
+ *
+ * Input:
+ *   this = A pointer to the operand_base_10 object.
+ *
+ *   c    = The char that is about to be added.
+ *
+ * Output:
+ *   true  = c is a significant digit, and there's no room for it.
+ *   false = c will be added (or it isn't a digit).
+ */
+bool
+operand_base_10_add_char_is_full(const operand_base_10 *this,
+                                 char                   c)
+{
+  bool retcode = false;
+
+  if((this != (operand_base_10 *) 0) && (c >= '0') && (c <= '9'))
+  {
+    if((c == '0') && (this->got_decimal_point == false) && (bcd_sig_is_zero(&this->significand) == true))
+    {
+    }
+    else if(this->char_count >= BCD_NUM_DIGITS)
+    {
+      retcode = true;
+    }
+  }
+
+  return retcode;
+}
+
 /* Attempt to add a character to the operand_base_10 object.  It's checked to
  * see if it's a valid part of a decimal number.  If it's valid, it is added.
  * Note that it's possible for a character to be dropped because we don't have
@@ -1831,9 +1994,9 @@ operand_base_10_add_char(operand_base_10 *this,
  *   false = failure.  buf is undefined.
  */
 bool
-operand_base_10_to_str(operand_base_10  *this,
-                       char             *buf,
-                       size_t            buf_size)
+operand_base_10_to_str(const operand_base_10 *this,
+                       char                  *buf,
+                       size_t                 buf_size)
 {
   bool retcode = false;
 
@@ -1842,14 +2005,13 @@ operand_base_10_to_str(operand_base_10  *this,
     BCD_PRINT(BCD_DBG_TO_STR, "%s(): %s, %d, %d, %d.\n", __func__,
               bcd_sig_to_str(&this->significand), this->exponent, this->got_decimal_point, this->sign);
 
-    operand_base_10 *val = (operand_base_10 *) 0;
-    operand_base_10 *one = (operand_base_10 *) 0;
+    operand_base_10 val_obj;
+    operand_base_10 *val = &val_obj;
 
     do
     {
       /* Make a copy of this.  We might need to round it up, but we don't want
        * to change this.  So we'll change the copy. */
-      if((val = operand_base_10_new()) == (operand_base_10 *) 0)                      { break; }
       if(operand_base_10_copy(this, val) == false)                                    { break; }
 
       /* Figure out whether to use standard or scientific notation.
@@ -1880,14 +2042,12 @@ operand_base_10_to_str(operand_base_10  *this,
       /* If we need to round up, do it here. */
       if(carry_digit >= 5)
       {
-        if((one = operand_base_10_new()) == (operand_base_10 *) 0)                    { break; }
-        {
-          if(operand_base_10_import(one, 1) == false)                                 { break; }
-          if(bcd_shift_significand(&one->significand, (BCD_NUM_DIGITS - 1)) == false) { break; }
-          one->sign     = val->sign;
-          one->exponent = val->exponent;
-          if(operand_base_10_op_add(val, one) == false)                               { break; }
-        }
+        operand_base_10 one;
+        if(operand_base_10_copy(&operand_base_10_integers[1], &one) == false)         { break; }
+        if(bcd_shift_significand(&one.significand, (BCD_NUM_DIGITS - 1)) == false)   { break; }
+        one.sign     = val->sign;
+        one.exponent = val->exponent;
+        if(operand_base_10_op_add(val, &one) == false)                                { break; }
         BCD_PRINT(BCD_DBG_TO_STR, "%s(): ROUNDED: %s, %d, %d, %d.\n", __func__,
                   bcd_sig_to_str(&val->significand), val->exponent, val->got_decimal_point, val->sign);
       }
@@ -1944,9 +2104,6 @@ operand_base_10_to_str(operand_base_10  *this,
                                       buf_size);
       }
     } while(0);
-
-    operand_base_10_delete(one);
-    operand_base_10_delete(val);
   }
 
   return retcode;
@@ -1966,8 +2123,8 @@ operand_base_10_to_str(operand_base_10  *this,
  *   false = failure.  The contents of dst is undefined.
  */
 bool
-operand_base_10_copy(operand_base_10 *src,
-                     operand_base_10 *dst)
+operand_base_10_copy(const operand_base_10 *src,
+                     operand_base_10       *dst)
 {
   bool retcode = false;
 
@@ -1998,8 +2155,8 @@ operand_base_10_copy(operand_base_10 *src,
  *    1 if *obj1 >  *obj2.
  */
 int
-operand_base_10_cmp(operand_base_10 *obj1,
-                    operand_base_10 *obj2)
+operand_base_10_cmp(const operand_base_10 *obj1,
+                    const operand_base_10 *obj2)
 {
   int retval = 0;
 
@@ -2020,43 +2177,35 @@ operand_base_10_cmp(operand_base_10 *obj1,
       retval =  1;
     }
 
-    /* If they're either both positive or both negative. */
+    /* If they're either both positive or both negative, compare the
+     * magnitudes.  Normalize copies of the significands first, so that the
+     * exponents tell us which number is bigger.  If the exponents are the
+     * same, the significands decide. */
     else
     {
-      operand_base_10 *tmp_obj1 = operand_base_10_new();
-      operand_base_10 *tmp_obj2 = operand_base_10_new();
-      if((tmp_obj1 != (operand_base_10 *) 0) &&
-         (tmp_obj2 != (operand_base_10 *) 0) &&
-         (operand_base_10_copy(obj1, tmp_obj1) == true) &&
-         (operand_base_10_copy(obj2, tmp_obj2) == true))
+      significand_t sig1 = obj1->significand;
+      significand_t sig2 = obj2->significand;
+      int16_t       exp1 = obj1->exponent;
+      int16_t       exp2 = obj2->exponent;
+      if((bcd_sig_remove_leading_zeroes(&sig1, &exp1) == true) &&
+         (bcd_sig_remove_leading_zeroes(&sig2, &exp2) == true))
       {
-        /* Compare 2 positive numbers. */
-        if((obj1->sign == false) && (obj2->sign == false))
-        {
-          BCD_PRINT(BCD_DBG_CMP, "%s(): Comparing positive numbers.\n", __func__);
-          if(operand_base_10_op_sub(tmp_obj1, tmp_obj2) == true)
-          {
-            if(bcd_sig_is_zero(&tmp_obj1->significand)) { retval =  0; }
-            else if(tmp_obj1->sign == true)             { retval = -1; }
-            else                                        { retval =  1; }
-          }
-        }
+        bool zero1 = bcd_sig_is_zero(&sig1);
+        bool zero2 = bcd_sig_is_zero(&sig2);
 
+        if((zero1 == true) && (zero2 == true)) { retval =  0; }
+        else if(zero1 == true)                 { retval = -1; }
+        else if(zero2 == true)                 { retval =  1; }
+        else if(exp1 != exp2)                  { retval = (exp1 < exp2) ? -1 : 1; }
+        else                                   { retval = bcd_sig_cmp(&sig1, 0, &sig2, 0); }
 
-        /* Compare 2 negative numbers. */
-        else
+        /* The bigger of 2 negative numbers is the smaller one. */
+        if(obj1->sign == true)
         {
-          if(operand_base_10_op_sub(tmp_obj1, tmp_obj2) == true)
-          {
-            if(bcd_sig_is_zero(&tmp_obj1->significand)) { retval =  0; }
-            else if(tmp_obj1->sign == false)            { retval =  1; }
-            else                                        { retval = -1; }
-          }
+          BCD_PRINT(BCD_DBG_CMP, "%s(): Comparing negative numbers.\n", __func__);
+          retval = (0 - retval);
         }
       }
-
-      operand_base_10_delete(tmp_obj2);
-      operand_base_10_delete(tmp_obj1);
     }
   }
 
@@ -2086,31 +2235,34 @@ operand_base_10_import(operand_base_10 *this,
   {
     if(this == (operand_base_10 *) 0)                              { break; }
 
-    if(bcd_sig_initialize(&this->significand) == false)            { break; }
+    /* Get |src|.  It's unsigned, so that INT64_MIN doesn't overflow. */
+    uint64_t magnitude = (src < 0) ? (0 - (uint64_t) src) : (uint64_t) src;
 
-    /* Set the sign, and then set src = |src|. */
-    this->sign = 0;
-    if(src < 0)
+    /* Small integers come straight out of the constant table. */
+    if(magnitude <= OPERAND_BASE_10_MAX_INTEGER)
     {
-      this->sign = 1;
-      src = (0 - src);
+      *this = operand_base_10_integers[magnitude];
     }
 
-    this->exponent = 0;
-    while(src != 0)
+    else
     {
-      uint8_t digit = (src % 10);
+      if(bcd_sig_initialize(&this->significand) == false)          { break; }
 
-      if(bcd_shift_significand(&this->significand, 1) == false)    { break; }
+      /* Count the digits, and then drop them into place from right to left.
+       * The most significant digit lands in digit 0. */
+      int num_digits;
+      for(num_digits = 1; (num_digits < 20) && (magnitude >= operand_base_10_pow10[num_digits]); num_digits++);
 
-      if(bcd_sig_set_digit(&this->significand, 0, digit) == false) { break; }
-
-      if((src /= 10) != 0)
+      this->exponent = (num_digits - 1);
+      while(num_digits > 0)
       {
-        this->exponent++;
+        if(bcd_sig_set_digit(&this->significand, --num_digits, (magnitude % 10)) == false) { break; }
+        magnitude /= 10;
       }
+      if(num_digits > 0)                                           { break; }
     }
 
+    this->sign              = (src < 0) ? 1 : 0;
     this->got_decimal_point = false;
     this->char_count        = 0;
 
@@ -2134,8 +2286,8 @@ operand_base_10_import(operand_base_10 *this,
  *   false = failure.  The contents of dst is undefined.
  */
 bool
-operand_base_10_export(operand_base_10 *this,
-                       int64_t         *dst)
+operand_base_10_export(const operand_base_10 *this,
+                       int64_t               *dst)
 {
   bool retcode = false;
 
@@ -2168,6 +2320,80 @@ operand_base_10_export(operand_base_10 *this,
   return retcode;
 }
 
+/* Multiply this object by a power of 10.  This only touches the exponent, so
+ * it's exact and cheap.
+ *
+ * Input:
+ *   this  = A pointer to the operand_base_10 object.
+ *
+ *   power = The power of 10 to multiply by.  It can be negative.
+ *
+ * Output:
+ *   true  = success.  this has been scaled.
+ *   false = failure.  The exponent would overflow.  this is unchanged.
+ */
+bool
+operand_base_10_scale(operand_base_10 *this,
+                      int16_t          power)
+{
+  bool retcode = false;
+
+  do
+  {
+    if(this == (operand_base_10 *) 0)                        { break; }
+
+    /* Zero stays zero. */
+    if(bcd_sig_is_zero(&this->significand) == true)
+    {
+      retcode = true;
+      break;
+    }
+
+    int32_t exponent = (int32_t) this->exponent + power;
+    if((exponent < INT16_MIN) || (exponent > INT16_MAX))     { break; }
+
+    this->exponent = exponent;
+    retcode = true;
+  } while(0);
+
+  return retcode;
+}
+
+/* Get the power of 10 of the most significant digit of this object.  For
+ * example, it's 2 for 123.4, and -3 for 0.00567.  Zero returns 0.
+ *
+ * Input:
+ *   this     = A pointer to the operand_base_10 object.
+ *
+ *   exponent = A pointer to the location that will receive the exponent.
+ *
+ * Output:
+ *   true  = success.  *exponent contains the exponent.
+ *   false = failure.  *exponent is undefined.
+ */
+bool
+operand_base_10_get_exponent(const operand_base_10 *this,
+                             int16_t               *exponent)
+{
+  bool retcode = false;
+
+  do
+  {
+    if((this == (operand_base_10 *) 0) || (exponent == (int16_t *) 0)) { break; }
+
+    /* Values that were built by operand_base_10_add_char() can have leading
+     * zeroes, so normalize a copy first. */
+    significand_t sig = this->significand;
+    int16_t       exp = this->exponent;
+    if(bcd_sig_remove_leading_zeroes(&sig, &exp) == false)             { break; }
+
+    *exponent = (bcd_sig_is_zero(&sig) == true) ? 0 : exp;
+    retcode = true;
+  } while(0);
+
+  return retcode;
+}
+
 /* Return an ASCII string that contains debug information about this.
  *
  * Input:
@@ -2177,7 +2403,7 @@ operand_base_10_export(operand_base_10 *this,
  *   Returns a pointer to a string that contains the debug info.
  */
 const char *
-operand_base_10_get_dbg_info(operand_base_10 *this)
+operand_base_10_get_dbg_info(const operand_base_10 *this)
 {
   char *retval = "UNKNOWN";
 
@@ -2185,35 +2411,17 @@ operand_base_10_get_dbg_info(operand_base_10 *this)
   {
     if(this == (operand_base_10 *) 0)                                                   { break; }
 
-    /* This is a collection of buffers that is used for building strings.
+    /* This is a collection of buffers that is used for building strings.  Each
+     * thread has its own, so there's no need for locking.
      * NOTE: The size has to be a power of 2. */
-    static char *sig_msgs[8] = { 0 };
-    static char  sig_msgs_size = (sizeof(sig_msgs) / sizeof(sig_msgs[0]));
-    static int   sig_msgs_index = 0;
-    static int   sig_msg_size = 1024;
+    static _Thread_local char sig_msgs[8][1024];
+    static _Thread_local int  sig_msgs_index = 0;
+    const int sig_msgs_size = (sizeof(sig_msgs) / sizeof(sig_msgs[0]));
 
-    /* We allocate the pointers the first time we need them. */
-    if(sig_msgs[sig_msgs_index] == (char *) 0)
-    {
-      int alloc_size = (sig_msgs_size * sig_msg_size);
-      char *msg_buf = (char *) malloc(alloc_size);
-      if(msg_buf != (char *) 0)
-      {
-        int j;
-        for(j = 0; j < sig_msgs_size; j++)
-        {
-          sig_msgs[j] = msg_buf + (j * sig_msg_size);
-        }
-      }
-    }
-
-    if(sig_msgs[sig_msgs_index] != (char *) 0)
-    {
-      if(operand_base_10_to_str(this, sig_msgs[sig_msgs_index], sig_msg_size) == false) { break; }
+    if(operand_base_10_to_str(this, sig_msgs[sig_msgs_index], sizeof(sig_msgs[0])) == false) { break; }
 
-      retval = sig_msgs[sig_msgs_index];
-      sig_msgs_index = ((sig_msgs_index + 1) % sig_msgs_size);
-    }
+    retval = sig_msgs[sig_msgs_index];
+    sig_msgs_index = ((sig_msgs_index + 1) % sig_msgs_size);
   } while(0);
 
   return retval;
@@ -2240,7 +2448,7 @@ operand_base_10_test(void)
 #ifdef TEST_PRIMITIVES
   {
     {
-      printf("  Sig-Sect Tests (SIGNIFICAND_DIGITS_PER_SECTION = %d).\n", SIGNIFICAND_DIGITS_PER_SECTION);
+      printf("  Sig-Sect Tests (SIGNIFICAND_DIGITS_PER_SECTION = %d).\n", (int) SIGNIFICAND_DIGITS_PER_SECTION);
       int j;
       significand_section_t test_sect = { SIGNIFICAND_SECTION_MASK };
       for(j = 0; j < SIGNIFICAND_DIGITS_PER_SECTION; j++)
@@ -2337,6 +2545,59 @@ operand_base_10_test(void)
       if(bcd_sig_is_zero(&sig1) != true)                                                      return false;
     }
 
+    {
+      printf("  Sig Shift Tests.\n");
+      int j;
+      significand_t sig1 = { .s = { 0 } };
+      for(j = 0; j < BCD_NUM_DIGITS_INTERNAL; j++)
+      {
+        if(bcd_sig_set_digit(&sig1, j, ((j % 9) + 1)) != true)                                return false;
+      }
+
+      /* Shift across section and word boundaries in both directions. */
+      int shifts[] = { 1, 7, 8, 9, 15, 16, 17, 23, 31 };
+      int k;
+      for(k = 0; k < (sizeof(shifts) / sizeof(int)); k++)
+      {
+        significand_t sig2 = sig1;
+        if(bcd_shift_significand(&sig2, shifts[k]) != true)                                   return false;
+        if(bcd_sig_leading_zeroes(&sig2) != shifts[k])                                        return false;
+        for(j = 0; j < BCD_NUM_DIGITS_INTERNAL; j++)
+        {
+          int expected = (j < shifts[k]) ? 0 : bcd_sig_get_digit(&sig1, (j - shifts[k]));
+          if(bcd_sig_get_digit(&sig2, j) != expected)                                         return false;
+        }
+
+        sig2 = sig1;
+        if(bcd_shift_significand(&sig2, (0 - shifts[k])) != true)                             return false;
+        if(bcd_sig_num_digits(&sig2) != (BCD_NUM_DIGITS_INTERNAL - shifts[k]))               return false;
+        for(j = 0; j < BCD_NUM_DIGITS_INTERNAL; j++)
+        {
+          int expected = ((j + shifts[k]) >= BCD_NUM_DIGITS_INTERNAL) ? 0 : bcd_sig_get_digit(&sig1, (j + shifts[k]));
+          if(bcd_sig_get_digit(&sig2, j) != expected)                                         return false;
+        }
+      }
+
+      /* Shifting everything out leaves zero. */
+      significand_t sig2 = sig1;
+      if(bcd_shift_significand(&sig2, BCD_NUM_DIGITS_INTERNAL) != true)                       return false;
+      if(bcd_sig_is_zero(&sig2) != true)                                                      return false;
+      if(bcd_sig_leading_zeroes(&sig2) != BCD_NUM_DIGITS_INTERNAL)                            return false;
+      if(bcd_sig_num_digits(&sig2) != 0)                                                      return false;
+      sig2 = sig1;
+      if(bcd_shift_significand(&sig2, (0 - (BCD_NUM_DIGITS_INTERNAL + 5))) != true)          return false;
+      if(bcd_sig_is_zero(&sig2) != true)                                                      return false;
+
+      /* Remove leading zeroes in one step. */
+      int16_t exp = 0;
+      sig2 = sig1;
+      if(bcd_shift_significand(&sig2, 19) != true)                                            return false;
+      if(bcd_sig_remove_leading_zeroes(&sig2, &exp) != true)                                  return false;
+      if(exp != -19)                                                                          return false;
+      if(bcd_sig_get_digit(&sig2, 0) != 1)                                                    return false;
+      if(bcd_sig_num_digits(&sig2) != (BCD_NUM_DIGITS_INTERNAL - 19))                         return false;
+    }
+
     {
       printf("  Sig Copy and Compare.\n");
       int j;
@@ -2360,6 +2621,108 @@ operand_base_10_test(void)
       if(bcd_sig_cmp(&sig0, 0, &sig1, 0) != 0)                                                return false;
       if(bcd_sig_cmp(&sig1, 0, &sig2, 0) != 0)                                                return false;
     }
+
+    {
+      printf("  Sig Add Tests.\n");
+      int j;
+      bool carry;
+      uint8_t overflow;
+      significand_t sig1 = { .s = { 0 } };
+      significand_t sig2 = { .s = { 0 } };
+      significand_t sig3 = { .s = { 0 } };
+
+      /* 999...9 + 1 ripples all the way to the top. */
+      for(j = 0; j < BCD_NUM_DIGITS_INTERNAL; j++)
+      {
+        if(bcd_sig_set_digit(&sig1, j, 9) != true)                                            return false;
+      }
+      if(bcd_sig_set_digit(&sig2, (BCD_NUM_DIGITS_INTERNAL - 1), 1) != true)                  return false;
+      if(bcd_significand_add(&sig1, &sig2, &sig1, 0, &overflow) != true)                      return false;
+      if((bcd_sig_is_zero(&sig1) != true) || (overflow != 1))                                 return false;
+
+      /* 8 + 5 = 13 (carry), 35 + 7 = 42 (no carry), and 1 + 2 = 3 (no carry). */
+      if(bcd_sig_initialize(&sig1) != true)                                                   return false;
+      if(bcd_sig_initialize(&sig2) != true)                                                   return false;
+      if(bcd_sig_set_digit(&sig1, 1, 8) != true)                                              return false;
+      if(bcd_sig_set_digit(&sig2, 1, 5) != true)                                              return false;
+      if(bcd_significand_add(&sig1, &sig2, &sig3, &carry, &overflow) != true)                 return false;
+      if((carry != true) || (overflow != 0))                                                  return false;
+      if((bcd_sig_get_digit(&sig3, 0) != 1) || (bcd_sig_get_digit(&sig3, 1) != 3))           return false;
+      if(bcd_sig_set_digit(&sig1, 0, 3) != true)                                              return false;
+      if(bcd_sig_set_digit(&sig1, 1, 5) != true)                                              return false;
+      if(bcd_sig_set_digit(&sig2, 1, 7) != true)                                              return false;
+      if(bcd_significand_add(&sig1, &sig2, &sig3, &carry, &overflow) != true)                 return false;
+      if((carry != false) || (overflow != 0))                                                 return false;
+      if((bcd_sig_get_digit(&sig3, 0) != 4) || (bcd_sig_get_digit(&sig3, 1) != 2))           return false;
+      if(bcd_sig_initialize(&sig1) != true)                                                   return false;
+      if(bcd_sig_initialize(&sig2) != true)                                                   return false;
+      if(bcd_sig_set_digit(&sig1, 5, 1) != true)                                              return false;
+      if(bcd_sig_set_digit(&sig2, 5, 2) != true)                                              return false;
+      if(bcd_significand_add(&sig1, &sig2, &sig3, &carry, &overflow) != true)                 return false;
+      if((carry != false) || (bcd_sig_get_digit(&sig3, 5) != 3))                              return false;
+
+      /* Carry from one word to the next. */
+      if(bcd_sig_initialize(&sig1) != true)                                                   return false;
+      if(bcd_sig_initialize(&sig2) != true)                                                   return false;
+      for(j = SIGNIFICAND_DIGITS_PER_SECTION; j < BCD_NUM_DIGITS_INTERNAL; j++)
+      {
+        if(bcd_sig_set_digit(&sig1, j, 9) != true)                                            return false;
+      }
+      if(bcd_sig_set_digit(&sig2, (BCD_NUM_DIGITS_INTERNAL - 1), 1) != true)                  return false;
+      if(bcd_significand_add(&sig1, &sig2, &sig1, 0, &overflow) != true)                      return false;
+      if(overflow != 0)                                                                       return false;
+      for(j = 0; j < BCD_NUM_DIGITS_INTERNAL; j++)
+      {
+        if(bcd_sig_get_digit(&sig1, j) != ((j == (SIGNIFICAND_DIGITS_PER_SECTION - 1)) ? 1 : 0)) return false;
+      }
+    }
+
+    {
+      printf("  Sig Sub Tests.\n");
+      int j;
+      uint8_t borrow;
+      significand_t sig1 = { .s = { 0 } };
+      significand_t sig2 = { .s = { 0 } };
+      significand_t sig3 = { .s = { 0 } };
+
+      /* 1000...0 - 1 = 0999...9 borrows all the way up, but not out. */
+      if(bcd_sig_set_digit(&sig1, 0, 1) != true)                                              return false;
+      if(bcd_sig_set_digit(&sig2, (BCD_NUM_DIGITS_INTERNAL - 1), 1) != true)                  return false;
+      borrow = 0;
+      if(bcd_significand_sub(&sig1, &sig2, &sig3, &borrow) != true)                           return false;
+      if(borrow != 0)                                                                         return false;
+      for(j = 0; j < BCD_NUM_DIGITS_INTERNAL; j++)
+      {
+        if(bcd_sig_get_digit(&sig3, j) != ((j == 0) ? 0 : 9))                                 return false;
+      }
+
+      /* 0 - 1 = 999...9 with a borrow out of the top. */
+      if(bcd_sig_initialize(&sig1) != true)                                                   return false;
+      borrow = 0;
+      if(bcd_significand_sub(&sig1, &sig2, &sig3, &borrow) != true)                           return false;
+      if(borrow != 1)                                                                         return false;
+      for(j = 0; j < BCD_NUM_DIGITS_INTERNAL; j++)
+      {
+        if(bcd_sig_get_digit(&sig3, j) != 9)                                                  return false;
+      }
+
+      /* x - x - (borrow in) = 999...9 with a borrow out of the top. */
+      if(bcd_sig_set_digit(&sig1, 3, 7) != true)                                              return false;
+      borrow = 1;
+      if(bcd_significand_sub(&sig1, &sig1, &sig3, &borrow) != true)                           return false;
+      if((borrow != 1) || (bcd_sig_get_digit(&sig3, 3) != 9))                                 return false;
+
+      /* 52 - 37 = 15. */
+      if(bcd_sig_initialize(&sig1) != true)                                                   return false;
+      if(bcd_sig_initialize(&sig2) != true)                                                   return false;
+      if(bcd_sig_set_digit(&sig1, 0, 5) != true)                                              return false;
+      if(bcd_sig_set_digit(&sig1, 1, 2) != true)                                              return false;
+      if(bcd_sig_set_digit(&sig2, 0, 3) != true)                                              return false;
+      if(bcd_sig_set_digit(&sig2, 1, 7) != true)                                              return false;
+      borrow = 0;
+      if(bcd_significand_sub(&sig1, &sig2, &sig1, &borrow) != true)                           return false;
+      if((borrow != 0) || (bcd_sig_get_digit(&sig1, 0) != 1) || (bcd_sig_get_digit(&sig1, 1) != 5)) return false;
+    }
   }
 #endif // TEST_PRIMITIVES
 
@@ -2424,7 +2787,7 @@ operand_base_10_test(void)
   /* Math operations. */
   typedef struct operand_base_10_math_test {
     const char  *name;
-    bool (*func)(operand_base_10 *val1, operand_base_10 *val2);
+    bool (*func)(operand_base_10 *val1, const operand_base_10 *val2);
     const char  *val1;
     const char  *val2;
     const char  *result;
@@ -2455,6 +2818,8 @@ operand_base_10_test(void)
     { "BCD_ADD_23", operand_base_10_op_add, "9999999999999999"                 ,                 ".9"               ,                     "1e+16"                 }, // Carry all the way up.
     { "BCD_ADD_24", operand_base_10_op_add, "6666666666666666"                 ,                 ".9"               , "6,666,666,666,666,667"                     }, // Carry a little bit.
     { "BCD_ADD_25", operand_base_10_op_add, "1111111111111111s"                ,                 ".9s"              ,"-1,111,111,111,111,112"                     }, // Negative carry.
+    { "BCD_ADD_26", operand_base_10_op_add,                "0s"                ,                "5s"                ,                    "-5"                     }, // Neg zero + Neg.
+    { "BCD_ADD_27", operand_base_10_op_add,             "4321s"                ,             "4321"                 ,                     "0"                     }, // Neg + Pos = 0.
 
     { "BCD_SUB_01", operand_base_10_op_sub,                "5"                 ,                "2"                 ,                     "3"                     }, // Debug.
     { "BCD_SUB_02", operand_base_10_op_sub,                "0"                 ,                "1"                 ,                    "-1"                     }, // Neg num.
@@ -2468,6 +2833,9 @@ operand_base_10_test(void)
     { "BCD_SUB_10", operand_base_10_op_sub,                "0"                 ,           "452389.841"             ,              "-452,389.841"                 }, // 0 - +Val = -Val.
     { "BCD_SUB_11", operand_base_10_op_sub,                "0"                 ,                 ".2841s"           ,                     "0.2841"                }, // 0 - -Val = +Val.
     { "BCD_SUB_11", operand_base_10_op_sub,                "0"                 ,                "0"                 ,                     "0"                     }, // 0 - 0 = 0.
+    { "BCD_SUB_12", operand_base_10_op_sub,                "9"                 ,                "1s"                ,                    "10"                     }, // Pos - Neg with carry.
+    { "BCD_SUB_13", operand_base_10_op_sub,              "100"                 ,                 ".0000001"         ,                    "99.9999999"             }, // Borrow all the way up.
+    { "BCD_SUB_14", operand_base_10_op_sub,             "1234.5"               ,             "1234.5"               ,                     "0"                     }, // Equal magnitudes.
 
     { "BCD_MUL_01", operand_base_10_op_mul,                "3"                 ,                "2"                 ,                     "6"                     }, // Debug.
     { "BCD_MUL_02", operand_base_10_op_mul,             "4567"                 ,            "56789"                 ,           "259,355,363"                     }, // Lots of carry.
@@ -2505,6 +2873,9 @@ operand_base_10_test(void)
     { "BCD_MUL_34", operand_base_10_op_mul,              "370"                 ,                "6"                 ,                 "2,220"                     }, // Math test.
     { "BCD_MUL_35", operand_base_10_op_mul,              "370"                 ,                "9"                 ,                 "3,330"                     }, // Math test.
     { "BCD_MUL_36", operand_base_10_op_mul,              "370"                 ,               "12"                 ,                 "4,440"                     }, // Math test.
+    { "BCD_MUL_37", operand_base_10_op_mul,                "1.99"              ,                "9.99"              ,                    "19.8801"                }, // Carry into a new digit.
+    { "BCD_MUL_38", operand_base_10_op_mul,              "199"                 ,              "999"                 ,               "198,801"                     }, // Carry into a new digit.
+    { "BCD_MUL_39", operand_base_10_op_mul, "1234567890123456"                 , "9876543210987654"                 ,                     "1.219326311370217e+31" }, // Full width.
 
     { "BCD_DIV_01", operand_base_10_op_div,                "6"                 ,                "2"                 ,                     "3"                     }, // Simple div.
     { "BCD_DIV_02", operand_base_10_op_div,              "246"                 ,                "3"                 ,                    "82"                     }, // Slightly fancier.
@@ -2522,6 +2893,9 @@ operand_base_10_test(void)
     { "BCD_DIV_14", operand_base_10_op_div,                "2"                 ,                "1.414213562373095" ,                     "1.414213562373095"     }, // Square root of 2.
     { "BCD_DIV_15", operand_base_10_op_div, "9999999999999999"                 , "7777777777777777"                 ,                     "1.285714285714286"     }, // 16 / 16 = 16 digits.
     { "BCD_DIV_16", operand_base_10_op_div,                "3"                 , "1834944619757441"                 ,                     "1.634926726233605e-15" }, // Bug.
+    { "BCD_DIV_17", operand_base_10_op_div,                "2"                 ,                "3"                 ,                     "0.6666666666666667"    }, // Round up.
+    { "BCD_DIV_18", operand_base_10_op_div,                "0"                 ,                "7"                 ,                     "0"                     }, // 0 / Val = 0.
+    { "BCD_DIV_19", operand_base_10_op_div,               "10"                 ,                "3s"                ,                    "-3.333333333333333"     }, // Quotient >= 1.
 
     { "BCD_EXP_01", operand_base_10_op_exp,                "2"                 ,                "3"                 ,                     "8"                     }, // Simple.
     { "BCD_EXP_02", operand_base_10_op_exp,               "14"                 ,                "5s"               ,                      "1.859344320818706e-6"  }, // Negative exponent.
@@ -2629,6 +3003,22 @@ operand_base_10_test(void)
     o1->exponent = 0; o1->sign = false;
     if(operand_base_10_copy(o1, o2) != true)                                                  return false;
     if(operand_base_10_cmp(o1, o2) !=  0)                                                     return false;
+    if(operand_base_10_import(o1,  250) != true)                                              return false;
+    if(operand_base_10_import(o2,   25) != true)                                              return false;
+    if(operand_base_10_cmp(o1, o2) !=  1)                                                     return false;
+    if(operand_base_10_cmp(o2, o1) != -1)                                                     return false;
+    if(operand_base_10_import(o1, -250) != true)                                              return false;
+    if(operand_base_10_import(o2,  -25) != true)                                              return false;
+    if(operand_base_10_cmp(o1, o2) != -1)                                                     return false;
+    if(operand_base_10_cmp(o2, o1) !=  1)                                                     return false;
+    if(operand_base_10_import(o1,    0) != true)                                              return false;
+    if(operand_base_10_cmp(o1, o2) !=  1)                                                     return false;
+    if(operand_base_10_import(o2,   25) != true)                                              return false;
+    if(operand_base_10_cmp(o1, o2) != -1)                                                     return false;
+    if(bcd_shift_significand(&o2->significand, 3) != true)                                    return false;
+    o2->exponent += 3;
+    if(operand_base_10_import(o1,   25) != true)                                              return false;
+    if(operand_base_10_cmp(o1, o2) !=  0)                                                     return false;
 
     printf("operand_base_10_import() and operand_base_10_export().\n");
     int64_t exp;
@@ -2641,6 +3031,35 @@ operand_base_10_test(void)
     if(operand_base_10_add_char(o1, '0') != true)                                             return false;
     if(operand_base_10_export(o1, &exp) != true)                                              return false;
     if(exp != 500)                                                                            return false;
+    if(operand_base_10_import(o1, 1234567890123456LL) != true)                                return false;
+    if(operand_base_10_export(o1, &exp) != true)                                              return false;
+    if(exp != 1234567890123456LL)                                                             return false;
+    if(operand_base_10_import(o1, -256) != true)                                              return false;
+    if(operand_base_10_export(o1, &exp) != true)                                              return false;
+    if(exp != -256)                                                                           return false;
+
+    printf("Constant tables.\n");
+    for(x = 0; x <= OPERAND_BASE_10_MAX_INTEGER; x++)
+    {
+      if(operand_base_10_export(&operand_base_10_integers[x], &exp) != true)                  return false;
+      if(exp != x)                                                                            return false;
+    }
+    for(x = 1; x <= OPERAND_BASE_10_MAX_RECIPROCAL; x++)
+    {
+      /* n * (1/n) rounds to 1. */
+      char str[64];
+      if(operand_base_10_copy(&operand_base_10_integers[x], o1) != true)                      return false;
+      if(operand_base_10_op_mul(o1, &operand_base_10_reciprocals[x]) != true)                 return false;
+      if(operand_base_10_to_str(o1, str, sizeof(str)) != true)                                return false;
+      if(strcmp(str, "1") != 0)                                                               return false;
+    }
+    {
+      char str[64];
+      if(operand_base_10_to_str(&operand_base_10_ln2, str, sizeof(str)) != true)              return false;
+      if(strcmp(str, "0.6931471805599453") != 0)                                              return false;
+      if(operand_base_10_to_str(&operand_base_10_ln10, str, sizeof(str)) != true)             return false;
+      if(strcmp(str, "2.302585092994046") != 0)                                               return false;
+    }
 
     operand_base_10_delete(o1); operand_base_10_delete(o2);
   }
@@ -2651,3 +3070,221 @@ operand_base_10_test(void)
 
 #endif // TEST
 
+
+/******************************************************************************
+ ********************************* BENCH API **********************************
+ *****************************************************************************/
+
+#if defined(BENCH)
+
+/* The number of pseudo-random values that the benchmarks cycle through, and the
+ * number of times they cycle through them. */
+#define BCD_BENCH_VALUES 64
+#define BCD_BENCH_LOOPS  (1000000 / BCD_BENCH_VALUES)
+
+/* Fill a significand with pseudo-random digits.  The most significant digit is
+ * never zero, so the result is always normalized.
+ *
+ * Input:
+ *   sig  = A pointer to the significand.
+ *
+ *   seed = A pointer to the seed for the random number generator.
+ *
+ * Output:
+ *   N/A.
+ */
+static void
+bcd_bench_fill(significand_t *sig,
+               uint32_t      *seed)
+{
+  int i;
+  for(i = 0; i < BCD_NUM_DIGITS_INTERNAL; i++)
+  {
+    *seed = (*seed * 1103515245) + 12345;
+    uint8_t digit = ((*seed >> 16) % 10);
+    if((i == 0) && (digit == 0))
+    {
+      digit = 1;
+    }
+    bcd_sig_set_digit(sig, i, digit);
+  }
+}
+
+bool
+operand_base_10_bench(void)
+{
+  bool retcode = false;
+
+  operand_base_10 vals[BCD_BENCH_VALUES];
+  uint32_t seed = 1;
+  uint64_t sink = 0;
+  int x, y, loop;
+
+  for(x = 0; x < BCD_BENCH_VALUES; x++)
+  {
+    operand_base_10 *v = &vals[x];
+    memset(v, 0, sizeof(*v));
+    bcd_bench_fill(&v->significand, &seed);
+    v->exponent = ((seed >> 16) % 9) - 4;
+    v->sign = ((seed >> 20) & 1);
+  }
+
+  do
+  {
+    bench_timer timer;
+
+    /* The raw significand addition kernel. */
+    bench_timer_start(&timer);
+    for(loop = 0; loop < BCD_BENCH_LOOPS; loop++)
+    {
+      for(x = 0; x < BCD_BENCH_VALUES; x++)
+      {
+        significand_t dst;
+        bool carry;
+        uint8_t overflow;
+        y = ((x + loop) % BCD_BENCH_VALUES);
+        if(bcd_significand_add(&vals[x].significand, &vals[y].significand, &dst, &carry, &overflow) != true) { break; }
+        sink += overflow + carry + dst.s[0];
+      }
+    }
+    bench_report("bcd_significand_add()", &timer, (uint64_t) BCD_BENCH_LOOPS * BCD_BENCH_VALUES, "adds");
+
+    /* Shifting, in both directions, by a variety of distances. */
+    bench_timer_start(&timer);
+    for(loop = 0; loop < BCD_BENCH_LOOPS; loop++)
+    {
+      for(x = 0; x < BCD_BENCH_VALUES; x++)
+      {
+        significand_t sig = vals[x].significand;
+        int16_t shift = (((x + loop) % BCD_NUM_DIGITS_INTERNAL) - (BCD_NUM_DIGITS_INTERNAL / 2));
+        if(bcd_shift_significand(&sig, shift) != true) { break; }
+        sink += sig.s[0];
+      }
+    }
+    bench_report("bcd_shift_significand()", &timer, (uint64_t) BCD_BENCH_LOOPS * BCD_BENCH_VALUES, "shifts");
+
+    /* int64_t import. */
+    bench_timer_start(&timer);
+    for(loop = 0; loop < BCD_BENCH_LOOPS; loop++)
+    {
+      for(x = 0; x < BCD_BENCH_VALUES; x++)
+      {
+        operand_base_10 op;
+        if(operand_base_10_import(&op, ((int64_t) vals[x].significand.s[0] * (loop + 1))) != true) { break; }
+        sink += op.significand.s[0];
+      }
+    }
+    bench_report("operand_base_10_import()", &timer, (uint64_t) BCD_BENCH_LOOPS * BCD_BENCH_VALUES, "imports");
+
+    /* Comparison.  Count the allocations too. */
+    uint64_t allocs = bench_alloc_count();
+    bench_timer_start(&timer);
+    for(loop = 0; loop < BCD_BENCH_LOOPS; loop++)
+    {
+      for(x = 0; x < BCD_BENCH_VALUES; x++)
+      {
+        sink += operand_base_10_cmp(&vals[x], &vals[(x + loop) % BCD_BENCH_VALUES]);
+      }
+    }
+    bench_report("operand_base_10_cmp()", &timer, (uint64_t) BCD_BENCH_LOOPS * BCD_BENCH_VALUES, "cmps");
+    bench_report_allocs("operand_base_10_cmp()", (bench_alloc_count() - allocs), (uint64_t) BCD_BENCH_LOOPS * BCD_BENCH_VALUES, "cmp");
+
+    /* Full signed addition.  The copies are part of the measurement. */
+    bench_timer_start(&timer);
+    for(loop = 0; loop < BCD_BENCH_LOOPS; loop++)
+    {
+      for(x = 0; x < BCD_BENCH_VALUES; x++)
+      {
+        operand_base_10 op1 = vals[x];
+        operand_base_10 op2 = vals[(x + loop) % BCD_BENCH_VALUES];
+        if(operand_base_10_op_add(&op1, &op2) != true) { break; }
+        sink += op1.significand.s[0];
+      }
+    }
+    bench_report("operand_base_10_op_add()", &timer, (uint64_t) BCD_BENCH_LOOPS * BCD_BENCH_VALUES, "adds");
+
+    /* Full signed subtraction. */
+    bench_timer_start(&timer);
+    for(loop = 0; loop < BCD_BENCH_LOOPS; loop++)
+    {
+      for(x = 0; x < BCD_BENCH_VALUES; x++)
+      {
+        operand_base_10 op1 = vals[x];
+        operand_base_10 op2 = vals[(x + loop) % BCD_BENCH_VALUES];
+        if(operand_base_10_op_sub(&op1, &op2) != true) { break; }
+        sink += op1.significand.s[0];
+      }
+    }
+    bench_report("operand_base_10_op_sub()", &timer, (uint64_t) BCD_BENCH_LOOPS * BCD_BENCH_VALUES, "subs");
+
+    /* Full signed multiplication. */
+    bench_timer_start(&timer);
+    for(loop = 0; loop < BCD_BENCH_LOOPS; loop++)
+    {
+      for(x = 0; x < BCD_BENCH_VALUES; x++)
+      {
+        operand_base_10 op1 = vals[x];
+        operand_base_10 op2 = vals[(x + loop) % BCD_BENCH_VALUES];
+        if(operand_base_10_op_mul(&op1, &op2) != true) { break; }
+        sink += op1.significand.s[0];
+      }
+    }
+    bench_report("operand_base_10_op_mul()", &timer, (uint64_t) BCD_BENCH_LOOPS * BCD_BENCH_VALUES, "muls");
+
+    /* Full signed division. */
+    bench_timer_start(&timer);
+    for(loop = 0; loop < BCD_BENCH_LOOPS; loop++)
+    {
+      for(x = 0; x < BCD_BENCH_VALUES; x++)
+      {
+        operand_base_10 op1 = vals[x];
+        operand_base_10 op2 = vals[(x + loop) % BCD_BENCH_VALUES];
+        if(operand_base_10_op_div(&op1, &op2) != true) { break; }
+        sink += op1.significand.s[0];
+      }
+    }
+    bench_report("operand_base_10_op_div()", &timer, (uint64_t) BCD_BENCH_LOOPS * BCD_BENCH_VALUES, "divs");
+
+    /* Exponentiation with an integer exponent.  Count the allocations too. */
+    operand_base_10 exp;
+    allocs = bench_alloc_count();
+    bench_timer_start(&timer);
+    for(loop = 0; loop < (BCD_BENCH_LOOPS / 10); loop++)
+    {
+      for(x = 0; x < BCD_BENCH_VALUES; x++)
+      {
+        operand_base_10 op1 = vals[x];
+        if(operand_base_10_import(&exp, (x % 16)) != true) { break; }
+        if(operand_base_10_op_exp(&op1, &exp) != true)     { break; }
+        sink += op1.significand.s[0];
+      }
+    }
+    bench_report("operand_base_10_op_exp(x ^ n)", &timer, (uint64_t) (BCD_BENCH_LOOPS / 10) * BCD_BENCH_VALUES, "exps");
+    bench_report_allocs("operand_base_10_op_exp(x ^ n)", (bench_alloc_count() - allocs), (uint64_t) (BCD_BENCH_LOOPS / 10) * BCD_BENCH_VALUES, "exp");
+
+    /* Exponentiation with a fractional exponent.  This one is slow. */
+    {
+      const char *p;
+      operand_base_10_init(&exp);
+      for(p = "12.345"; *p != 0; p++) { operand_base_10_add_char(&exp, *p); }
+    }
+    allocs = bench_alloc_count();
+    bench_timer_start(&timer);
+    for(loop = 0; loop < 100; loop++)
+    {
+      operand_base_10 op1;
+      if(operand_base_10_import(&op1, 3) != true)          { break; }
+      if(operand_base_10_op_exp(&op1, &exp) != true)       { break; }
+      sink += op1.significand.s[0];
+    }
+    bench_report("operand_base_10_op_exp(3 ^ 12.345)", &timer, 100, "exps");
+    bench_report_allocs("operand_base_10_op_exp(3 ^ 12.345)", (bench_alloc_count() - allocs), 100, "exp");
+
+    printf("  (checksum 0x%llX)\n", (unsigned long long) sink);
+    retcode = true;
+  } while(0);
+
+  return retcode;
+}
+
+#endif // BENCH
@@ -6,43 +6,145 @@
 #ifndef __OPERAND_BASE_10_H__
 #define __OPERAND_BASE_10_H__
 
+#include <stdint.h>
+
 #include "operand_api.h"
 
 /****************************** CLASS DEFINITION ******************************/
 
-typedef struct operand_base_10 operand_base_10;
+/* The class is defined here (instead of being hidden in operand_base_10.c) so
+ * that callers can keep operand_base_10 objects on the stack or embed them in
+ * their own structs.  Use operand_base_10_init() to initialize one of those
+ * objects before using it.  The members are private.  Don't touch them outside
+ * of operand_base_10.c.
+ */
+
+/* The number of digits the user can push to operand_base_10_add_char(). */
+#define BCD_NUM_DIGITS 16 // Must be a multiple of 2.
+
+#if (BCD_NUM_DIGITS >= 16)
+/* The basic data element that stores the BCD digits internally. */
+typedef uint32_t significand_section_t;
+
+#define SIGNIFICAND_SECTION_MASK                0xFFFFFFFF
+
+#elif (BCD_NUM_DIGITS >= 8)
+
+/* The basic data element that stores the BCD digits internally. */
+typedef uint16_t significand_section_t;
+
+#define SIGNIFICAND_SECTION_MASK                0xFFFF
+
+#else
+
+/* The basic data element that stores the BCD digits internally. */
+typedef uint8_t significand_section_t;
+
+#define SIGNIFICAND_SECTION_MASK                0xFF
+
+#endif
+
+/* The number of digits that can be stored in a single data element. */
+#define SIGNIFICAND_DIGITS_PER_SECTION (sizeof(significand_section_t) * 2)
+
+/* This is the number of digits that we work with internally.  It gives us a
+ * lot of extra precision, thus allowing us to do things like:
+ * - Perform repeated operations like exponentiation.
+ * - Perform rounding on results.
+ */
+#define BCD_NUM_DIGITS_INTERNAL (BCD_NUM_DIGITS * 2)
+
+/* The number of data elements required to hold all of the digits. */
+#define SIGNIFICAND_SECTIONS_INTERNAL (BCD_NUM_DIGITS_INTERNAL / SIGNIFICAND_DIGITS_PER_SECTION)
+
+/* The definition of the significand that is located in each operand_base_10 object. */
+typedef struct { significand_section_t s[SIGNIFICAND_SECTIONS_INTERNAL]; } significand_t;
+
+/* This is the operand_base_10 class. */
+typedef struct operand_base_10 {
+
+  /* This is the significand.  Each nybble equals one decimal digit.*/
+  significand_t significand;
+
+  /* This is the exponent.
+   * - It's >= 0 if (|number| >= 1).
+   * - It's < 0 if (|number| < 1).
+   */
+  int16_t exponent;
+
+  /* This is the sign.
+   * - true = negative.
+   * - false = positive.
+   */
+  uint8_t sign;
+
+  /* If we're adding one character at a time, these are used to help us know
+   * where we are. */
+  int char_count;
+  bool got_decimal_point;
+} operand_base_10;
+
+/********************************* CONSTANTS **********************************/
+
+/* Read-only constants.  They are generated at build time by gen_constants.c
+ * (see operand_base_10_constants.h), so hot paths can use them instead of
+ * building the same values over and over.  Only pass them as read-only
+ * (const) operands.
+ */
+#define OPERAND_BASE_10_MAX_INTEGER    256
+#define OPERAND_BASE_10_MAX_RECIPROCAL 256
+
+/* n, for 0 <= n <= OPERAND_BASE_10_MAX_INTEGER. */
+extern const operand_base_10 operand_base_10_integers[OPERAND_BASE_10_MAX_INTEGER + 1];
+
+/* 1/n, for 1 <= n <= OPERAND_BASE_10_MAX_RECIPROCAL.  Entry 0 is 0. */
+extern const operand_base_10 operand_base_10_reciprocals[OPERAND_BASE_10_MAX_RECIPROCAL + 1];
+
+extern const operand_base_10 operand_base_10_ln2;
+extern const operand_base_10 operand_base_10_ln10;
+extern const operand_base_10 operand_base_10_three_halves;
 
 /********************************* PUBLIC OPS *********************************/
 
-bool operand_base_10_op_add(operand_base_10 *op1, operand_base_10 *op2);
-bool operand_base_10_op_sub(operand_base_10 *op1, operand_base_10 *op2);
-bool operand_base_10_op_mul(operand_base_10 *op1, operand_base_10 *op2);
-bool operand_base_10_op_div(operand_base_10 *op1, operand_base_10 *op2);
-bool operand_base_10_op_exp(operand_base_10 *op1, operand_base_10 *op2);
+extern const operand_api operand_base_10_ops;
+
+bool operand_base_10_op_add(operand_base_10 *op1, const operand_base_10 *op2);
+bool operand_base_10_op_sub(operand_base_10 *op1, const operand_base_10 *op2);
+bool operand_base_10_op_mul(operand_base_10 *op1, const operand_base_10 *op2);
+bool operand_base_10_op_div(operand_base_10 *op1, const operand_base_10 *op2);
+bool operand_base_10_op_exp(operand_base_10 *op1, const operand_base_10 *op2);
 
 /********************************* PUBLIC API *********************************/
 
-operand_api * operand_base_10_return_ops(void);
+const operand_api * operand_base_10_return_ops(void);
 
 operand_base_10 *operand_base_10_new(void);
 
+bool operand_base_10_init(operand_base_10 *this);
+
 bool operand_base_10_delete(operand_base_10 *this);
 
 bool operand_base_10_add_char_is_valid_operand(char c);
 
+bool operand_base_10_add_char_is_full(const operand_base_10 *this, char c);
+
 bool operand_base_10_add_char(operand_base_10 *this, char c);
 
-bool operand_base_10_to_str(operand_base_10 *this, char *buf, size_t buf_size);
+bool operand_base_10_to_str(const operand_base_10 *this, char *buf, size_t buf_size);
 
-bool operand_base_10_copy(operand_base_10 *src, operand_base_10 *dst);
+bool operand_base_10_copy(const operand_base_10 *src, operand_base_10 *dst);
 
-int operand_base_10_cmp(operand_base_10 *obj1, operand_base_10 *obj2);
+int operand_base_10_cmp(const operand_base_10 *obj1, const operand_base_10 *obj2);
 
 bool operand_base_10_import(operand_base_10 *this, int64_t src);
 
-bool operand_base_10_export(operand_base_10 *this, int64_t *dst);
+bool operand_base_10_export(const operand_base_10 *this, int64_t *dst);
+
+bool operand_base_10_scale(operand_base_10 *this, int16_t power);
+
+bool operand_base_10_get_exponent(const operand_base_10 *this, int16_t *exponent);
 
-const char * operand_base_10_get_dbg_info(operand_base_10 *this);
+const char * operand_base_10_get_dbg_info(const operand_base_10 *this);
 
 /********************************** TEST API **********************************/
 
@@ -52,5 +154,13 @@ bool operand_base_10_test(void);
 
 #endif // TEST
 
+/********************************* BENCH API **********************************/
+
+#if defined(BENCH)
+
+bool operand_base_10_bench(void);
+
+#endif // BENCH
+
 #endif // __OPERAND_BASE_10_H__
 
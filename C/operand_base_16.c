@@ -18,18 +18,13 @@
  ****************************** CLASS DEFINITION ******************************
  *****************************************************************************/
 
-/* This is the hex class. */
-struct operand_base_16 {
-
-  /* This is the hex number. */
-  uint64_t val;
-};
+/* The operand_base_16 class is defined in operand_base_16.h. */
   
 /******************************************************************************
  ******************************** OPS STRUCT **********************************
  *****************************************************************************/
 
-operand_api operand_base_16_ops = {
+const operand_api operand_base_16_ops = {
   .base_name = "HEX",
   .op_add = (operand_api_binary_op) operand_base_16_op_add,
   .op_sub = (operand_api_binary_op) operand_base_16_op_sub,
@@ -168,7 +163,7 @@ operand_base_16_op_div(operand_base_16 *op1,
  *   Returns a pointer to the operations.
  *   Returns 0 if unable to return the pointer to the ops.
  */
-operand_api *
+const operand_api *
 operand_base_16_return_ops(void)
 {
   return &operand_base_16_ops;
@@ -191,13 +186,41 @@ operand_base_16_new(void)
 
   if(this != (operand_base_16 *) 0)
   {
-    /* Start with zero. */
-    this->val  = 0;
+    operand_base_16_init(this);
   }
 
   return this;
 }
 
+/* Initialize a operand_base_16 object that lives in caller-owned storage
+ * (i.e. embedded in another struct).  The object is set to 0.  It's also okay
+ * to call this on an object that is already in use.  That resets it back to 0.
+ *
+ * Objects that are initialized this way must NOT be passed to
+ * operand_base_16_delete().
+ *
+ * Input:
+ *   this = A pointer to the caller-owned operand_base_16 object.
+ *
+ * Output:
+ *   true  = success.  this contains 0.
+ *   false = failure.  this is undefined.
+ */
+bool
+operand_base_16_init(operand_base_16 *this)
+{
+  bool retcode = false;
+
+  if(this != (operand_base_16 *) 0)
+  {
+    /* Start with zero. */
+    this->val = 0;
+    retcode   = true;
+  }
+
+  return retcode;
+}
+
 /* Delete a operand_base_16 object that was created by operand_base_16_new().
  *
  * Input:
@@ -252,6 +275,32 @@ operand_base_16_add_char_is_valid_operand(char c)
   return retcode;
 }
 
+/* Check to see if operand_base_16_add_char() would drop a digit because the
+ * value is already full.
+ *
+ * Input:
+ *   this = A pointer to the operand_base_16 object.
+ *
+ *   c    = The char that is about to be added.
+ *
+ * Output:
+ *   true  = c is a hex digit, and there's no room for it.
+ *   false = c will be added (or it isn't a hex digit).
+ */
+bool
+operand_base_16_add_char_is_full(const operand_base_16 *this,
+                                 char                   c)
+{
+  bool retcode = false;
+
+  if((this != (operand_base_16 *) 0) && ((c & 0xDF) != 'S') && (operand_base_16_add_char_is_valid_operand(c) == true))
+  {
+    retcode = ((this->val & 0x7000000000000000ll) != 0) ? true : false;
+  }
+
+  return retcode;
+}
+
 /* Attempt to add a character to the operand_base_16 object.  The character is
  * checked to see if it's a valid part of a hexadecimal number.  If it's valid,
  * it's added.  Note that it's possible for a character to be dropped because
@@ -345,7 +394,7 @@ operand_base_16_to_str(operand_base_16 *this,
     {
       int64_t val = this->val;
 
-      DBG_PRINT("%s(): 0x%016llX.\n", __func__, val);
+      DBG_PRINT("%s(): 0x%016llX.\n", __func__, (unsigned long long) val);
 
       /* If it's zero, then it's zero. */
       if(val == 0ll)
@@ -416,6 +465,34 @@ operand_base_16_import(operand_base_16 *this,
   return retcode;
 }
 
+/* Make a copy of a hex object.  The caller provides a src and dst, and this
+ * member makes a copy.
+ *
+ * Input:
+ *   src = A pointer to the operand_base_16 object.
+ *
+ *   dst = A pointer to a pre-allocated operand_base_16 object that we will
+ *         copy into.
+ *
+ * Output:
+ *   true  = success.  src has been copied to dst.
+ *   false = failure.  The contents of dst is undefined.
+ */
+bool
+operand_base_16_copy(const operand_base_16 *src,
+                     operand_base_16       *dst)
+{
+  bool retcode = false;
+
+  if( (src != (operand_base_16 *) 0) && (dst != (operand_base_16 *) 0) )
+  {
+    *dst = *src;
+    retcode = true;
+  }
+
+  return retcode;
+}
+
 /* Export the value of this object to a signed integer.  Note that this member
  * doesn't allow you to export to an IEEE floating point value.
  *
@@ -8,14 +8,29 @@
 #ifndef __OPERAND_BASE_16_H__
 #define __OPERAND_BASE_16_H__
 
+#include <stdint.h>
+
 #include "operand_api.h"
 
 /****************************** CLASS DEFINITION ******************************/
 
-typedef struct operand_base_16 operand_base_16;
+/* The class is defined here (instead of being hidden in operand_base_16.c) so
+ * that callers can embed operand_base_16 objects in their own structs.  Use
+ * operand_base_16_init() to initialize one of those objects before using it.
+ * The members are private.  Don't touch them outside of operand_base_16.c.
+ */
+
+/* This is the hex class. */
+typedef struct operand_base_16 {
+
+  /* This is the hex number. */
+  uint64_t val;
+} operand_base_16;
 
 /********************************* PUBLIC OPS *********************************/
 
+extern const operand_api operand_base_16_ops;
+
 bool operand_base_16_op_add(operand_base_16 *op1, operand_base_16 *op2);
 bool operand_base_16_op_sub(operand_base_16 *op1, operand_base_16 *op2);
 bool operand_base_16_op_mul(operand_base_16 *op1, operand_base_16 *op2);
@@ -23,18 +38,24 @@ bool operand_base_16_op_div(operand_base_16 *op1, operand_base_16 *op2);
 
 /********************************* PUBLIC API *********************************/
 
-operand_api * operand_base_16_return_ops(void);
+const operand_api * operand_base_16_return_ops(void);
 
 operand_base_16 *operand_base_16_new(void);
 
+bool operand_base_16_init(operand_base_16 *this);
+
 bool operand_base_16_delete(operand_base_16 *this);
 
 bool operand_base_16_add_char_is_valid_operand(char c);
 
+bool operand_base_16_add_char_is_full(const operand_base_16 *this, char c);
+
 bool operand_base_16_add_char(operand_base_16 *this, char c);
 
 bool operand_base_16_to_str(operand_base_16  *this, char  *buf, size_t buf_size);
 
+bool operand_base_16_copy(const operand_base_16 *src, operand_base_16 *dst);
+
 bool operand_base_16_import(operand_base_16 *this, int64_t src);
 
 bool operand_base_16_export(operand_base_16 *this, int64_t *dst);
@@ -5,10 +5,13 @@
  * list of C operator preference and associativity.
  */
 
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 
 #include "common.h"
 
+#include "bench.h"
 #include "operand.h"
 #include "operator.h"
 
@@ -16,8 +19,10 @@
  ****************************** CLASS DEFINITION ******************************
  *****************************************************************************/
 
-/* This is the list of supported operators. */
-typedef struct operator_property {
+/* This is the operator class.  Operators have no per-object state, so there
+ * is exactly one object for each supported operator, and it's immutable.  The
+ * objects are shared by everybody that uses the operator. */
+struct operator {
   const char             value;
   const char            *name;
   operator_type          op_type;
@@ -26,8 +31,10 @@ typedef struct operator_property {
   int                    stack_precedence;
   operand_binary_op      binary_op_exec;
   operand_unary_op       unary_op_exec;
-} operator_property;
-static operator_property operator_properties[] = {
+};
+
+/* This is the list of supported operators. */
+static const operator operator_objects[] = {
   { '(',  "(",    op_type_none,   op_special_type_l_paren, 0, 99, 0, 0 }, // Open parentheses
   { ')',  ")",    op_type_none,   op_special_type_r_paren,98,  0, 0, 0 }, // Open parentheses
   { '+',  "+",    op_type_binary, op_special_type_none,    9,  8, operand_op_add, 0 }, // Addition
@@ -44,137 +51,99 @@ static operator_property operator_properties[] = {
   { '>',  "SHR",  op_type_binary, op_special_type_none,   11, 10, 0, 0 }, // Shift Right
   { 'l',  "ROL",  op_type_binary, op_special_type_none,   11, 10, 0, 0 }, // Rotate Left
   { 'r',  "ROR",  op_type_binary, op_special_type_none,   11, 10, 0, 0 }, // Rotate Right
-  {  0 ,  "",     op_type_none,   op_special_type_none,    0,  0, 0, 0 }
 };
 
-/* This is the operator class.  Each object represents a single operator. */
-struct operator {
-  /* This is a pointer to the operator_property that defines the operator. */
-  operator_property *op_prop;
+/* This maps an operator character directly to its object.  Characters that
+ * aren't operators map to 0.  Keep it in sync with operator_objects[]
+ * (operator_test() checks it). */
+static const operator * const operator_map[UINT8_MAX + 1] = {
+  ['('] = &operator_objects[ 0],
+  [')'] = &operator_objects[ 1],
+  ['+'] = &operator_objects[ 2],
+  ['-'] = &operator_objects[ 3],
+  ['*'] = &operator_objects[ 4],
+  ['/'] = &operator_objects[ 5],
+  ['^'] = &operator_objects[ 6],
+  ['&'] = &operator_objects[ 7],
+  ['|'] = &operator_objects[ 8],
+  ['x'] = &operator_objects[ 9],
+  ['~'] = &operator_objects[10],
+  ['%'] = &operator_objects[11],
+  ['<'] = &operator_objects[12],
+  ['>'] = &operator_objects[13],
+  ['l'] = &operator_objects[14],
+  ['r'] = &operator_objects[15],
 };
-  
-/******************************************************************************
- ******************************** PRIVATE API *********************************
- *****************************************************************************/
-
-/* This function checks the operator and figures out which operator it is.
- *
- * Input:
- *   c = The one-character operator mnemonic.  All operators are one character.
- *
- * Output:
- *   Returns a pointer to the operator_property member that represents the
- *   operator in c.
- *   Returns 0 if c is NOT a valid operator.
- */
-static operator_property *
-operator_get_op_prop(char c)
-{
-  operator_property *retval = (operator_property *) 0;
-
-  int i;
-  for(i = 0; operator_properties[i].value != 0; i++) {
-    if(c == operator_properties[i].value) {
-      retval = &operator_properties[i];
-      break;
-    }
-  }
-
-  return retval;
-}
-
-/* This function checks the operator and figures out which operator it is.
- *
- * Input:
- *   this = A pointer to the operator object.
- *
- *   c    = The one-character operator mnemonic.  All operators are one character.
- *
- * Output:
- *   true  = success.  this->op_prop points to the operator_property that
- *                     describes the operator.
- *   false = failure.  this->op_prop is unchanged.
- */
-static bool
-operator_set_op_prop(operator *this,
-                     char c)
-{
-  bool retcode = false;
-
-  if(this != (operator *) 0)
-  {
-    retcode = ((this->op_prop = operator_get_op_prop(c)) != (operator_property *) 0) ? true : false;
-  }
-
-  return retcode;
-}
 
 /******************************************************************************
  ********************************* PUBLIC API *********************************
  *****************************************************************************/
 
-/* Create a new operator object.  This object can be used to access the
- * operator class.
+/* Get the operator object for an operator character.  The objects are shared
+ * and immutable.  Getting one never allocates memory, and there's nothing to
+ * delete when you're done with it.
  *
  * Input:
  *   c = The one-character operator value.
  *
  * Output:
  *   Returns a pointer to the object.
- *   Returns 0 if unable to create the object.  For example, if c is not a
- *             recognized operator.
+ *   Returns 0 if c is not a recognized operator.
  */
-operator *
-operator_new(const char c)
+const operator *
+operator_get(const char c)
 {
-  operator *this = malloc(sizeof(*this));
-
-  if(operator_set_op_prop(this, c) == false)
-  {
-    free(this);
-    this = (operator *) 0;
-  }
-
-  return this;
+  return operator_map[(uint8_t) c];
 }
 
-/* Delete an operator object that was created by operator_new().
+/* Check to see if the specified character is a valid operator that can be
+ * passed to operator_get().
  *
  * Input:
- *   this = A pointer to the operator object.
+ *   c = The character to check.
  *
  * Output:
- *   true  = success.  The object is deleted.
- *   false = failure.
+ *   true  = Yes, c is a valid operator character.
+ *   false = No, c is NOT a valid operator character.
  */
 bool
-operator_delete(operator *this)
+operator_is_valid_operator(char c)
 {
-  bool retcode = false;
-
-  if(this != (operator *) 0)
-  {
-    free(this);
-    retcode = true;
-  }
+  bool retcode = (operator_map[(uint8_t) c] != (const operator *) 0) ? true : false;
 
   return retcode;
 }
 
-/* Check to see if the specified character is a valid operator that can be
- * passed to operator_new().
+/* Return the one-character operator value of the operator object.  This is
+ * the character that operator_get() turns into the object.
  *
  * Input:
- *   c = The character to check.
+ *   this  = A pointer to the operator object.
+ *
+ *   value = A pointer to a variable that will receive the character.
  *
  * Output:
- *   true  = Yes, c is a valid operator character.
- *   false = No, c is NOT a valid operator character.
+ *   true  = success.  *value is set to the operator character.
+ *   false = failure.  *value is set to 0 (if it is a valid pointer).
  */
 bool
-operator_is_valid_operator(char c)
+operator_get_value(const operator *this,
+                   char           *value)
 {
-  bool retcode = (operator_get_op_prop(c) != (operator_property *) 0) ? true : false;
+  bool retcode = false;
+
+  if(value != (char *) 0)
+  {
+    if(this != (const operator *) 0)
+    {
+      *value = this->value;
+      retcode = true;
+    }
+    else
+    {
+      *value = 0;
+    }
+  }
 
   return retcode;
 }
@@ -182,7 +151,7 @@ operator_is_valid_operator(char c)
 /* This function returns a value that represents the precedence of an operator.
  * Precedence deal with the order in which operators should be processed.
  *
- * The values are defined in operator_properties.  There are 2 precedence
+ * The values are defined in operator_objects[].  There are 2 precedence
  * values for each operator.  They are both returned to the caller.  The caller
  * knows how to use them.
  *
@@ -198,9 +167,9 @@ operator_is_valid_operator(char c)
  *   false = failure.  *input and *stack are set to 0 (if they are valid ptrs).
  */
 bool
-operator_precedence(operator *this,
-                    int *input,
-                    int *stack)
+operator_precedence(const operator *this,
+                    int            *input,
+                    int            *stack)
 {
   bool retcode = false;
 
@@ -214,10 +183,10 @@ operator_precedence(operator *this,
     *stack = 0;
   }
 
-  if( (this != (operator *) 0) && (this->op_prop != (operator_property *) 0) )
+  if(this != (const operator *) 0)
   {
-    *input = this->op_prop->input_precedence;
-    *stack = this->op_prop->stack_precedence;
+    *input = this->input_precedence;
+    *stack = this->stack_precedence;
 
     retcode = true;
   }
@@ -239,16 +208,16 @@ operator_precedence(operator *this,
  *   false = failure. *op_name points to "" (if it is a valid pointer).
  */
 bool
-operator_get_name(operator *this,
+operator_get_name(const operator *this,
                   const char **op_name)
 {
   bool retcode = false;
 
   if(op_name != (const char **) 0)
   {
-    if( (this != (operator *) 0) && (this->op_prop != (operator_property *) 0) )
+    if(this != (const operator *) 0)
     {
-      *op_name = this->op_prop->name;
+      *op_name = this->name;
       retcode = true;
     }
     else
@@ -270,16 +239,16 @@ operator_get_name(operator *this,
  *   false = failure.  *type is set to op_type_none (if it is a valid pointer).
  */
 bool
-operator_get_op_type(operator *this,
-                     operator_type *type)
+operator_get_op_type(const operator *this,
+                     operator_type  *type)
 {
   bool retcode = false;
 
   if(type != (operator_type *) 0)
   {
-    if(this != (operator *) 0)
+    if(this != (const operator *) 0)
     {
-      *type = this->op_prop->op_type;
+      *type = this->op_type;
       retcode = true;
     }
     else
@@ -303,16 +272,16 @@ operator_get_op_type(operator *this,
  *   false = failure.  *type is set to op_special_type_none (if it is a valid pointer).
  */
 bool
-operator_get_op_specialtype(operator *this,
+operator_get_op_specialtype(const operator *this,
                             operator_special_type *special_type)
 {
   bool retcode = false;
 
   if(special_type != (operator_special_type *) 0)
   {
-    if(this != (operator *) 0)
+    if(this != (const operator *) 0)
     {
-      *special_type = this->op_prop->op_special_type;
+      *special_type = this->op_special_type;
       retcode = true;
     }
     else
@@ -336,14 +305,14 @@ operator_get_op_specialtype(operator *this,
  *   false = failure.  op is undefined.
  */
 bool
-operator_do_unary(operator *this,
-                  operand *op)
+operator_do_unary(const operator *this,
+                  operand        *op)
 {
   bool retcode = false;
 
-  if(this->op_prop->unary_op_exec != (operand_unary_op) 0)
+  if(this->unary_op_exec != (operand_unary_op) 0)
   {
-    retcode = this->op_prop->unary_op_exec(op);
+    retcode = this->unary_op_exec(op);
   }
 
   return retcode;
@@ -363,15 +332,15 @@ operator_do_unary(operator *this,
  *   false = failure.
  */
 bool
-operator_do_binary(operator *this,
-                   operand *op1,
-                   operand *op2)
+operator_do_binary(const operator *this,
+                   operand        *op1,
+                   operand        *op2)
 {
   bool retcode = false;
 
-  if(this->op_prop->binary_op_exec != (operand_binary_op) 0)
+  if(this->binary_op_exec != (operand_binary_op) 0)
   {
-    retcode = this->op_prop->binary_op_exec(op1, op2);
+    retcode = this->binary_op_exec(op1, op2);
   }
 
   return retcode;
@@ -387,14 +356,89 @@ operator_test(void)
 {
   bool retcode = false;
 
-  operator *this = operator_new('+');
-  if(this != (operator *) 0)
+  do
   {
-    operator_delete(this);
+    /* Every operator maps to its own object, and back to its character. */
+    size_t i;
+    for(i = 0; i < (sizeof(operator_objects) / sizeof(operator_objects[0])); i++)
+    {
+      const operator *this = &operator_objects[i];
+      char value;
+      if(operator_get(this->value) != this)                                    { break; }
+      if(operator_is_valid_operator(this->value) != true)                      { break; }
+      if((operator_get_value(this, &value) != true) || (value != this->value)) { break; }
+    }
+    if(i != (sizeof(operator_objects) / sizeof(operator_objects[0])))          { break; }
+
+    /* Nothing else is an operator. */
+    int c;
+    size_t count = 0;
+    for(c = 0; c <= UINT8_MAX; c++)
+    {
+      count += (operator_get((char) c) != (const operator *) 0) ? 1 : 0;
+    }
+    if(count != (sizeof(operator_objects) / sizeof(operator_objects[0])))      { break; }
+    if(operator_get('0') != (const operator *) 0)                              { break; }
+    if(operator_is_valid_operator(0) != false)                                 { break; }
+
+    /* The same object every time. */
+    const operator *this = operator_get('+');
+    if((this == (const operator *) 0) || (operator_get('+') != this))          { break; }
+    int input, stack;
+    if((operator_precedence(this, &input, &stack) != true) || (input != 9) || (stack != 8)) { break; }
+    if(operator_precedence((const operator *) 0, &input, &stack) != false)    { break; }
+    char value;
+    if(operator_get_value((const operator *) 0, &value) != false)             { break; }
+
     retcode = true;
-  }
+  } while(0);
 
   return retcode;
 }
 #endif // TEST
 
+/******************************************************************************
+ ********************************* BENCH API **********************************
+ *****************************************************************************/
+
+#if defined(BENCH)
+
+bool
+operator_bench(void)
+{
+  /* The characters of a typical equation.  Each one is checked, and the
+   * operators are looked up and queried the way the calculator does it. */
+  const char *equation = "12*(3+4)-5/6^2+(7.5-8)*9/(10+11)-12";
+  const int   loops    = 1000000;
+
+  bench_timer timer;
+  uint64_t    tokens = 0;
+  uint64_t    allocs = bench_alloc_count();
+  int         sink   = 0;
+
+  bench_timer_start(&timer);
+  int x;
+  for(x = 0; x < loops; x++)
+  {
+    const char *p;
+    for(p = equation; *p != 0; p++, tokens++)
+    {
+      if(operator_is_valid_operator(*p) == true)
+      {
+        const operator *this = operator_get(*p);
+        operator_type op_type;
+        int input, stack;
+        operator_precedence(this, &input, &stack);
+        operator_get_op_type(this, &op_type);
+        sink += input + op_type;
+      }
+    }
+  }
+  bench_report("operator_get() per token", &timer, tokens, "tokens");
+  bench_report_allocs("operator_get() per token", (bench_alloc_count() - allocs), tokens, "token");
+  printf("  (checksum %d)\n", sink);
+
+  return true;
+}
+
+#endif // BENCH
@@ -34,23 +34,23 @@ typedef struct operator operator;
 
 /********************************* PUBLIC API *********************************/
 
-operator *operator_new(const char c);
-
-bool operator_delete(operator *this);
+const operator *operator_get(const char c);
 
 bool operator_is_valid_operator(char c);
 
-bool operator_precedence(operator *this, int *input, int *stack);
+bool operator_get_value(const operator *this, char *value);
+
+bool operator_precedence(const operator *this, int *input, int *stack);
 
-bool operator_get_name(operator *this, const char **op_name);
+bool operator_get_name(const operator *this, const char **op_name);
 
-bool operator_get_op_type(operator *this, operator_type *type);
+bool operator_get_op_type(const operator *this, operator_type *type);
 
-bool operator_get_op_specialtype(operator *this, operator_special_type *special_type);
+bool operator_get_op_specialtype(const operator *this, operator_special_type *special_type);
 
-bool operator_do_unary(operator *this, operand *op);
+bool operator_do_unary(const operator *this, operand *op);
 
-bool operator_do_binary(operator *this, operand *op1, operand *op2);
+bool operator_do_binary(const operator *this, operand *op1, operand *op2);
 
 /********************************** TEST API **********************************/
 
@@ -60,5 +60,13 @@ bool operator_test(void);
 
 #endif // TEST
 
+/********************************* BENCH API **********************************/
+
+#if defined(BENCH)
+
+bool operator_bench(void);
+
+#endif // BENCH
+
 #endif // __OPERATOR_H__
 
@@ -13,21 +13,6 @@
 #include "operand_base_10.h"
 #include "operator_exp.h"
 
-/******************************************************************************
- ****************************** CLASS DEFINITION ******************************
- *****************************************************************************/
-
-/* This is the operator_exp class. */
-struct operator_exp {
-  operand_base_10 *base;
-  operand_base_10 *exp;
-  operand_base_10 *result;
-
-  /* We often need to convert exp to a fraction.  It is stored here. */
-  uint64_t exp_numerator;
-  uint64_t exp_denominator;
-};
-
 /******************************************************************************
  ******************************** PRIMITIVES **********************************
  *****************************************************************************/
@@ -48,420 +33,250 @@ struct operator_exp {
  *   false = failure.  *result is undefined.
  */
 static bool
-operator_exp_integer_exp(operand_base_10 *base,
-                         int              exp,
-                         operand_base_10 *result)
+operator_exp_integer_exp(const operand_base_10 *base,
+                         uint64_t               exp,
+                         operand_base_10       *result)
 {
   bool retcode = false;
 
   if((base != (operand_base_10 *) 0) && (result != (operand_base_10 *) 0))
   {
-    operand_base_10 *rslt_tmp = (operand_base_10 *) 0;
-    operand_base_10 *base_tmp = (operand_base_10 *) 0;
-    operand_base_10 *zero     = (operand_base_10 *) 0;
-    operand_base_10 *one      = (operand_base_10 *) 0;
+    operand_base_10 rslt_obj, base_tmp;
+    operand_base_10 *rslt_tmp = (base == result) ? &rslt_obj : result;
 
     do
     {
-      if((rslt_tmp = (base == result) ? operand_base_10_new() : result) == (operand_base_10 *) 0) { break; }
-      if((base_tmp = operand_base_10_new()) == (operand_base_10 *) 0)                             { break; }
-      if((zero     = operand_base_10_new()) == (operand_base_10 *) 0)                             { break; }
-      if((one      = operand_base_10_new()) == (operand_base_10 *) 0)                             { break; }
-
-      if(operand_base_10_copy(base, base_tmp) == false)                                           { break; }
-      if(operand_base_10_import(zero, 0) == false)                                                { break; }
-      if(operand_base_10_import(one, 1) == false)                                                 { break; }
+      if(operand_base_10_copy(base, &base_tmp) == false)                                          { break; }
 
       /* Special case.  base ^ 0 = 1. */
       if(exp == 0)
       {
-        retcode = operand_base_10_copy(one, rslt_tmp);
+        retcode = operand_base_10_copy(&operand_base_10_integers[1], rslt_tmp);
         break;
       }
 
       /* Special case.  0 ^ exp = 0. */
-      if(operand_base_10_cmp(base, zero) == 0)
+      if(operand_base_10_cmp(base, &operand_base_10_integers[0]) == 0)
       {
-        retcode = operand_base_10_copy(zero, rslt_tmp);
+        retcode = operand_base_10_copy(&operand_base_10_integers[0], rslt_tmp);
         break;
       }
 
       /* Set res = 1.  (base ^ 0) = 1, so this is the right place to start. */
-      if(operand_base_10_import(rslt_tmp, 1) == false)                                            { break; }
+      if(operand_base_10_copy(&operand_base_10_integers[1], rslt_tmp) == false)                   { break; }
 
       while(exp != 0)
       {
         if((exp & 1) != 0)
         {
-          if(operand_base_10_op_mul(rslt_tmp, base_tmp) == false)                                 { break; }
+          if(operand_base_10_op_mul(rslt_tmp, &base_tmp) == false)                                { break; }
         }
 
-        /* Prepare for the next iteration. */
-        if(operand_base_10_op_mul(base_tmp, base_tmp) == false)                                   { break; }
+        /* Prepare for the next iteration.  Don't square the base after the
+         * last bit.  We don't need it, and it can overflow when the result
+         * doesn't. */
         exp >>= 1;
+        if((exp != 0) && (operand_base_10_op_mul(&base_tmp, &base_tmp) == false))                 { break; }
       }
 
       retcode = (exp == 0) ? true : false;
       
     } while(0);
 
-    operand_base_10_delete(one);
-    operand_base_10_delete(zero);
-    operand_base_10_delete(base_tmp);
-
     if((retcode == true) && (base == result))
     {
       retcode = operand_base_10_copy(rslt_tmp, result);
-      operand_base_10_delete(rslt_tmp);
     }
   }
 
   return retcode;
 }
 
-/******************************************************************************
- ******************************** PRIVATE API *********************************
- *****************************************************************************/
-
-/* Convert the floating point exponent into a fraction, and then reduce the
- * fraction.  For example, if this->exp = 3.45:
- * 1. Convert it to = 345/100.
- * 2. Reduce it down to 69/20.
+/* Calculate the natural logarithm of a positive number.
+ *
+ * The range reduction is done in 2 steps:
+ *
+ * 1. Pull out the power of 10.  x = m * 10^e, where 1 <= m < 10.  That's free,
+ *    because it's how the number is already stored.
+ *
+ * 2. Halve m until it's less than 1.5.  That takes at most 3 halvings, and
+ *    leaves 0.75 <= m < 1.5.
+ *
+ * So ln(x) = ln(m) + (k * ln(2)) + (e * ln(10)), where k is the number of
+ * halvings.  ln(m) comes from the series:
+ *
+ *   ln(m) = 2 * (z + z^3/3 + z^5/5 + ...), where z = (m - 1) / (m + 1).
  *
- * To reduce, find the greatest common Divisor (GCD) (using the Euclid method),
- * and use it to reduce the exponent fraction.
+ * |z| <= 0.2, so each term adds at least 1.4 digits.  We stop as soon as a term
+ * is too small to change the sum, so the cost is bounded by the precision.
  *
  * Input:
- *   this = A pointer to the operator_exp object.
+ *   x      = The number.  It must be > 0.
+ *
+ *   result = A pointer to the operand_base_10 object that will receive the
+ *            result.  It's okay if x == result.
  *
  * Output:
- *   true  = success.  The exponent has been converted to a fraction.  The
- *                     fraction is stored in this->exp_numerator and
- *                     this->exp_denominator.
- *   false = failure.  Something went wrong.
+ *   true  = success.  *result contains ln(x).
+ *   false = failure.  *result is undefined.
  */
 static bool
-operator_exp_to_fraction(operator_exp *this)
+operator_exp_ln(operand_base_10 *x,
+                operand_base_10 *result)
 {
   bool retcode = false;
 
-  /* We'll use these inside a loop, then we'll delete them when we're done. */
-  operand_base_10 *ten    = (operand_base_10 *) 0;
-  operand_base_10 *root   = (operand_base_10 *) 0;
-  operand_base_10 *tmp_f1 = (operand_base_10 *) 0;
-  operand_base_10 *tmp_f2 = (operand_base_10 *) 0;
+  operand_base_10 m, z, z2, term, t, sum, prev, tmp;
 
   do
   {
-    if(this == (operator_exp *) 0)                                       { break; }
+    if((x == (operand_base_10 *) 0) || (result == (operand_base_10 *) 0))         { break; }
 
-    if((ten    = operand_base_10_new()) == (operand_base_10 *) 0)        { break; }
-    if((root   = operand_base_10_new()) == (operand_base_10 *) 0)        { break; }
-    if((tmp_f1 = operand_base_10_new()) == (operand_base_10 *) 0)        { break; }
-    if((tmp_f2 = operand_base_10_new()) == (operand_base_10 *) 0)        { break; }
+    if(operand_base_10_init(&tmp) == false)                                       { break; }
+    if(operand_base_10_cmp(x, &tmp) <= 0)                                         { break; }
 
-    if(operand_base_10_import(ten, 10) == false)                         { break; }
+    /* Step 1.  x = m * 10^e. */
+    int16_t e;
+    if(operand_base_10_copy(x, &m) == false)                                      { break; }
+    if(operand_base_10_get_exponent(&m, &e) == false)                             { break; }
+    if(operand_base_10_scale(&m, (0 - e)) == false)                               { break; }
 
-    /* Convert the exponent to a fraction (numerator and denominator), and then
-     * reduce the fraction.
-     */
-    int loop;
-    for(loop = 1; loop < 20; loop++)
+    /* Step 2.  Halve m until it's < 1.5. */
+    int k;
+    for(k = 0; operand_base_10_cmp(&m, &operand_base_10_three_halves) >= 0; k++)
     {
-      if((retcode = operator_exp_integer_exp(ten, loop, root)) == false) { break; }
-
-      if(operand_base_10_copy(this->exp, tmp_f1) == false)               { break; }
-      if((retcode = operand_base_10_op_mul(tmp_f1, root)) == false)      { break; }
-
-      int64_t tmp_i;
-      if(operand_base_10_export(tmp_f1, &tmp_i) == false)                { break; }
-      if(operand_base_10_import(tmp_f2, tmp_i) == false)                 { break; }
-
-      if(operand_base_10_cmp(tmp_f1, tmp_f2) == 0)
-      {
-        this->exp_numerator = tmp_i;
-        if(operand_base_10_export(root, &tmp_i) == false)                { break; }
-        this->exp_denominator = tmp_i;
-        retcode = true;
-        break;
-      }
+      if(operand_base_10_op_mul(&m, &operand_base_10_reciprocals[2]) == false)    { break; }
     }
 
-    if(retcode == true)
+    /* z = (m - 1) / (m + 1). */
+    if(operand_base_10_copy(&m, &z) == false)                                     { break; }
+    if(operand_base_10_op_sub(&z, &operand_base_10_integers[1]) == false)         { break; }
+    if(operand_base_10_op_add(&m, &operand_base_10_integers[1]) == false)         { break; }
+    if(operand_base_10_op_div(&z, &m) == false)                                   { break; }
+    if(operand_base_10_copy(&z, &z2) == false)                                    { break; }
+    if(operand_base_10_op_mul(&z2, &z) == false)                                  { break; }
+
+    /* sum = z + z^3/3 + z^5/5 + ...  Dividing by n is a multiply by 1/n from
+     * the reciprocal table. */
+    if(operand_base_10_copy(&z, &sum) == false)                                   { break; }
+    if(operand_base_10_copy(&z, &term) == false)                                  { break; }
+    int n;
+    for(n = 3; n < 200; n += 2)
     {
-      DBG_PRINT("%s(BEF): this->exp_numerator %lld: this->exp_denominator %lld\n",
-                  __func__, this->exp_numerator, this->exp_denominator);
+      if(operand_base_10_op_mul(&term, &z2) == false)                             { break; }
+      if(operand_base_10_copy(&term, &t) == false)                                { break; }
+      if(operand_base_10_op_mul(&t, &operand_base_10_reciprocals[n]) == false)    { break; }
 
-      /* Initialize a and b to equal the numerator and denominator.  Make sure
-       * that a >= b. */
-      uint64_t a, b;
-      if(this->exp_numerator >= this->exp_denominator)
-      {
-        a = this->exp_numerator;
-        b = this->exp_denominator;
-      }
-      else
-      {
-        a = this->exp_denominator;
-        b = this->exp_numerator;
-      }
+      if(operand_base_10_copy(&sum, &prev) == false)                              { break; }
+      if(operand_base_10_op_add(&sum, &t) == false)                               { break; }
+      if(operand_base_10_cmp(&sum, &prev) == 0)                                   { break; }
+    }
+    if(n >= 200)                                                                  { break; }
 
-      /* Loop until we calculate the GCD. */
-      uint64_t gcd;
-      while(1)
-      {
-        if((gcd = a % b) == 0)
-        {
-          gcd = b;
-          break;
-        }
+    /* ln(x) = (2 * sum) + (k * ln(2)) + (e * ln(10)). */
+    if(operand_base_10_copy(&sum, &prev) == false)                                { break; }
+    if(operand_base_10_op_add(&sum, &prev) == false)                              { break; }
 
-        a = b;
-        b = gcd;
-      }
+    if(operand_base_10_copy(&operand_base_10_ln2, &t) == false)                   { break; }
+    if(operand_base_10_op_mul(&t, &operand_base_10_integers[k]) == false)         { break; }
+    if(operand_base_10_op_add(&sum, &t) == false)                                 { break; }
 
-      /* Now reduce the fraction by the GCD. */
-      this->exp_numerator /= gcd;
-      this->exp_denominator /= gcd;
+    if(operand_base_10_copy(&operand_base_10_ln10, &t) == false)                  { break; }
+    if(operand_base_10_import(&tmp, e) == false)                                  { break; }
+    if(operand_base_10_op_mul(&t, &tmp) == false)                                 { break; }
+    if(operand_base_10_op_add(&sum, &t) == false)                                 { break; }
 
-      DBG_PRINT("%s(AFT): this->exp_numerator %lld: this->exp_denominator %lld\n",
-                  __func__, this->exp_numerator, this->exp_denominator);
-    }
+    retcode = operand_base_10_copy(&sum, result);
   } while(0);
 
-  operand_base_10_delete(tmp_f2);
-  operand_base_10_delete(tmp_f1);
-  operand_base_10_delete(root);
-  operand_base_10_delete(ten);
-
   return retcode;
 }
 
-/* This is a very fast-converging nth root algorithm to find the nth root of A.
- *
- * Taken from http://en.wikipedia.org/wiki/Nth_root_algorithm
+/* Calculate e^y.
  *
- * We're calculating the "n"th root of "A".
+ * The range reduction is done in 2 steps:
  *
- * 1. Make an initial guess X_k.
+ * 1. Pull out a power of 10.  y = (k * ln(10)) + r, where |r| < ln(10).  Then
+ *    e^y = e^r * 10^k, and multiplying by 10^k is free.
  *
- * 2. X_k+1 = (1 / n) * ( (n - 1) * X_k + (A / X_k^(n-1))).
+ * 2. Divide r by 2^8.  e^r = (e^(r / 256))^256, and |r / 256| < 0.009.
  *
- *    In practice we do:
- *      Delta X_k = (1 / n) * ((A / X_k^(n-1)) - X_k); X_k+1 = X_k + Delta X_k.
- *
- * 3. Repeat step 2 until the desired precision is reached, i.e.
- *      |Delta X_k| < Epsilon.
+ * e^(r / 256) comes from the Taylor series (1 + r + r^2/2! + r^3/3! + ...),
+ * which only needs a dozen or so terms at that size.  We stop as soon as a term
+ * is too small to change the sum.  Then we square the sum 8 times.
  *
  * Input:
- *   this  = A pointer to the operator_exp object.  In this member, the
- *           variables are as follows:
- *           A   = this->base
- *           n   = this->exp_denominator
+ *   y      = The exponent.
  *
- *   guess = A pointer to a operand_base_10 object that will receive the guess.
- *           X_k = guess
+ *   result = A pointer to the operand_base_10 object that will receive the
+ *            result.  It's okay if y == result.
  *
  * Output:
- *   true  = success.  *guess contains the guess.
- *   false = failure.  The contents of *guess is undefined.
+ *   true  = success.  *result contains e^y.
+ *   false = failure.  The result is too big or too small to store, or
+ *                     something else went wrong.  *result is undefined.
  */
 static bool
-operator_exp_nth_root_guess(operator_exp    *this,
-                            operand_base_10 *guess)
+operator_exp_exp(operand_base_10 *y,
+                 operand_base_10 *result)
 {
   bool retcode = false;
 
-  operand_base_10 *A              = (operand_base_10 *) 0;
-  operand_base_10 *n_f            = (operand_base_10 *) 0;
-  operand_base_10 *X_k            = (operand_base_10 *) 0;
-  operand_base_10 *part1          = (operand_base_10 *) 0;
-  operand_base_10 *part2          = (operand_base_10 *) 0;
-  operand_base_10 *part3          = (operand_base_10 *) 0;
-  operand_base_10 *part4          = (operand_base_10 *) 0;
-  operand_base_10 *delta_X_k      = (operand_base_10 *) 0;
-  operand_base_10 *delta_X_k_prev = (operand_base_10 *) 0;
-  operand_base_10 *zero           = (operand_base_10 *) 0;
-  operand_base_10 *guess_tmp      = (operand_base_10 *) 0;
-  operand_base_10 *best_diff      = (operand_base_10 *) 0;
-  operand_base_10 *test_rslt      = (operand_base_10 *) 0;
-  operand_base_10 *test_diff      = (operand_base_10 *) 0;
+  operand_base_10 r, q, term, sum, prev, tmp;
 
   do
   {
-    if(this == (operator_exp *) 0)                                        { break; }
-    if(guess == (operand_base_10 *) 0)                                    { break; }
-
-    if((A = operand_base_10_new()) == (operand_base_10 *) 0)              { break; }
-    if(operand_base_10_copy(this->base, A) == false)                      { break; }
-
-    uint64_t n_int = this->exp_denominator;
-    if((n_f = operand_base_10_new()) == (operand_base_10 *) 0)            { break; }
-    if(operand_base_10_import(n_f, this->exp_denominator) == false)       { break; }
-
-    if((X_k = operand_base_10_new()) == (operand_base_10 *) 0)            { break; }
-    if(operand_base_10_import(X_k, 1) == false)                           { break; }
-
-    if((part1          = operand_base_10_new()) == (operand_base_10 *) 0) { break; }
-    if((part2          = operand_base_10_new()) == (operand_base_10 *) 0) { break; }
-    if((part3          = operand_base_10_new()) == (operand_base_10 *) 0) { break; }
-    if((part4          = operand_base_10_new()) == (operand_base_10 *) 0) { break; }
-    if((delta_X_k      = operand_base_10_new()) == (operand_base_10 *) 0) { break; }
-    if((delta_X_k_prev = operand_base_10_new()) == (operand_base_10 *) 0) { break; }
-
-    if((zero           = operand_base_10_new()) == (operand_base_10 *) 0) { break; }
-    if(operand_base_10_import(zero, 0) == false)                          { break; }
-
-    if(operand_base_10_import(delta_X_k_prev, 0) == false)                { break; }
-
-    if((best_diff = operand_base_10_new()) == (operand_base_10 *) 0)      { break; }
-    if((test_rslt = operand_base_10_new()) == (operand_base_10 *) 0)      { break; }
-    if((test_diff = operand_base_10_new()) == (operand_base_10 *) 0)      { break; }
-
-    /* Solve the nth root (see description above).
-     *
-     *                       --------PART__4--------
-     *                       -----PART__3----
-     *             PART__1         -PART__2-
-     * Delta X_k = (1 / n) * ((A / X_k^(n-1)) - X_k); X_k+1 = X_k + Delta X_k.
-     */
-    if(operand_base_10_import(part1, 1) == false)                         { break; }
-    if(operand_base_10_op_div(part1, n_f) == false)                       { break; }
-    DBG_PRINT("%s(): START: A %s: n %s: X_k %s: part1 %s\n", __func__,
-              operand_base_10_get_dbg_info(A),
-              operand_base_10_get_dbg_info(n_f),
-              operand_base_10_get_dbg_info(X_k),
-              operand_base_10_get_dbg_info(part1));
-
-    int x;
-    for(x = 0; x < 100000; x++)
+    if((y == (operand_base_10 *) 0) || (result == (operand_base_10 *) 0))         { break; }
+
+    /* Step 1.  k = trunc(y / ln(10)).  r = y - (k * ln(10)). */
+    if(operand_base_10_copy(y, &q) == false)                                      { break; }
+    if(operand_base_10_op_div(&q, &operand_base_10_ln10) == false)                { break; }
+
+    /* If |k| won't fit in the exponent, then neither will the result. */
+    int16_t q_exp;
+    if(operand_base_10_get_exponent(&q, &q_exp) == false)                         { break; }
+    if(q_exp > 4)                                                                 { break; }
+
+    int64_t k;
+    if(operand_base_10_export(&q, &k) == false)                                   { break; }
+    if((k < INT16_MIN) || (k > INT16_MAX))                                        { break; }
+    if(operand_base_10_import(&tmp, k) == false)                                  { break; }
+    if(operand_base_10_op_mul(&tmp, &operand_base_10_ln10) == false)              { break; }
+    if(operand_base_10_copy(y, &r) == false)                                      { break; }
+    if(operand_base_10_op_sub(&r, &tmp) == false)                                 { break; }
+
+    /* Step 2.  r = r / 2^8.  1 / 2^8 = 0.00390625, so it's an exact multiply. */
+    if(operand_base_10_op_mul(&r, &operand_base_10_reciprocals[256]) == false)    { break; }
+
+    /* sum = 1 + r + r^2/2! + r^3/3! + ...  Dividing by n is a multiply by 1/n
+     * from the reciprocal table. */
+    if(operand_base_10_copy(&operand_base_10_integers[1], &sum) == false)         { break; }
+    if(operand_base_10_copy(&operand_base_10_integers[1], &term) == false)        { break; }
+    int n;
+    for(n = 1; n < 100; n++)
     {
-      DBG_PRINT("%s(): %4d\n", __func__, x);
-
-      if(operator_exp_integer_exp(X_k, (n_int - 1), part2) == false)      { break; }
-      DBG_PRINT("%s(): PART2: %s ^ %lld = %s\n", __func__,
-                operand_base_10_get_dbg_info(X_k),
-                (n_int - 1),
-                operand_base_10_get_dbg_info(part2));
-
-      if(operand_base_10_copy(A, part3) == false)                         { break; }
-      if(operand_base_10_op_div(part3, part2) == false)                   { break; }
-      DBG_PRINT("%s(): PART3: %s / %s = %s\n", __func__,
-                operand_base_10_get_dbg_info(A),
-                operand_base_10_get_dbg_info(part2),
-                operand_base_10_get_dbg_info(part3));
-
-      if(operand_base_10_copy(part3, part4) == false)                     { break; }
-      if(operand_base_10_op_sub(part4, X_k) == false)                     { break; }
-      DBG_PRINT("%s(): PART4: %s - %s = %s\n", __func__,
-                operand_base_10_get_dbg_info(part3),
-                operand_base_10_get_dbg_info(X_k),
-                operand_base_10_get_dbg_info(part4));
-
-      if(operand_base_10_copy(part1, delta_X_k) == false)                 { break; }
-      if(operand_base_10_op_mul(delta_X_k, part4) == false)               { break; }
-      DBG_PRINT("%s(): Delta X_k: %s * %s = %s\n", __func__,
-                operand_base_10_get_dbg_info(part1),
-                operand_base_10_get_dbg_info(part4),
-                operand_base_10_get_dbg_info(delta_X_k));
-
-      DBG_PRINT("%s(): Compare %s vs %s\n", __func__,
-                operand_base_10_get_dbg_info(delta_X_k),
-                operand_base_10_get_dbg_info(delta_X_k_prev));
-      if(operand_base_10_cmp(delta_X_k, delta_X_k_prev) == 0)
-      {
-        break;
-      }
-
-      if(operand_base_10_copy(delta_X_k, delta_X_k_prev) == false)        { break; }
-      if(operand_base_10_op_add(X_k, delta_X_k) == false)                 { break; }
-      if(operand_base_10_copy(X_k, guess) == false)                       { break; }
-      DBG_PRINT("%s(): guess = %s\n", __func__, operand_base_10_get_dbg_info(guess));
-
-      /* Check to see if we found the answer. */
-      {
-        /* Take our current result and use it as the base to recalculate and see
-         * we found the result.  Another way to look at it is:
-         * We're trying to find: guess = n'th root of A.
-         * We'll test by finding: test_rslt = guess ^ n.
-         * Then we compare test_rslt against A and see how close we are. */
-        if(operator_exp_integer_exp(guess, n_int, test_rslt) == false)    { break; }
-
-        int test_result = operand_base_10_cmp(A, test_rslt);
-        if(test_result == 0)
-        {
-          /* We found the exactly perfect answer.  Drop out and return. */
-          retcode = true;
-          break;
-        }
-        else if(test_result == -1)
-        {
-          /* guess is too high.  Calculate how far off we are. */
-          operand_base_10_copy(test_rslt, test_diff);
-          operand_base_10_op_sub(test_diff, A);
-        }
-        else if(test_result == 1)
-        {
-          /* guess is too low.  Calculate how far off we are. */
-          operand_base_10_copy(A, test_diff);
-          operand_base_10_op_sub(test_diff, test_rslt);
-        }
-
-        /* If this is the first test, just save the test_diff and go again. */
-        if(operand_base_10_cmp(best_diff, zero) == 0)
-        {
-          operand_base_10_copy(test_diff, best_diff);
-        }
+      if(operand_base_10_op_mul(&term, &r) == false)                              { break; }
+      if(operand_base_10_op_mul(&term, &operand_base_10_reciprocals[n]) == false) { break; }
 
-        /* Otherwise, check to see if this is the best answer we've calculated
-         * so far.  If it is, save it. */
-        else
-        {
-          test_result = operand_base_10_cmp(test_diff, best_diff);
-          if(test_result == 0)
-          {
-            /* We've seen this answer before.  This is the best we're going to
-             * do.  Return that answer. */
-            retcode = true;
-            break;
-          }
-          else if(test_result == -1)
-          {
-            /* This is our best answer so far.  Save it. */
-            operand_base_10_copy(test_diff, best_diff);
-          }
-        }
-      }
+      if(operand_base_10_copy(&sum, &prev) == false)                              { break; }
+      if(operand_base_10_op_add(&sum, &term) == false)                            { break; }
+      if(operand_base_10_cmp(&sum, &prev) == 0)                                   { break; }
     }
+    if(n >= 100)                                                                  { break; }
 
-    /* The guess is always positive. */
-    if(operand_base_10_cmp(guess, zero) < 0)
+    /* Undo step 2. */
+    for(n = 0; n < 8; n++)
     {
-      if((guess_tmp = operand_base_10_new()) == (operand_base_10 *) 0)    { break; }
-      if(operand_base_10_copy(zero, guess_tmp) == false)                  { break; }
-      if(operand_base_10_op_sub(guess_tmp, guess) == false)               { break; }
-      if(operand_base_10_copy(guess_tmp, guess) == false)                 { break; }
+      if(operand_base_10_op_mul(&sum, &sum) == false)                             { break; }
     }
+    if(n < 8)                                                                     { break; }
 
-    DBG_PRINT("%s(): guess %s\n", __func__, operand_base_10_get_dbg_info(guess));
+    /* Undo step 1. */
+    if(operand_base_10_scale(&sum, k) == false)                                   { break; }
 
-    retcode = true;
+    retcode = operand_base_10_copy(&sum, result);
   } while(0);
 
-  operand_base_10_delete(test_diff);
-  operand_base_10_delete(test_rslt);
-  operand_base_10_delete(best_diff);
-  operand_base_10_delete(guess_tmp);
-  operand_base_10_delete(zero);
-  operand_base_10_delete(delta_X_k);
-  operand_base_10_delete(part4);
-  operand_base_10_delete(part3);
-  operand_base_10_delete(part2);
-  operand_base_10_delete(part1);
-  operand_base_10_delete(X_k);
-  operand_base_10_delete(n_f);
-  operand_base_10_delete(A);
-
   return retcode;
 }
 
@@ -482,37 +297,60 @@ operator_exp_nth_root_guess(operator_exp    *this,
  *   Returns 0 if unable to create the object.
  */
 operator_exp *
-operator_exp_new(operand_base_10 *base,
-                 operand_base_10 *exp)
+operator_exp_new(const operand_base_10 *base,
+                 const operand_base_10 *exp)
 {
-  operator_exp *this = (operator_exp *) 0;
+  operator_exp *this = malloc(sizeof(*this));
 
-  bool success = false;
-  do
+  if(this != (operator_exp *) 0)
   {
-    /* Initialize. */
-    if((this = (operator_exp *) malloc(sizeof(*this))) == (operator_exp *) 0)         { break; }
+    if(operator_exp_init(this, base, exp) == false)
+    {
+      operator_exp_delete(this);
+      this = (operator_exp *) 0;
+    }
+  }
 
-    this->base   = operand_base_10_new();
-    this->exp    = operand_base_10_new();
-    this->result = operand_base_10_new();
+  return this;
+}
+
+/* Initialize an operator_exp object that lives in caller-owned storage (i.e.
+ * on the stack).  This is the allocation-free version of operator_exp_new().
+ *
+ * Objects that are initialized this way must NOT be passed to
+ * operator_exp_delete().
+ *
+ * Input:
+ *   this = A pointer to the caller-owned operator_exp object.
+ *
+ *   base = The floating point base.
+ *
+ *   exp  = The floating point exponent.
+ *
+ * Output:
+ *   true  = success.  this is ready to be passed to operator_exp_calc().
+ *   false = failure.  this is undefined.
+ */
+bool
+operator_exp_init(operator_exp          *this,
+                  const operand_base_10 *base,
+                  const operand_base_10 *exp)
+{
+  bool retcode = false;
+
+  do
+  {
+    if(this == (operator_exp *) 0)                                    { break; }
 
     /* Make copies of the base and exponent. */
-    if((this->base == (operand_base_10 *) 0) || (this->exp == (operand_base_10 *) 0)) { break; }
-    
-    if(operand_base_10_copy(base, this->base) == false)                               { break; }
-    if(operand_base_10_copy(exp,  this->exp) == false)                                { break; }
+    if(operand_base_10_copy(base, &this->base) == false)              { break; }
+    if(operand_base_10_copy(exp,  &this->exp) == false)               { break; }
+    if(operand_base_10_init(&this->result) == false)                  { break; }
 
-    success = true;
+    retcode = true;
   } while(0);
 
-  if(success == false)
-  {
-    operator_exp_delete(this);
-    this = (operator_exp *) 0;
-  }
-
-  return this;
+  return retcode;
 }
 
 /* Delete an operator_exp object that was created by operator_exp_new().
@@ -531,10 +369,6 @@ operator_exp_delete(operator_exp *this)
 
   if(this != (operator_exp *) 0)
   {
-    operand_base_10_delete(this->result);
-    operand_base_10_delete(this->exp);
-    operand_base_10_delete(this->base);
-
     free(this);
 
     retcode = true;
@@ -543,31 +377,19 @@ operator_exp_delete(operator_exp *this)
   return retcode;
 }
 
-/*
- * Taken from http://mathforum.org/library/drmath/view/55896.html
+/* Calculate base ^ exp.
  *
- * What we want to do in this module is calculate an exponentiation where the
- * exponent is not an integer.  For this explanation, we'll use the following
- * example:
+ * If the exponent is a whole number, we do it with repeated squaring (see
+ * operator_exp_integer_exp()).  That's exact (within the precision of the
+ * significand).
  *
- *     x = (5^3.4).
+ * If the exponent has a fractional part, we use:
  *
- * Using this example, we need to think of (3.4) as (34/10).  (34/10) can be
- * thought of as (34 * 1/10).  Using this info, we can rewrite the original
- * problem as:
+ *     base^exp = e^(exp * ln(base))
  *
- *     x = ( 5^(1/10) )^34).
- *
- * 1. Breaking this down into 2 steps, we first solve the 5th root of 10.  Easy
- *    enough.  We can do that using Newton's guessing algorithm.
- *
- *     R = 5^(1/10)
- *
- * 2. Then we solve the following:
- *
- *     x = R^34
- *
- * And then we have solved x = (5^3.4).
+ * Both e^y and ln(x) are range-reduced and then summed with a series, so the
+ * cost is bounded by the precision we're working with, not by how many digits
+ * are in the exponent.
  *
  * Input:
  *   this   = A pointer to the operator_exp object.
@@ -581,84 +403,69 @@ operator_exp_calc(operator_exp *this)
 {
   bool retcode = false;
 
-  operand_base_10 *zero      = (operand_base_10 *) 0;
-  operand_base_10 *one       = (operand_base_10 *) 0;
-  operand_base_10 *tmp_exp_f = (operand_base_10 *) 0;
-  operand_base_10 *guess     = (operand_base_10 *) 0;
-  operand_base_10 *exp_tmp   = (operand_base_10 *) 0;
+  operand_base_10 zero, one, tmp_exp_f, y, exp_tmp;
 
   do
   {
     if(this == (operator_exp *) 0)                                                           { break; }
 
-    if((zero      = operand_base_10_new()) == (operand_base_10 *) 0)                         { break; }
-    if((one       = operand_base_10_new()) == (operand_base_10 *) 0)                         { break; }
-    if((tmp_exp_f = operand_base_10_new()) == (operand_base_10 *) 0)                         { break; }
-    if((guess     = operand_base_10_new()) == (operand_base_10 *) 0)                         { break; }
-    if((exp_tmp   = operand_base_10_new()) == (operand_base_10 *) 0)                         { break; }
+    if(operand_base_10_init(&zero) == false)                                                 { break; }
 
     /* If the exponent is negative, convert to its absolute value and set a flag
      * to remind us it was negative.  x^-n = 1/(x^n), so we just need to get the
      * inverse when we're done. */
-    bool is_neg_exponent = (operand_base_10_cmp(this->exp, zero) < 0);
+    bool is_neg_exponent = (operand_base_10_cmp(&this->exp, &zero) < 0);
     if(is_neg_exponent)
     {
-      if(operand_base_10_copy(this->exp, exp_tmp) == false)                                  { break; }
-      if(operand_base_10_copy(zero, this->exp) == false)                                     { break; }
-      if(operand_base_10_op_sub(this->exp, exp_tmp) == false)                                { break; }
+      if(operand_base_10_copy(&this->exp, &exp_tmp) == false)                                { break; }
+      if(operand_base_10_copy(&zero, &this->exp) == false)                                   { break; }
+      if(operand_base_10_op_sub(&this->exp, &exp_tmp) == false)                              { break; }
     }
 
     /* Check to see if the exponent is a whole number.  If it is, then we can do
      * easy exponentiation. */
     int64_t tmp_exp_i;
-    if(operand_base_10_export(this->exp, &tmp_exp_i) == false)                               { break; }
-    if(operand_base_10_import(tmp_exp_f, tmp_exp_i) == false)                                { break; }
-    if(operand_base_10_cmp(this->exp, tmp_exp_f) == 0)
+    if(operand_base_10_export(&this->exp, &tmp_exp_i) == false)                              { break; }
+    if(operand_base_10_import(&tmp_exp_f, tmp_exp_i) == false)                               { break; }
+    if(operand_base_10_cmp(&this->exp, &tmp_exp_f) == 0)
     {
-      if((retcode = operator_exp_integer_exp(this->base, tmp_exp_i, this->result)) == false) { break; }
+      retcode = operator_exp_integer_exp(&this->base, tmp_exp_i, &this->result);
+      if(retcode == false)                                                                   { break; }
     }
 
     else
     {
       /* At this point we know the exponent is a fraction.  This means the base
        * must be a positive number.  If it's not, the equation is invalid. */
-     if(operand_base_10_cmp(this->base, zero) < 0)                                           { break; }
-
-      /* Convert the exponent to a fraction (numerator and denominator). */
-      if(operator_exp_to_fraction(this) == false)                                            { break; }
-
-      /* Solve the nth root (see description above). */
-      if(operator_exp_nth_root_guess(this, guess) == false)                                  { break; }
+     if(operand_base_10_cmp(&this->base, &zero) < 0)                                         { break; }
 
-      char buf1[64], buf2[64];
-      if(operand_base_10_to_str(this->base, buf1, sizeof(buf1)) == false)                    { break; }
-      if(operand_base_10_to_str(guess,      buf2, sizeof(buf2)) == false)                    { break; }
-      DBG_PRINT("%s(): nth_root: this->base %s: this->exp_denominator %lld: guess %s\n",
-                 __func__, buf1, this->exp_denominator, buf2);
-
-      if(operator_exp_integer_exp(guess, this->exp_numerator, this->result) == false)        { break; }
-      if(operand_base_10_to_str(guess,        buf1, sizeof(buf1)) == false)                  { break; }
-      if(operand_base_10_to_str(this->result, buf2, sizeof(buf2)) == false)                  { break; }
-      DBG_PRINT("%s(): exp: guess %s: this->exp_numerator %lld: this->result %s\n",
-                  __func__, buf1, this->exp_numerator, buf2);
+      /* 0 ^ exp = 0.  Otherwise base^exp = e^(exp * ln(base)). */
+      if(operand_base_10_cmp(&this->base, &zero) == 0)
+      {
+        if(operand_base_10_copy(&zero, &this->result) == false)                              { break; }
+      }
+      else
+      {
+        if(operator_exp_ln(&this->base, &y) == false)                                        { break; }
+        if(operand_base_10_op_mul(&y, &this->exp) == false)                                  { break; }
+        if(operator_exp_exp(&y, &this->result) == false)                                     { break; }
+      }
+      DBG_PRINT("%s(): %s ^ %s = %s\n", __func__,
+                operand_base_10_get_dbg_info(&this->base),
+                operand_base_10_get_dbg_info(&this->exp),
+                operand_base_10_get_dbg_info(&this->result));
 
       retcode = true;
     }
 
     if((retcode == true) && (is_neg_exponent == true))
     {
-      if((retcode = operand_base_10_import(one, 1)) == false)                                { break; }
-      if((retcode = operand_base_10_op_div(one, this->result)) == false)                     { break; }
-      if((retcode = operand_base_10_copy(one, this->result)) == false)                       { break; }
+      if((retcode = operand_base_10_copy(&operand_base_10_integers[1], &one)) == false)      { break; }
+      if((retcode = operand_base_10_op_div(&one, &this->result)) == false)                   { break; }
+      if((retcode = operand_base_10_copy(&one, &this->result)) == false)                     { break; }
     }
   } while(0);
 
-  operand_base_10_delete(exp_tmp);
-  operand_base_10_delete(guess);
-  operand_base_10_delete(tmp_exp_f);
-  operand_base_10_delete(one);
-  operand_base_10_delete(zero);
-
   return retcode;
 }
 
@@ -681,7 +488,7 @@ operator_exp_get_result(operator_exp    *this,
 
   if((this != (operator_exp *) 0) && (result != (operand_base_10 *) 0))
   {
-    retcode = operand_base_10_copy(this->result, result);
+    retcode = operand_base_10_copy(&this->result, result);
   }
 
   return retcode;
@@ -727,13 +534,17 @@ operator_exp_test(void)
     { "FP_EXP_20",  "2"    , "199"      ,                     "8.034690221294951e+59" }, // big exponent.
     { "FP_EXP_21", "25.43" ,   "1"      ,                    "25.43"                  }, // X ^ 1 = X.
     { "FP_EXP_22",  "3"    ,  "12.345"  ,               "776,357.7442839795"          }, // Stolen from calculator.c.
+    { "FP_EXP_23",  "4"    ,    ".5"    ,                     "2"                     }, // Exact roots.
+    { "FP_EXP_24", "16"    ,    ".25"   ,                     "2"                     },
+    { "FP_EXP_25",   ".25" ,    ".5"    ,                     "0.5"                   },
+    { "FP_EXP_26", "1000000",   ".5"    ,                 "1,000"                     },
+    { "FP_EXP_27",  "2"    ,    ".1234567",                   "1.089341803147077"     }, // Long fraction.
+    { "FP_EXP_28",  "0"    ,   "2.5"    ,                     "0"                     }, // zero base, fractional exponent.
+    { "FP_EXP_29",  "1"    ,  "12.345"  ,                     "1"                     }, // ln(1) = 0.
+    { "FP_EXP_30",   ".5"  ,  "10.5"    ,                     "6.905339660024878e-4"  }, // base < 1.
   };
   size_t tests_size = (sizeof(tests) / sizeof(operator_exp_test));
 
-  operand_base_10 *base   = (operand_base_10 *) 0;
-  operand_base_10 *exp    = (operand_base_10 *) 0;
-  operand_base_10 *result = (operand_base_10 *) 0;
-
   do
   {
     int x;
@@ -742,27 +553,27 @@ operator_exp_test(void)
       operator_exp_test *t = &tests[x];
       printf("%s: %s ^ %s\n", t->name, t->base, t->exp);
 
-      if((base   = operand_base_10_new()) == (operand_base_10 *) 0)   { break; }
-      if((exp    = operand_base_10_new()) == (operand_base_10 *) 0)   { break; }
-      if((result = operand_base_10_new()) == (operand_base_10 *) 0)   { break; }
+      operand_base_10 base, exp, result;
+      if(operand_base_10_init(&base) == false)                         { break; }
+      if(operand_base_10_init(&exp) == false)                          { break; }
+      if(operand_base_10_init(&result) == false)                       { break; }
 
       /* Load the base and exponent into operand_base_10 objects.  We're not testing the operand_base_10
        * class here, so don't worry too much about error checking. */
       {
         char *p;
-        for(p = t->base; *p != 0; p++) { operand_base_10_add_char(base, *p); }
-        for(p = t->exp;  *p != 0; p++) { operand_base_10_add_char(exp,  *p); }
+        for(p = t->base; *p != 0; p++) { operand_base_10_add_char(&base, *p); }
+        for(p = t->exp;  *p != 0; p++) { operand_base_10_add_char(&exp,  *p); }
       }
 
-      operator_exp *obj;
-      if((obj = operator_exp_new(base, exp)) == (operator_exp *) 0)   { break; }
+      operator_exp obj;
+      if(operator_exp_init(&obj, &base, &exp) == false)                { break; }
 
-      if(operator_exp_calc(obj) == false)                             { break; }
-      if(operator_exp_get_result(obj, result) == false)               { break; }
-      if(operator_exp_delete(obj) == false)                           { break; }
+      if(operator_exp_calc(&obj) == false)                             { break; }
+      if(operator_exp_get_result(&obj, &result) == false)              { break; }
 
       char buf1[1024];
-      if(operand_base_10_to_str(result, buf1, sizeof(buf1)) == false) { break; }
+      if(operand_base_10_to_str(&result, buf1, sizeof(buf1)) == false) { break; }
       printf("  result = %s: t->result %s: ", buf1, t->result);
 
       if(strcmp(buf1, t->result) == 0)
@@ -774,23 +585,31 @@ operator_exp_test(void)
         printf("FAIL\n");
         break;
       }
+    }
+    if(x < tests_size)                                                 { break; }
 
-      if(operand_base_10_delete(base)   != true)                      { break; }
-      base   = (operand_base_10 *) 0;
-      if(operand_base_10_delete(exp)    != true)                      { break; }
-      exp    = (operand_base_10 *) 0;
-      if(operand_base_10_delete(result) != true)                      { break; }
-      result = (operand_base_10 *) 0;
+    /* Make sure the heap versions still work. */
+    {
+      operand_base_10 base, exp, result;
+      char buf1[64];
+      operand_base_10_import(&base, 3);
+      operand_base_10_import(&exp, 4);
+      operand_base_10_init(&result);
+
+      operator_exp *obj;
+      if((obj = operator_exp_new(&base, &exp)) == (operator_exp *) 0)  { break; }
+      if(operator_exp_calc(obj) == false)                              { break; }
+      if(operator_exp_get_result(obj, &result) == false)               { break; }
+      if(operator_exp_delete(obj) == false)                            { break; }
+      if(operand_base_10_to_str(&result, buf1, sizeof(buf1)) == false) { break; }
+      printf("FP_EXP_NEW: 3 ^ 4 = %s: %s\n", buf1, (strcmp(buf1, "81") == 0) ? "PASS" : "FAIL");
+      if(strcmp(buf1, "81") != 0)                                      { break; }
     }
 
     retcode = true;
 
   } while(0);
 
-  operand_base_10_delete(result);
-  operand_base_10_delete(exp);
-  operand_base_10_delete(base);
-
   return retcode;
 }
 #endif // TEST
@@ -7,11 +7,21 @@
 
 /****************************** CLASS DEFINITION ******************************/
 
-typedef struct operator_exp operator_exp;
+/* The class is defined here so that callers can keep an operator_exp object on
+ * the stack (see operand_base_10_op_exp()).  Use operator_exp_init() to
+ * initialize one of those objects.  The members are private.
+ */
+typedef struct operator_exp {
+  operand_base_10 base;
+  operand_base_10 exp;
+  operand_base_10 result;
+} operator_exp;
 
 /********************************* PUBLIC API *********************************/
 
-operator_exp *operator_exp_new(operand_base_10 *base, operand_base_10 *exp);
+operator_exp *operator_exp_new(const operand_base_10 *base, const operand_base_10 *exp);
+
+bool operator_exp_init(operator_exp *this, const operand_base_10 *base, const operand_base_10 *exp);
 
 bool operator_exp_delete(operator_exp *this);
 
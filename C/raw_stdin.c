@@ -1,32 +1,154 @@
 /* A simple class that configures the console device as a raw device so a
  * program can read keyboard input one character at a time as it is being
  * entered by the user.  It makes for better user interaction.
+ *
+ * The input is buffered.  When the buffer is empty, we read everything that
+ * the device has ready (up to the size of the buffer) in one read().  A paste
+ * arrives as a burst of characters, so it costs a handful of reads instead of
+ * one per character, and the caller can use raw_stdin_getchar_nowait() to
+ * find the end of the burst.
  */
+#include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <termios.h>
 
 #include "common.h"
 
+#include "bench.h"
+#include "calculator.h"
 #include "raw_stdin.h"
 
 /******************************************************************************
  ****************************** CLASS DEFINITION ******************************
  *****************************************************************************/
 
+/* The size of the input buffer.  It's the most that one read() can return. */
+#define RAW_STDIN_BUF_SIZE 4096
+
 /* This is the raw_stdin class. */
 struct raw_stdin {
   int fd;
+
+  /* The console settings.  raw_mode is true if we changed them (and need to
+   * put them back). */
+  bool           raw_mode;
   struct termios org;
   struct termios new;
+
+  /* The characters that have been read from fd but haven't been returned yet
+   * are buf[head] through buf[head + len - 1].  The buffer is only refilled
+   * when it's empty, so head goes back to 0 on every refill. */
+  char   buf[RAW_STDIN_BUF_SIZE];
+  size_t head;
+  size_t len;
+
+  /* True after read() reports end of file (or an error). */
+  bool eof;
+
+  /* The number of read() calls.  The test and bench code check it. */
+  uint64_t num_reads;
 };
 
 /******************************************************************************
  ******************************** PRIVATE API *********************************
  *****************************************************************************/
 
+/* Refill the input buffer.  It must be empty.  We read everything that's
+ * ready, up to the size of the buffer.
+ *
+ * Input:
+ *   this    = A pointer to the raw_stdin object.
+ *
+ *   timeout = The number of milliseconds to wait for input.  0 = don't wait.
+ *             -1 = wait forever.
+ *
+ * Output:
+ *   true  = success.  The buffer contains at least 1 character.
+ *   false = failure.  No input was ready, or we're at the end of the input.
+ */
+static bool
+raw_stdin_fill(raw_stdin *this,
+               int        timeout)
+{
+  bool retcode = false;
+
+  if(this->eof == false)
+  {
+    /* poll() says there's data (or end of file), so read() won't block.  It
+     * returns what's ready, not the size of the buffer. */
+    struct pollfd pfd = { .fd = this->fd, .events = POLLIN };
+    int rc;
+    while(((rc = poll(&pfd, 1, timeout)) == -1) && (errno == EINTR));
+
+    if(rc > 0)
+    {
+      ssize_t n = read(this->fd, this->buf, sizeof(this->buf));
+      this->num_reads++;
+      if(n > 0)
+      {
+        this->head = 0;
+        this->len  = (size_t) n;
+        retcode    = true;
+      }
+      else
+      {
+        this->eof = true;
+      }
+    }
+  }
+
+  return retcode;
+}
+
+/* Create a raw_stdin object that reads from the specified file descriptor.
+ *
+ * Input:
+ *   fd       = The file descriptor to read from.  The object owns it, and
+ *              closes it when the object is deleted.
+ *
+ *   raw_mode = true to put the console into raw mode.
+ *
+ * Output:
+ *   Returns a pointer to the object.
+ *   Returns 0 if unable to create the object.  fd is closed.
+ */
+static raw_stdin *
+raw_stdin_create(int  fd,
+                 bool raw_mode)
+{
+  raw_stdin *this = (fd >= 0) ? malloc(sizeof(*this)) : (raw_stdin *) 0;
+
+  if(this != (raw_stdin *) 0)
+  {
+    this->fd        = fd;
+    this->raw_mode  = raw_mode;
+    this->head      = 0;
+    this->len       = 0;
+    this->eof       = false;
+    this->num_reads = 0;
+
+    /* Put stdin into raw mode so we can read keyboard input in realtime. */
+    if(raw_mode == true)
+    {
+      tcgetattr(STDIN_FILENO, &this->org);
+      this->new = this->org;
+      this->new.c_lflag &= ~(ICANON | ECHO);
+      tcsetattr(STDIN_FILENO, TCSANOW, &this->new);
+    }
+  }
+  else if(fd >= 0)
+  {
+    close(fd);
+  }
+
+  return this;
+}
+
 /******************************************************************************
  ********************************* PUBLIC API *********************************
  *****************************************************************************/
@@ -44,23 +166,24 @@ struct raw_stdin {
 raw_stdin *
 raw_stdin_new(void)
 {
-  raw_stdin *this = malloc(sizeof(*this));
-
-  if(this != (raw_stdin *) 0)
-  {
-    /* Put stdin into raw mode so we can read keyboard input in realtime. */
-    tcgetattr(STDIN_FILENO, &this->org);
-    this->new = this->org;
-    this->new.c_lflag &= ~(ICANON | ECHO);
-    tcsetattr(STDIN_FILENO, TCSANOW, &this->new);
-    if((this->fd = open("/dev/stdin", O_RDONLY)) == -1)
-    {
-      raw_stdin_delete(this);
-      this = (raw_stdin *) 0;
-    }
-  }
+  return raw_stdin_create(open("/dev/stdin", O_RDONLY), true);
+}
 
-  return this;
+/* Create a new raw_stdin object that reads from a file descriptor (i.e. a pipe)
+ * instead of the console.  The console settings aren't touched.
+ *
+ * Input:
+ *   fd = The file descriptor to read from.  The object owns it, and closes it
+ *        when the object is deleted.
+ *
+ * Output:
+ *   Returns a pointer to the object.
+ *   Returns 0 if unable to create the object.  fd is closed.
+ */
+raw_stdin *
+raw_stdin_new_fd(int fd)
+{
+  return raw_stdin_create(fd, false);
 }
 
 /* Delete a console object that was created by raw_stdin_new().
@@ -84,7 +207,10 @@ raw_stdin_delete(raw_stdin *this)
       close(this->fd);
     }
 
-    tcsetattr(STDIN_FILENO, TCSANOW, &this->org);
+    if(this->raw_mode == true)
+    {
+      tcsetattr(STDIN_FILENO, TCSANOW, &this->org);
+    }
 
     free(this);
     retcode = true;
@@ -93,7 +219,8 @@ raw_stdin_delete(raw_stdin *this)
   return retcode;
 }
 
-/* Get a single character from the console.
+/* Get a single character from the console.  Wait for one if there isn't one
+ * ready.
  *
  * Input:
  *   this = A pointer to the raw_stdin object.
@@ -106,7 +233,7 @@ raw_stdin_delete(raw_stdin *this)
  */
 bool
 raw_stdin_getchar(raw_stdin *this,
-                  char *c)
+                  char      *c)
 {
   bool retcode = false;
 
@@ -118,7 +245,51 @@ raw_stdin_getchar(raw_stdin *this,
     /* Read the data. */
     if(this != (raw_stdin *) 0)
     {
-      retcode = (read(this->fd, c, 1) == 1);
+      if((this->len > 0) || (raw_stdin_fill(this, -1) == true))
+      {
+        *c = this->buf[this->head++];
+        this->len--;
+        retcode = true;
+      }
+    }
+  }
+
+  return retcode;
+}
+
+/* Get a single character from the console, but only if one is ready right
+ * now.  This never waits.  A caller that has just received a character can
+ * use it to process the rest of a burst of input (i.e. a paste) before it
+ * updates the display.
+ *
+ * Input:
+ *   this = A pointer to the raw_stdin object.
+ *
+ *   c    = A pointer to the location to store the character in.
+ *
+ * Output:
+ *   true  = success.  *c contains the character.
+ *   false = No character is ready (or failure).  *c contains a NULL (if it is
+ *           a valid pointer).
+ */
+bool
+raw_stdin_getchar_nowait(raw_stdin *this,
+                         char      *c)
+{
+  bool retcode = false;
+
+  if(c != (char *) 0)
+  {
+    *c = 0;
+
+    if(this != (raw_stdin *) 0)
+    {
+      if((this->len > 0) || (raw_stdin_fill(this, 0) == true))
+      {
+        *c = this->buf[this->head++];
+        this->len--;
+        retcode = true;
+      }
     }
   }
 
@@ -133,9 +304,214 @@ raw_stdin_getchar(raw_stdin *this,
 bool
 raw_stdin_test(void)
 {
-  bool retcode = true;
+  bool retcode = false;
+
+  raw_stdin *this = (raw_stdin *) 0;
+  int fds[2] = { -1, -1 };
+  char c;
+
+  do
+  {
+    /* Bad parameters. */
+    if(raw_stdin_getchar((raw_stdin *) 0, &c) != false)                       { break; }
+    if(raw_stdin_getchar_nowait((raw_stdin *) 0, &c) != false)                { break; }
+    if(raw_stdin_new_fd(-1) != (raw_stdin *) 0)                               { break; }
+
+    if(pipe(fds) != 0)                                                        { break; }
+    if((this = raw_stdin_new_fd(fds[0])) == (raw_stdin *) 0)                  { break; }
+    fds[0] = -1;
+
+    /* Nothing has been typed yet. */
+    if(raw_stdin_getchar_nowait(this, &c) != false)                           { break; }
+    if(raw_stdin_getchar(this, (char *) 0) != false)                          { break; }
+
+    /* A paste that's bigger than the buffer comes through intact, one buffer
+     * per read(). */
+    char paste[(RAW_STDIN_BUF_SIZE * 2) + 100];
+    size_t x;
+    for(x = 0; x < sizeof(paste); x++)
+    {
+      paste[x] = "0123456789+-*/()"[x % 16];
+    }
+    if(write(fds[1], paste, sizeof(paste)) != sizeof(paste))                  { break; }
+    this->num_reads = 0;
+    if(raw_stdin_getchar(this, &c) != true)                                   { break; }
+    if(c != paste[0])                                                         { break; }
+    for(x = 1; (x < sizeof(paste)) && (raw_stdin_getchar_nowait(this, &c) == true) && (c == paste[x]); x++);
+    if(x != sizeof(paste))                                                    { break; }
+    printf("  %zu characters, %llu reads.\n", sizeof(paste), (unsigned long long) this->num_reads);
+    if(this->num_reads != ((sizeof(paste) + RAW_STDIN_BUF_SIZE - 1) / RAW_STDIN_BUF_SIZE)) { break; }
+
+    /* The burst is over. */
+    if(raw_stdin_getchar_nowait(this, &c) != false)                           { break; }
+    if(c != 0)                                                                { break; }
+
+    /* End of file. */
+    if(write(fds[1], "=", 1) != 1)                                            { break; }
+    close(fds[1]);
+    fds[1] = -1;
+    if((raw_stdin_getchar(this, &c) != true) || (c != '='))                   { break; }
+    if(raw_stdin_getchar(this, &c) != false)                                  { break; }
+    if(raw_stdin_getchar_nowait(this, &c) != false)                           { break; }
+
+    retcode = true;
+  } while(0);
+
+  raw_stdin_delete(this);
+  if(fds[0] >= 0)
+  {
+    close(fds[0]);
+  }
+  if(fds[1] >= 0)
+  {
+    close(fds[1]);
+  }
 
   return retcode;
 }
 #endif // TEST
 
+/******************************************************************************
+ ********************************* BENCH API **********************************
+ *****************************************************************************/
+
+#if defined(BENCH)
+
+/* Redraw the display the way ui() does: get the console from the calculator,
+ * and write one line to an unbuffered device.
+ *
+ * Input:
+ *   calc = A pointer to the calculator object.
+ *
+ *   fd   = The file descriptor to write the display to.
+ *
+ * Output:
+ *   N/A.
+ */
+static void
+raw_stdin_bench_redraw(calculator *calc,
+                       int         fd)
+{
+  char console[32];
+  char line[sizeof(console) + 64];
+
+  calculator_get_console(calc, console, sizeof(console));
+  int len = snprintf(line, sizeof(line), "\r-- dec -->%31s<--\b\b\b\b", console);
+  if(write(fd, line, len) != len)
+  {
+    fprintf(stderr, "%s(): write() failed.\n", __func__);
+  }
+}
+
+/* Paste an equation into the calculator through a pipe, and measure how long
+ * it takes until the display shows it.  The old way is one read() and one
+ * redraw per character.  The buffered way is one read() per buffer and one
+ * redraw per burst.
+ */
+bool
+raw_stdin_bench(void)
+{
+  bool retcode = false;
+
+  const size_t sizes[] = { 1024, 10240, 51200 };
+  const int    loops   = 20;
+
+  int   dsp   = open("/dev/null", O_WRONLY);
+  char *paste = malloc(sizes[(sizeof(sizes) / sizeof(sizes[0])) - 1]);
+
+  do
+  {
+    if((dsp < 0) || (paste == (char *) 0)) { break; }
+
+    size_t s;
+    for(s = 0; s < (sizeof(sizes) / sizeof(sizes[0])); s++)
+    {
+      /* "12.5+12.5+...".  A pipe holds 64KB, so the whole paste is written
+       * before the reader starts, just like a terminal paste. */
+      size_t size = sizes[s];
+      size_t x;
+      for(x = 0; x < size; x++)
+      {
+        paste[x] = "12.5+"[x % 5];
+      }
+
+      int mode;
+      for(mode = 0; mode < 2; mode++)
+      {
+        bench_timer timer;
+        double      elapsed = 0.0;
+        uint64_t    reads   = 0;
+        uint64_t    redraws = 0;
+        int         loop;
+        for(loop = 0; loop < loops; loop++)
+        {
+          int fds[2];
+          if(pipe(fds) != 0)                                                  { break; }
+          calculator *calc = calculator_new();
+          raw_stdin  *in   = (mode == 1) ? raw_stdin_new_fd(fds[0]) : (raw_stdin *) 0;
+          bool        ok   = ((calc != (calculator *) 0) && ((mode == 0) || (in != (raw_stdin *) 0))) ? true : false;
+          ok = (ok == true) && (write(fds[1], paste, size) == size);
+
+          bench_timer_start(&timer);
+          size_t got = 0;
+          char   c;
+          if(mode == 0)
+          {
+            /* The old way. */
+            for(; (ok == true) && (got < size) && (read(fds[0], &c, 1) == 1); got++, reads++, redraws++)
+            {
+              calculator_add_char(calc, c);
+              raw_stdin_bench_redraw(calc, dsp);
+            }
+          }
+          else
+          {
+            /* The buffered way.  Wait for the first character, process the
+             * rest of the burst, and then redraw. */
+            while((ok == true) && (got < size) && (raw_stdin_getchar(in, &c) == true))
+            {
+              do
+              {
+                calculator_add_char(calc, c);
+                got++;
+              } while(raw_stdin_getchar_nowait(in, &c) == true);
+              raw_stdin_bench_redraw(calc, dsp);
+              redraws++;
+            }
+            reads += (in != (raw_stdin *) 0) ? in->num_reads : 0;
+          }
+          elapsed += bench_timer_elapsed(&timer);
+
+          raw_stdin_delete(in);
+          calculator_delete(calc);
+          if(mode == 0)
+          {
+            close(fds[0]);
+          }
+          close(fds[1]);
+          if(got != size)                                                     { break; }
+        }
+        if(loop != loops)                                                     { break; }
+
+        char name[64];
+        snprintf(name, sizeof(name), "%zuKB paste, %s", (size / 1024), (mode == 0) ? "read 1 char" : "buffered");
+        printf("  %-40s %14.3f ms/paste (%llu reads, %llu redraws).\n", name, ((elapsed * 1000.0) / loops),
+               (unsigned long long) (reads / loops), (unsigned long long) (redraws / loops));
+      }
+      if(mode != 2)                                                           { break; }
+    }
+    if(s != (sizeof(sizes) / sizeof(sizes[0])))                               { break; }
+
+    retcode = true;
+  } while(0);
+
+  free(paste);
+  if(dsp >= 0)
+  {
+    close(dsp);
+  }
+
+  return retcode;
+}
+
+#endif // BENCH
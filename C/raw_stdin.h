@@ -1,6 +1,7 @@
 /* A simple class that configures the console device as a raw device so the
  * program can read keyboard input one character at a time as it is being
- * entered by the user.
+ * entered by the user.  Input is buffered, so a burst of characters (i.e. a
+ * paste) only costs a few reads.
  */
 #ifndef __RAW_STDIN_H__
 #define __RAW_STDIN_H__
@@ -13,10 +14,14 @@ typedef struct raw_stdin raw_stdin;
 
 raw_stdin *raw_stdin_new(void);
 
+raw_stdin *raw_stdin_new_fd(int fd);
+
 bool raw_stdin_delete(raw_stdin *this);
 
 bool raw_stdin_getchar(raw_stdin *this, char *c);
 
+bool raw_stdin_getchar_nowait(raw_stdin *this, char *c);
+
 /********************************** TEST API **********************************/
 
 #if defined(TEST)
@@ -25,5 +30,13 @@ bool raw_stdin_test(void);
 
 #endif // TEST
 
+/********************************* BENCH API **********************************/
+
+#if defined(BENCH)
+
+bool raw_stdin_bench(void);
+
+#endif // BENCH
+
 #endif // __RAW_STDIN_H__
 
@@ -0,0 +1,1123 @@
+/* This is the server mode for the calculator.  It listens on a Unix domain
+ * socket (and/or a loopback TCP port), and evaluates newline-delimited
+ * equations for its clients.  A client can send as many equations as it
+ * likes without waiting for the results (pipelining).  The results come back
+ * one per line, in the same order.
+ *
+ * It's a single thread with an epoll event loop.  All of the sockets are
+ * non-blocking.  Each connection has its own calculator object and its own
+ * input and output buffers.  Everything that arrives in one read() is
+ * evaluated, and the results go out in one write().  If a client stops
+ * reading its results, we stop reading its equations until it catches up.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "common.h"
+
+#include "bench.h"
+#include "calculator.h"
+#include "server.h"
+
+/* The starting size of each connection's input and output buffers.  They
+ * grow as needed. */
+#define SERVER_BUF_SIZE (4 * 1024)
+
+/* The longest equation that we accept.  A client that sends a longer line is
+ * disconnected. */
+#define SERVER_MAX_LINE (1024 * 1024)
+
+/* The most events that we handle per epoll_wait(). */
+#define SERVER_MAX_EVENTS 64
+
+/* This is what we send for an equation that can't be evaluated. */
+#define SERVER_ERROR_STR "Error"
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ *****************************************************************************/
+
+/* A client connection. */
+typedef struct server_conn {
+  int                 fd;
+  calculator         *calc;
+
+  /* The input buffer.  in_buf[0 - (in_len - 1)] has been read but not
+   * evaluated yet.  It always starts at the beginning of a line. */
+  char               *in_buf;
+  size_t              in_size;
+  size_t              in_len;
+
+  /* The output buffer.  out_buf[out_off - (out_len - 1)] hasn't been sent
+   * yet. */
+  char               *out_buf;
+  size_t              out_size;
+  size_t              out_len;
+  size_t              out_off;
+
+  /* The events that the connection is registered for, and whether the client
+   * has closed its end (we close ours once the results are sent). */
+  uint32_t            events;
+  bool                closing;
+
+  /* All of the connections are on a list, so they can be cleaned up. */
+  struct server_conn *prev;
+  struct server_conn *next;
+} server_conn;
+
+/* This is the server class. */
+struct server {
+  int          epoll_fd;
+
+  /* The listening sockets.  -1 if not used. */
+  int          unix_fd;
+  int          tcp_fd;
+  char        *unix_path;
+  int          tcp_port;
+
+  /* server_stop() writes to this to wake up server_run(). */
+  int          stop_fd;
+
+  server_conn *conns;
+  size_t       num_conns;
+  uint64_t     num_requests;
+};
+
+/******************************************************************************
+ ******************************** PRIVATE API *********************************
+ *****************************************************************************/
+
+/* Register a file descriptor with the event loop, or change its events.
+ *
+ * Input:
+ *   this   = A pointer to the server object.
+ *
+ *   op     = EPOLL_CTL_ADD or EPOLL_CTL_MOD.
+ *
+ *   fd     = The file descriptor.
+ *
+ *   events = The events to wait for.
+ *
+ *   ptr    = The pointer that epoll_wait() gives back for this fd.
+ *
+ * Output:
+ *   true  = success.
+ *   false = failure.
+ */
+static bool
+server_epoll_ctl(server   *this,
+                 int       op,
+                 int       fd,
+                 uint32_t  events,
+                 void     *ptr)
+{
+  struct epoll_event ev = { .events = events, .data.ptr = ptr };
+
+  return (epoll_ctl(this->epoll_fd, op, fd, &ev) == 0) ? true : false;
+}
+
+/* Close a connection, and free everything that it owns.
+ *
+ * Input:
+ *   this = A pointer to the server object.
+ *
+ *   conn = A pointer to the connection.
+ *
+ * Output:
+ *   N/A.
+ */
+static void
+server_conn_delete(server      *this,
+                   server_conn *conn)
+{
+  if(conn->prev != (server_conn *) 0) { conn->prev->next = conn->next; }
+  else                                { this->conns      = conn->next; }
+  if(conn->next != (server_conn *) 0) { conn->next->prev = conn->prev; }
+  this->num_conns--;
+
+  /* Closing the socket only removes it from the epoll set if no other process
+   * has a copy of it, so remove it first. */
+  epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, conn->fd, (struct epoll_event *) 0);
+  close(conn->fd);
+  calculator_delete(conn->calc);
+  free(conn->in_buf);
+  free(conn->out_buf);
+  free(conn);
+}
+
+/* Accept all of the connections that are waiting on a listening socket.
+ *
+ * Input:
+ *   this      = A pointer to the server object.
+ *
+ *   listen_fd = The listening socket.
+ *
+ * Output:
+ *   N/A.  A connection that we can't allocate memory for is closed.
+ */
+static void
+server_accept(server *this,
+              int     listen_fd)
+{
+  int fd;
+  while((fd = accept(listen_fd, (struct sockaddr *) 0, (socklen_t *) 0)) >= 0)
+  {
+    server_conn *conn = malloc(sizeof(*conn));
+    if((conn == (server_conn *) 0)                ||
+       (fcntl(fd, F_SETFL, O_NONBLOCK) != 0)     ||
+       (fcntl(fd, F_SETFD, FD_CLOEXEC) != 0))
+    {
+      free(conn);
+      close(fd);
+      continue;
+    }
+    memset(conn, 0, sizeof(*conn));
+    conn->fd       = fd;
+    conn->calc     = calculator_new();
+    conn->in_size  = SERVER_BUF_SIZE;
+    conn->in_buf   = malloc(conn->in_size);
+    conn->out_size = SERVER_BUF_SIZE;
+    conn->out_buf  = malloc(conn->out_size);
+    conn->events   = EPOLLIN;
+
+    conn->next = this->conns;
+    if(this->conns != (server_conn *) 0)
+    {
+      this->conns->prev = conn;
+    }
+    this->conns = conn;
+    this->num_conns++;
+
+    if((conn->calc    == (calculator *) 0) ||
+       (conn->in_buf  == (char *) 0)       ||
+       (conn->out_buf == (char *) 0)       ||
+       (server_epoll_ctl(this, EPOLL_CTL_ADD, fd, conn->events, conn) == false))
+    {
+      server_conn_delete(this, conn);
+    }
+  }
+}
+
+/* Add a result to a connection's output buffer.  The newline is added here.
+ *
+ * Input:
+ *   conn = A pointer to the connection.
+ *
+ *   str  = The result.
+ *
+ *   len  = The length of str.
+ *
+ * Output:
+ *   true  = success.
+ *   false = failure.  Unable to allocate memory.
+ */
+static bool
+server_conn_put(server_conn *conn,
+                const char  *str,
+                size_t       len)
+{
+  bool retcode = true;
+
+  if((conn->out_len + len + 1) > conn->out_size)
+  {
+    size_t new_size = conn->out_size * 2;
+    while((conn->out_len + len + 1) > new_size)
+    {
+      new_size *= 2;
+    }
+    char *p = realloc(conn->out_buf, new_size);
+    if(p != (char *) 0)
+    {
+      conn->out_buf  = p;
+      conn->out_size = new_size;
+    }
+    else
+    {
+      retcode = false;
+    }
+  }
+
+  if(retcode == true)
+  {
+    memcpy(&conn->out_buf[conn->out_len], str, len);
+    conn->out_len += len;
+    conn->out_buf[conn->out_len++] = '\n';
+  }
+
+  return retcode;
+}
+
+/* Evaluate one equation, and queue the result.
+ *
+ * Input:
+ *   this = A pointer to the server object.
+ *
+ *   conn = A pointer to the connection.
+ *
+ *   line = The equation.  It's NULL terminated (the newline has been removed).
+ *
+ * Output:
+ *   true  = success.
+ *   false = failure.  Unable to allocate memory.
+ */
+static bool
+server_conn_eval(server      *this,
+                 server_conn *conn,
+                 char        *line)
+{
+  char result[1024];
+
+  if(calculator_eval_str(conn->calc, line, result, sizeof(result)) == false)
+  {
+    strcpy(result, SERVER_ERROR_STR);
+  }
+  this->num_requests++;
+
+  return server_conn_put(conn, result, strlen(result));
+}
+
+/* Evaluate all of the complete lines in a connection's input buffer.  A
+ * partial line is moved to the front of the buffer.
+ *
+ * Input:
+ *   this = A pointer to the server object.
+ *
+ *   conn = A pointer to the connection.
+ *
+ * Output:
+ *   true  = success.
+ *   false = failure.  Unable to allocate memory.
+ */
+static bool
+server_conn_eval_lines(server      *this,
+                       server_conn *conn)
+{
+  bool retcode = true;
+
+  char *start = conn->in_buf;
+  char *end   = conn->in_buf + conn->in_len;
+  char *nl;
+  while((retcode == true) && ((nl = memchr(start, '\n', (end - start))) != (char *) 0))
+  {
+    /* Accept DOS line endings too. */
+    *nl = 0;
+    if((nl > start) && (nl[-1] == '\r'))
+    {
+      nl[-1] = 0;
+    }
+
+    retcode = server_conn_eval(this, conn, start);
+    start = nl + 1;
+  }
+
+  conn->in_len = (end - start);
+  memmove(conn->in_buf, start, conn->in_len);
+
+  return retcode;
+}
+
+/* Send as much of a connection's output as the socket will take.  If it's all
+ * sent, we go back to reading equations.  If not, we stop reading and wait
+ * until the socket is writable.
+ *
+ * Input:
+ *   this = A pointer to the server object.
+ *
+ *   conn = A pointer to the connection.
+ *
+ * Output:
+ *   true  = success.
+ *   false = failure.  The connection is broken.  Close it.
+ */
+static bool
+server_conn_write(server      *this,
+                  server_conn *conn)
+{
+  bool retcode = true;
+
+  while((retcode == true) && (conn->out_off < conn->out_len))
+  {
+    ssize_t n = send(conn->fd, &conn->out_buf[conn->out_off], (conn->out_len - conn->out_off), MSG_NOSIGNAL);
+    if(n > 0)
+    {
+      conn->out_off += n;
+    }
+    else if((n < 0) && (errno == EINTR))
+    {
+      continue;
+    }
+    else if((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+    {
+      break;
+    }
+    else
+    {
+      retcode = false;
+    }
+  }
+
+  if(retcode == true)
+  {
+    uint32_t events = EPOLLOUT;
+    if(conn->out_off == conn->out_len)
+    {
+      conn->out_off = conn->out_len = 0;
+      events = (conn->closing == true) ? 0 : EPOLLIN;
+      retcode = (conn->closing == true) ? false : true;
+    }
+    if((retcode == true) && (events != conn->events))
+    {
+      conn->events = events;
+      retcode = server_epoll_ctl(this, EPOLL_CTL_MOD, conn->fd, events, conn);
+    }
+  }
+
+  return retcode;
+}
+
+/* Read from a connection, and evaluate the equations that are complete.
+ *
+ * Input:
+ *   this = A pointer to the server object.
+ *
+ *   conn = A pointer to the connection.
+ *
+ * Output:
+ *   true  = success.
+ *   false = failure.  The connection is done (or broken).  Close it.
+ */
+static bool
+server_conn_read(server      *this,
+                 server_conn *conn)
+{
+  bool retcode = true;
+
+  /* The buffer is full of a single line.  Make it bigger. */
+  if((conn->in_len + 1) >= conn->in_size)
+  {
+    char *p = (conn->in_size < SERVER_MAX_LINE) ? realloc(conn->in_buf, (conn->in_size * 2)) : (char *) 0;
+    if(p == (char *) 0)
+    {
+      return false;
+    }
+    conn->in_buf   = p;
+    conn->in_size *= 2;
+  }
+
+  /* Leave room for a NULL terminator on a final line without a newline. */
+  ssize_t n = recv(conn->fd, &conn->in_buf[conn->in_len], (conn->in_size - conn->in_len - 1), 0);
+  if(n > 0)
+  {
+    conn->in_len += n;
+    retcode = server_conn_eval_lines(this, conn);
+  }
+  else if((n == 0) || ((errno != EINTR) && (errno != EAGAIN) && (errno != EWOULDBLOCK)))
+  {
+    /* The client is done sending.  The last line doesn't need a newline. */
+    if((n == 0) && (conn->in_len > 0))
+    {
+      conn->in_buf[conn->in_len] = 0;
+      conn->in_len = 0;
+      retcode = server_conn_eval(this, conn, conn->in_buf);
+    }
+    conn->closing = true;
+    retcode = (n == 0) ? retcode : false;
+  }
+
+  if(retcode == true)
+  {
+    retcode = server_conn_write(this, conn);
+  }
+
+  return retcode;
+}
+
+/* Create a listening socket.
+ *
+ * Input:
+ *   this   = A pointer to the server object.
+ *
+ *   domain = AF_UNIX or AF_INET.
+ *
+ *   addr   = The address to bind to.
+ *
+ *   len    = The size of addr.
+ *
+ * Output:
+ *   Returns the socket.
+ *   Returns -1 if unable to create it.
+ */
+static int
+server_listen(server                *this,
+              int                    domain,
+              const struct sockaddr *addr,
+              socklen_t              len)
+{
+  int fd  = socket(domain, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  int one = 1;
+
+  if((fd >= 0) &&
+     (((domain == AF_INET) && (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0)) ||
+      (bind(fd, addr, len) != 0) ||
+      (listen(fd, SOMAXCONN) != 0)))
+  {
+    close(fd);
+    fd = -1;
+  }
+
+  return fd;
+}
+
+/******************************************************************************
+ ********************************* PUBLIC API *********************************
+ *****************************************************************************/
+
+/* Create a new server object.  The sockets are created and bound here, so
+ * clients can connect as soon as this returns (they're served once
+ * server_run() is called).
+ *
+ * Input:
+ *   unix_path = The path of the Unix domain socket to listen on.  0 = don't
+ *               listen on a Unix domain socket.  If there's already a socket
+ *               at that path, it's replaced.
+ *
+ *   tcp_port  = The TCP port to listen on.  Only the loopback interface is
+ *               used.  0 = pick any free port (refer to
+ *               server_get_tcp_port()).  -1 = don't listen on TCP.
+ *
+ * Output:
+ *   Returns a pointer to the object.
+ *   Returns 0 if unable to create the object (or if there's nothing to
+ *   listen on).
+ */
+server *
+server_new(const char *unix_path,
+           int         tcp_port)
+{
+  server *this = malloc(sizeof(*this));
+  bool    ok   = false;
+
+  do
+  {
+    if(this == (server *) 0)                                               { break; }
+    memset(this, 0, sizeof(*this));
+    this->unix_fd = this->tcp_fd = this->stop_fd = this->epoll_fd = -1;
+    this->tcp_port = -1;
+
+    if((unix_path == (const char *) 0) && (tcp_port < 0))                  { break; }
+    if((this->epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0)                { break; }
+    if((this->stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0)       { break; }
+    if(server_epoll_ctl(this, EPOLL_CTL_ADD, this->stop_fd, EPOLLIN, &this->stop_fd) == false) { break; }
+
+    if(unix_path != (const char *) 0)
+    {
+      struct sockaddr_un addr = { .sun_family = AF_UNIX };
+      if(strlen(unix_path) >= sizeof(addr.sun_path))                       { break; }
+      strcpy(addr.sun_path, unix_path);
+
+      /* Replace a stale socket, but nothing else. */
+      struct stat st;
+      if((lstat(unix_path, &st) == 0) && (S_ISSOCK(st.st_mode)))
+      {
+        unlink(unix_path);
+      }
+
+      if((this->unix_fd = server_listen(this, AF_UNIX, (struct sockaddr *) &addr, sizeof(addr))) < 0) { break; }
+      if((this->unix_path = strdup(unix_path)) == (char *) 0)              { break; }
+      if(server_epoll_ctl(this, EPOLL_CTL_ADD, this->unix_fd, EPOLLIN, &this->unix_fd) == false) { break; }
+    }
+
+    if(tcp_port >= 0)
+    {
+      struct sockaddr_in addr = { .sin_family = AF_INET };
+      addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      addr.sin_port        = htons((uint16_t) tcp_port);
+      socklen_t len        = sizeof(addr);
+
+      if(tcp_port > UINT16_MAX)                                            { break; }
+      if((this->tcp_fd = server_listen(this, AF_INET, (struct sockaddr *) &addr, sizeof(addr))) < 0) { break; }
+      if(getsockname(this->tcp_fd, (struct sockaddr *) &addr, &len) != 0) { break; }
+      this->tcp_port = ntohs(addr.sin_port);
+      if(server_epoll_ctl(this, EPOLL_CTL_ADD, this->tcp_fd, EPOLLIN, &this->tcp_fd) == false) { break; }
+    }
+
+    ok = true;
+  } while(0);
+
+  if((ok == false) && (this != (server *) 0))
+  {
+    server_delete(this);
+    this = (server *) 0;
+  }
+
+  return this;
+}
+
+/* Delete a server object that was created by server_new().  All of the
+ * connections are closed, and the Unix domain socket is removed.
+ *
+ * Input:
+ *   this = A pointer to the server object.
+ *
+ * Output:
+ *   true  = success.  this is deleted.
+ *   false = failure.  this is undefined.
+ */
+bool
+server_delete(server *this)
+{
+  bool retcode = false;
+
+  if(this != (server *) 0)
+  {
+    while(this->conns != (server_conn *) 0)
+    {
+      server_conn_delete(this, this->conns);
+    }
+
+    if(this->unix_fd >= 0)
+    {
+      close(this->unix_fd);
+      unlink(this->unix_path);
+    }
+    if(this->tcp_fd >= 0)
+    {
+      close(this->tcp_fd);
+    }
+    if(this->stop_fd >= 0)
+    {
+      close(this->stop_fd);
+    }
+    if(this->epoll_fd >= 0)
+    {
+      close(this->epoll_fd);
+    }
+
+    free(this->unix_path);
+    free(this);
+    retcode = true;
+  }
+
+  return retcode;
+}
+
+/* Run the event loop.  Accept connections, and evaluate the equations that
+ * the clients send.  This doesn't return until server_stop() is called.
+ *
+ * Input:
+ *   this = A pointer to the server object.
+ *
+ * Output:
+ *   true  = success.  server_stop() was called.
+ *   false = failure.  The event loop failed.
+ */
+bool
+server_run(server *this)
+{
+  bool retcode = false;
+
+  if(this != (server *) 0)
+  {
+    bool keep_going = true;
+    while(keep_going == true)
+    {
+      struct epoll_event events[SERVER_MAX_EVENTS];
+      int num_events = epoll_wait(this->epoll_fd, events, SERVER_MAX_EVENTS, -1);
+      if(num_events < 0)
+      {
+        keep_going = (errno == EINTR) ? true : false;
+        continue;
+      }
+
+      int i;
+      for(i = 0; i < num_events; i++)
+      {
+        void *ptr = events[i].data.ptr;
+
+        if(ptr == &this->stop_fd)
+        {
+          keep_going = false;
+          retcode    = true;
+        }
+        else if(ptr == &this->unix_fd)
+        {
+          server_accept(this, this->unix_fd);
+        }
+        else if(ptr == &this->tcp_fd)
+        {
+          server_accept(this, this->tcp_fd);
+        }
+        else
+        {
+          /* A connection is readable, writable, or broken. */
+          server_conn *conn = ptr;
+          bool ok = true;
+          if(events[i].events & EPOLLOUT)
+          {
+            ok = server_conn_write(this, conn);
+          }
+          else if(events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+          {
+            ok = server_conn_read(this, conn);
+          }
+          if(ok == false)
+          {
+            server_conn_delete(this, conn);
+          }
+        }
+      }
+    }
+  }
+
+  return retcode;
+}
+
+/* Tell server_run() to return.  This is safe to call from a signal handler or
+ * from another thread.
+ *
+ * Input:
+ *   this = A pointer to the server object.
+ *
+ * Output:
+ *   true  = success.  server_run() will return.
+ *   false = failure.
+ */
+bool
+server_stop(server *this)
+{
+  bool retcode = false;
+
+  if(this != (server *) 0)
+  {
+    uint64_t one = 1;
+    retcode = (write(this->stop_fd, &one, sizeof(one)) == sizeof(one)) ? true : false;
+  }
+
+  return retcode;
+}
+
+/* Get the TCP port that the server is listening on.  This is how a caller
+ * that asked for port 0 finds out which port it got.
+ *
+ * Input:
+ *   this = A pointer to the server object.
+ *
+ *   port = A pointer to a variable that is set to the port.
+ *
+ * Output:
+ *   true  = success.  *port = the port.
+ *   false = failure.  The server isn't listening on TCP.
+ */
+bool
+server_get_tcp_port(server *this,
+                    int    *port)
+{
+  bool retcode = false;
+
+  if((this != (server *) 0) && (port != (int *) 0) && (this->tcp_fd >= 0))
+  {
+    *port   = this->tcp_port;
+    retcode = true;
+  }
+
+  return retcode;
+}
+
+/******************************************************************************
+ ****************************** TEST/BENCH CLIENT *****************************
+ *****************************************************************************/
+
+#if defined(TEST) || defined(BENCH)
+
+/* The entrypoint for the thread that runs the server during the test and the
+ * bench.
+ *
+ * Input:
+ *   arg = A pointer to the server object.
+ *
+ * Output:
+ *   Returns 0.
+ */
+static void *
+server_thread(void *arg)
+{
+  server_run((server *) arg);
+
+  return (void *) 0;
+}
+
+/* Connect to the server.
+ *
+ * Input:
+ *   unix_path = The path of the Unix domain socket.  0 = use TCP.
+ *
+ *   tcp_port  = The loopback TCP port.
+ *
+ * Output:
+ *   Returns the socket.
+ *   Returns -1 if unable to connect.
+ */
+static int
+server_client_connect(const char *unix_path,
+                      int         tcp_port)
+{
+  int fd;
+
+  if(unix_path != (const char *) 0)
+  {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    strncpy(addr.sun_path, unix_path, sizeof(addr.sun_path) - 1);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if((fd >= 0) && (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0))
+    {
+      close(fd);
+      fd = -1;
+    }
+  }
+  else
+  {
+    struct sockaddr_in addr = { .sin_family = AF_INET };
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port        = htons((uint16_t) tcp_port);
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    if((fd >= 0) && (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0))
+    {
+      close(fd);
+      fd = -1;
+    }
+  }
+
+  return fd;
+}
+
+/* Read exactly the specified number of result lines from the server.
+ *
+ * Input:
+ *   fd        = The socket.
+ *
+ *   buf       = The buffer to read into.
+ *
+ *   buf_size  = The size of buf.
+ *
+ *   num_lines = The number of lines to read.
+ *
+ * Output:
+ *   Returns the number of bytes read.  buf is NULL terminated.
+ *   Returns 0 if the connection was closed before all of the lines arrived.
+ */
+static size_t
+server_client_read_lines(int     fd,
+                         char   *buf,
+                         size_t  buf_size,
+                         size_t  num_lines)
+{
+  size_t len = 0, lines = 0;
+
+  while(lines < num_lines)
+  {
+    ssize_t n = read(fd, &buf[len], (buf_size - len - 1));
+    if(n <= 0)
+    {
+      len = 0;
+      break;
+    }
+    size_t i;
+    for(i = len; i < (len + n); i++)
+    {
+      lines += (buf[i] == '\n') ? 1 : 0;
+    }
+    len += n;
+  }
+  buf[len] = 0;
+
+  return len;
+}
+
+#endif // TEST || BENCH
+
+/******************************************************************************
+ ********************************** TEST API **********************************
+ *****************************************************************************/
+
+#if defined(TEST)
+
+bool
+server_test(void)
+{
+  bool retcode = false;
+
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/calculator_test_%d.sock", (int) getpid());
+
+  server   *this = (server *) 0;
+  pthread_t thread;
+  bool      running = false;
+  int       fd = -1, fd2 = -1;
+  char      buf[64 * 1024];
+  int       port;
+
+  do
+  {
+    /* Bad parameters. */
+    if(server_new((const char *) 0, -1) != (server *) 0)                       { break; }
+    if(server_run((server *) 0) != false)                                      { break; }
+    if(server_stop((server *) 0) != false)                                     { break; }
+
+    if((this = server_new(path, 0)) == (server *) 0)                           { break; }
+    if(server_get_tcp_port(this, (int *) 0) != false)                          { break; }
+    if(server_get_tcp_port(this, &port) != true)                               { break; }
+    if(pthread_create(&thread, (pthread_attr_t *) 0, server_thread, this) != 0) { break; }
+    running = true;
+
+    /* An equation that arrives in pieces. */
+    printf("  Unix domain socket.\n");
+    if((fd = server_client_connect(path, 0)) < 0)                             { break; }
+    if(write(fd, "1+2\n2*", 6) != 6)                                           { break; }
+    if(write(fd, "3\n10/0\r\n\n", 9) != 9)                                     { break; }
+    if(server_client_read_lines(fd, buf, sizeof(buf), 4) == 0)                 { break; }
+    if(strcmp(buf, "3\n6\nError\n0\n") != 0)                                   { break; }
+
+    /* Lots of pipelined equations, and a second connection at the same time.
+     * The results come back in order. */
+    printf("  Pipelined equations.\n");
+    if((fd2 = server_client_connect((const char *) 0, port)) < 0)             { break; }
+    char  *p   = buf;
+    size_t num = 2000;
+    size_t x;
+    for(x = 0; x < num; x++)
+    {
+      p += sprintf(p, "%d+1\n", (int) (x % 100));
+    }
+    size_t len = (p - buf);
+    if(write(fd, buf, len) != len)                                             { break; }
+    if(write(fd2, "2*(3+4)\n", 8) != 8)                                        { break; }
+    if(server_client_read_lines(fd2, buf, sizeof(buf), 1) == 0)                { break; }
+    if(strcmp(buf, "14\n") != 0)                                               { break; }
+    if(server_client_read_lines(fd, buf, sizeof(buf), num) == 0)               { break; }
+    for(p = buf, x = 0; x < num; x++)
+    {
+      char expect[16];
+      int  n = sprintf(expect, "%d\n", (int) ((x % 100) + 1));
+      if(strncmp(p, expect, n) != 0)                                           { break; }
+      p += n;
+    }
+    if((x != num) || (*p != 0))                                                { break; }
+
+    /* A line that's longer than the input buffer. */
+    printf("  Long equation.\n");
+    for(p = buf, x = 0; x < 5000; x++)
+    {
+      p += sprintf(p, "1+");
+    }
+    p += sprintf(p, "1\n");
+    len = (p - buf);
+    if(write(fd2, buf, len) != len)                                            { break; }
+    if(server_client_read_lines(fd2, buf, sizeof(buf), 1) == 0)                { break; }
+    if(strcmp(buf, "5,001\n") != 0)                                           { break; }
+
+    /* The last line doesn't need a newline.  The server closes the
+     * connection after the client does. */
+    printf("  End of input.\n");
+    if(write(fd2, "5*5", 3) != 3)                                              { break; }
+    if(shutdown(fd2, SHUT_WR) != 0)                                            { break; }
+    if(server_client_read_lines(fd2, buf, sizeof(buf), 1) == 0)                { break; }
+    if(strcmp(buf, "25\n") != 0)                                               { break; }
+    if(read(fd2, buf, sizeof(buf)) != 0)                                       { break; }
+
+    retcode = true;
+  } while(0);
+
+  if(running == true)
+  {
+    server_stop(this);
+    pthread_join(thread, (void **) 0);
+  }
+  if(fd >= 0)
+  {
+    close(fd);
+  }
+  if(fd2 >= 0)
+  {
+    close(fd2);
+  }
+  server_delete(this);
+
+  /* The socket is removed with the server. */
+  if((retcode == true) && (access(path, F_OK) == 0))
+  {
+    retcode = false;
+  }
+
+  return retcode;
+}
+
+#endif // TEST
+
+/******************************************************************************
+ ********************************* BENCH API **********************************
+ *****************************************************************************/
+
+#if defined(BENCH)
+
+/* Sort latencies for qsort(). */
+static int
+server_bench_cmp(const void *a,
+                 const void *b)
+{
+  double x = *(const double *) a, y = *(const double *) b;
+
+  return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+/* Send equations to the server with a given number of them in flight, and
+ * report the requests per second and the latency percentiles.  This is the
+ * client harness.
+ *
+ * Input:
+ *   name      = An ASCII string that describes the run.
+ *
+ *   unix_path = The path of the Unix domain socket.  0 = use TCP.
+ *
+ *   tcp_port  = The loopback TCP port.
+ *
+ *   depth     = The number of equations to send before reading the results.
+ *
+ *   num       = The total number of equations.
+ *
+ * Output:
+ *   true  = success.
+ *   false = failure.
+ */
+static bool
+server_bench_run(const char *name,
+                 const char *unix_path,
+                 int         tcp_port,
+                 size_t      depth,
+                 size_t      num)
+{
+  bool retcode = false;
+
+  const char *eq     = "123456.789*987.654321-1000\n";
+  size_t      eq_len = strlen(eq);
+
+  int     fd      = server_client_connect(unix_path, tcp_port);
+  char   *out     = malloc(depth * eq_len);
+  char   *in      = malloc(64 * 1024);
+  double *latency = malloc((num / depth) * sizeof(*latency));
+
+  do
+  {
+    if((fd < 0) || (out == (char *) 0) || (in == (char *) 0) || (latency == (double *) 0)) { break; }
+
+    size_t x;
+    for(x = 0; x < depth; x++)
+    {
+      memcpy(&out[x * eq_len], eq, eq_len);
+    }
+
+    /* Each round trip sends depth equations and waits for all of the
+     * results.  The latency of a round trip is the latency of the slowest
+     * equation in it. */
+    bench_timer total, rtt;
+    size_t rounds = num / depth;
+    bench_timer_start(&total);
+    for(x = 0; x < rounds; x++)
+    {
+      bench_timer_start(&rtt);
+      if(write(fd, out, depth * eq_len) != (depth * eq_len))                   { break; }
+      if(server_client_read_lines(fd, in, 64 * 1024, depth) == 0)             { break; }
+      latency[x] = bench_timer_elapsed(&rtt);
+    }
+    if(x != rounds)                                                            { break; }
+    bench_report(name, &total, (uint64_t) rounds * depth, "requests");
+
+    qsort(latency, rounds, sizeof(*latency), server_bench_cmp);
+    printf("  %-40s %14.1f us p50, %.1f us p99.\n", name,
+           latency[rounds / 2] * 1000000.0, latency[(rounds * 99) / 100] * 1000000.0);
+
+    retcode = true;
+  } while(0);
+
+  if(fd >= 0)
+  {
+    close(fd);
+  }
+  free(out);
+  free(in);
+  free(latency);
+
+  return retcode;
+}
+
+bool
+server_bench(void)
+{
+  bool retcode = false;
+
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/calculator_bench_%d.sock", (int) getpid());
+
+  server   *this = server_new(path, 0);
+  pthread_t thread;
+  bool      running = false;
+  int       port;
+
+  do
+  {
+    if(this == (server *) 0)                                                   { break; }
+    if(server_get_tcp_port(this, &port) != true)                               { break; }
+    if(pthread_create(&thread, (pthread_attr_t *) 0, server_thread, this) != 0) { break; }
+    running = true;
+
+    if(server_bench_run("unix, 1 in flight",   path,             0,    1, 20000) == false) { break; }
+    if(server_bench_run("unix, 64 in flight",  path,             0,   64, 64000) == false) { break; }
+    if(server_bench_run("tcp, 1 in flight",    (const char *) 0, port, 1, 20000) == false) { break; }
+    if(server_bench_run("tcp, 64 in flight",   (const char *) 0, port, 64, 64000) == false) { break; }
+
+    /* For comparison, the cheapest process that a service could shell out
+     * to.  Running the calculator costs at least this much per equation. */
+    extern char **environ;
+    bench_timer timer;
+    int x;
+    bench_timer_start(&timer);
+    for(x = 0; x < 200; x++)
+    {
+      pid_t pid;
+      char *argv[] = { "/bin/true", (char *) 0 };
+      int   status;
+      if(posix_spawn(&pid, argv[0], (posix_spawn_file_actions_t *) 0, (posix_spawnattr_t *) 0, argv, environ) != 0) { break; }
+      waitpid(pid, &status, 0);
+    }
+    if(x != 200)                                                               { break; }
+    bench_report("spawn /bin/true", &timer, 200, "processes");
+
+    retcode = true;
+  } while(0);
+
+  if(running == true)
+  {
+    server_stop(this);
+    pthread_join(thread, (void **) 0);
+  }
+  server_delete(this);
+
+  return retcode;
+}
+
+#endif // BENCH
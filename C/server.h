@@ -0,0 +1,41 @@
+/* This is the header file for the calculator server mode.
+ */
+
+#ifndef __SERVER_H__
+#define __SERVER_H__
+
+/****************************** CLASS DEFINITION ******************************/
+
+typedef struct server server;
+
+/********************************* PUBLIC OPS *********************************/
+
+/********************************* PUBLIC API *********************************/
+
+server *server_new(const char *unix_path, int tcp_port);
+
+bool server_delete(server *this);
+
+bool server_run(server *this);
+
+bool server_stop(server *this);
+
+bool server_get_tcp_port(server *this, int *port);
+
+/********************************** TEST API **********************************/
+
+#if defined(TEST)
+
+bool server_test(void);
+
+#endif // TEST
+
+/********************************* BENCH API **********************************/
+
+#if defined(BENCH)
+
+bool server_bench(void);
+
+#endif // BENCH
+
+#endif // __SERVER_H__
@@ -9,7 +9,10 @@
 
 #include "common.h"
 
+#include "batch.h"
 #include "calculator.h"
+#include "display.h"
+#include "libcalculator.h"
 #include "list.h"
 #include "operand.h"
 #include "operand_base_10.h"
@@ -17,6 +20,7 @@
 #include "operator.h"
 #include "operator_exp.h"
 #include "raw_stdin.h"
+#include "server.h"
 #include "stack.h"
 #include "test.h"
 
@@ -61,7 +65,10 @@ bool test(void)
     test_func   func;
   } unit_test;
   unit_test tests[] = {
+    { "Batch",             batch_test           },
     { "Calculator",        calculator_test      },
+    { "Display",           display_test         },
+    { "Libcalculator",     libcalculator_test   },
     { "List",              list_test            },
     { "Operand",           operand_test         },
     { "Operand Base 10",   operand_base_10_test },
@@ -69,6 +76,7 @@ bool test(void)
     { "Operator",          operator_test        },
     { "Operator Exponent", operator_exp_test    },
     { "Raw Console",       raw_stdin_test       },
+    { "Server",            server_test          },
     { "Stack",             stack_test           },
   };
   size_t tests_size = (sizeof(tests) / sizeof(unit_test));
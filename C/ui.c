@@ -10,6 +10,8 @@
 #include "common.h"
 
 #include "calculator.h"
+#include "display.h"
+#include "operator.h"
 #include "raw_stdin.h"
 #include "ui.h"
 
@@ -19,13 +21,13 @@
 /* This is the help message.
  *
  * Input:
- *   N/A.
+ *   disp = A pointer to the display object.
  *
  * Output:
  *   N/A.
  */
 static void
-ui_display_help(void)
+ui_display_help(display *disp)
 {
   fprintf(stderr, "\n"
     "This is a simple text-based math calculator.\n"
@@ -34,6 +36,7 @@ ui_display_help(void)
     " h - Display this help message.\n"
     " q - Quit the program.\n"
     " m - Toggle Decimal and Hexadecimal mode.\n"
+    " p - Toggle processing mode.  Show the running result after each operator.\n"
     "\n"
     "The supported operators are:\n"
     " + - Addition\n"
@@ -49,19 +52,30 @@ ui_display_help(void)
     " ~ - Bitwise NOT (1's complement).  This is a UNARY operator.\n"
     "\n"
   );
+
+  /* The display has to be redrawn below the help message. */
+  display_invalidate(disp);
 }
 
-/* This function updates the calculator display.
+/* This function updates the calculator display.  Only the characters that
+ * changed since the last update are sent to the terminal.
  *
  * Input:
- *   this = A pointer to the calculator object.
+ *   disp         = A pointer to the display object.
+ *
+ *   calc         = A pointer to the calculator object.
+ *
+ *   show_running = true to display the running result of processing mode
+ *                  instead of the equation.
  *
  * Output:
  *   true  = success.  The calculator display is updated.
  *   false = failure.  The calculator display is NOT updated.
  */
 static bool
-ui_display_calc(calculator *calc)
+ui_display_calc(display    *disp,
+                calculator *calc,
+                bool        show_running)
 {
   bool retcode = false;
 
@@ -73,8 +87,13 @@ ui_display_calc(calculator *calc)
   {
     snprintf(calc_obj_buf, (calc_obj_buf_size - 1), "ERROR");
   }
+  /* In processing mode, show the running result. */
+  else if((show_running == true) && (calculator_get_running_result(calc, calc_obj_buf, calc_obj_buf_size) == false))
+  {
+    snprintf(calc_obj_buf, (calc_obj_buf_size - 1), "Error");
+  }
   /* Get the console data from the calculator object. */
-  else if(calculator_get_console(calc, calc_obj_buf, calc_obj_buf_size) == false)
+  else if((show_running == false) && (calculator_get_console(calc, calc_obj_buf, calc_obj_buf_size) == false))
   {
     snprintf(calc_obj_buf, (calc_obj_buf_size - 1), "Error");
   }
@@ -115,70 +134,131 @@ ui_display_calc(calculator *calc)
     strncpy(base_str, "???", base_str_max);
   }
 
-  /* Display our calculator output. */
+  /* Display our calculator output.  The cursor sits on the last character of
+   * the display window. */
   char calc_buf[CALC_DISPLAY_WINDOW_WIDTH + 64];
-  snprintf(calc_buf, sizeof(calc_buf), "\r-- %s -->%s<--\b\b\b\b", base_str, calc_dsp_buf);
-  fprintf(stderr, calc_buf);
-
-  retcode = true;
+  int  calc_buf_len = snprintf(calc_buf, sizeof(calc_buf), "-- %s -->%s<--", base_str, calc_dsp_buf);
+  retcode = display_update(disp, calc_buf, (calc_buf_len - 4));
 
   return retcode;
 }
 
+/* Process one character of user input.
+ *
+ * Input:
+ *   disp         = A pointer to the display object.
+ *
+ *   calc         = A pointer to the calculator object.
+ *
+ *   c            = The character.
+ *
+ *   show_running = A pointer to a variable that is set to true if the display
+ *                  should show the running result of processing mode.
+ *
+ * Output:
+ *   true  = success.  Keep going.
+ *   false = The user wants to quit.
+ */
+static bool
+ui_process_char(display    *disp,
+                calculator *calc,
+                char        c,
+                bool       *show_running)
+{
+  bool keep_going = true;
+
+  *show_running = false;
+
+  switch(c)
+  {
+  case 'h':
+    ui_display_help(disp);
+    break;
+
+  case 'm':
+    {
+      operand_type cur_base;
+      if(calculator_get_operand_type(calc, &cur_base) == true)
+      {
+        operand_type new_base;
+        switch(cur_base)
+        {
+        case operand_type_base_10: new_base = operand_type_base_16; break;
+        case operand_type_base_16: new_base = operand_type_base_10; break;
+        default:                   new_base = operand_type_base_10; break;
+        }
+        calculator_set_operand_type(calc, new_base);
+      }
+    }
+    break;
+
+  case 'p':
+    {
+      bool enabled;
+      if(calculator_get_processing_mode(calc, &enabled) == true)
+      {
+        calculator_set_processing_mode(calc, (enabled == true) ? false : true);
+      }
+    }
+    break;
+
+  case 'q':
+    keep_going = false;
+    break;
+
+  default:
+    /* In processing mode, each operator shows the running result.  The next
+     * operand shows the equation again. */
+    calculator_add_char(calc, c);
+    if(operator_is_valid_operator(c) == true)
+    {
+      calculator_get_processing_mode(calc, show_running);
+    }
+    break;
+  }
+
+  return keep_going;
+}
+
 bool ui(void)
 {
   /* Create the console and calculator objects. */
   raw_stdin *console = raw_stdin_new();
   calculator *calc = calculator_new();
-  if( (console != (raw_stdin *) 0) && (calc != (calculator *) 0) )
+  display *disp = display_new(STDERR_FILENO);
+  if( (console != (raw_stdin *) 0) && (calc != (calculator *) 0) && (disp != (display *) 0) )
   {
     fprintf(stderr, "Enter an equation.  'h' for help.\n");
-    ui_display_calc(calc);
+    ui_display_calc(disp, calc, false);
 
-    bool keep_going = true;
+    bool keep_going   = true;
+    bool show_running = false;
     while(keep_going == true)
     {
-      /* Get the next character from the user. */
+      /* Wait for the next character from the user.  Then process the rest of
+       * the burst (i.e. a paste) before we update the display.  Frames are
+       * only drawn when there's no more input waiting, so a big paste (or
+       * fast typing over a slow link) is drawn once instead of once per
+       * character. */
       char c;
+      show_running = false;
       if((keep_going = raw_stdin_getchar(console, &c)) == true)
       {
-        switch(c)
+        do
         {
-        case 'h':
-          ui_display_help();
-          break;
-
-        case 'm':
-          {
-            operand_type cur_base;
-            if(calculator_get_operand_type(calc, &cur_base) == true)
-            {
-              operand_type new_base;
-              switch(cur_base)
-              {
-              case operand_type_base_10: new_base = operand_type_base_16; break;
-              case operand_type_base_16: new_base = operand_type_base_10; break;
-              default:                   new_base = operand_type_base_10; break;
-              }
-              calculator_set_operand_type(calc, new_base);
-            }
-          }
-          break;
-
-        case 'q':
-          keep_going = false;
-          break;
-
-        default:
-          calculator_add_char(calc, c);
-          break;
-        }
+          keep_going = ui_process_char(disp, calc, c, &show_running);
+        } while((keep_going == true) && (raw_stdin_getchar_nowait(console, &c) == true));
       }
 
-      ui_display_calc(calc);
+      ui_display_calc(disp, calc, show_running);
     }
   }
 
+  if(disp != (display *) 0)
+  {
+    display_delete(disp);
+  }
+
   if(calc != (calculator *) 0)
   {
     calculator_delete(calc);
@@ -192,4 +272,3 @@ bool ui(void)
 
   return 0;
 }
-